@@ -0,0 +1,148 @@
+#include "Clock.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__)
+#include <time.h>
+#endif
+
+namespace Helpers
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+struct WallClockSample
+{
+    int64_t steadyNanos;
+    int64_t unixNanos;
+};
+
+WallClockSample SampleWallClock();
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+Clock::State::State()
+    : sequence(0),
+      slewPpb(0),
+      isCorrecting(false),
+      numCorrections(0),
+      numIgnoredSteps(0),
+      lastErrorMicros(0),
+      maxAbsErrorMicros(0)
+{
+    const WallClockSample anchor = SampleWallClock();
+    steadyBase.store(anchor.steadyNanos);
+    unixBase.store(anchor.unixNanos);
+    nextCorrection.store(anchor.steadyNanos + CORRECTION_INTERVAL.count());
+}
+
+Clock::Stats Clock::GetStats()
+{
+    const State& state = GetState();
+    return Stats{.numCorrections = state.numCorrections.load(std::memory_order_relaxed),
+                 .numIgnoredSteps = state.numIgnoredSteps.load(std::memory_order_relaxed),
+                 .lastErrorMicros = state.lastErrorMicros.load(std::memory_order_relaxed),
+                 .maxAbsErrorMicros = state.maxAbsErrorMicros.load(std::memory_order_relaxed)};
+}
+
+std::chrono::nanoseconds Clock::GetThreadCpuTime()
+{
+#if defined(_WIN32)
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user))
+        return std::chrono::nanoseconds(0);
+    const uint64_t kernel100ns =
+        (static_cast<uint64_t>(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+    const uint64_t user100ns =
+        (static_cast<uint64_t>(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+    return std::chrono::nanoseconds((kernel100ns + user100ns) * 100);
+#elif defined(__linux__)
+    timespec time{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+    return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+#else
+    return std::chrono::nanoseconds(0);
+#endif
+}
+
+void Clock::Correct(State& state)
+{
+    // whoever gets here first does the correction, everyone else keeps using the old segment
+    if (state.isCorrecting.exchange(true, std::memory_order_acquire))
+        return;
+
+    const WallClockSample sample = SampleWallClock();
+    const Segment current = LoadSegment(state);
+    const int64_t ours = Evaluate(current, sample.steadyNanos);
+    const int64_t error = sample.unixNanos - ours;
+
+    int64_t slewPpb = 0;
+    if (std::llabs(error) > MAX_SLEW_ERROR.count())
+    {
+        state.numIgnoredSteps.fetch_add(1, std::memory_order_relaxed);
+    }
+    else
+    {
+        // spread the error over the next interval, as fast as MAX_SLEW_PPM allows
+        constexpr int64_t MAX_SLEW_PPB = MAX_SLEW_PPM * 1000;
+        slewPpb = error * 1'000'000'000 / CORRECTION_INTERVAL.count();
+        slewPpb = std::clamp(slewPpb, -MAX_SLEW_PPB, MAX_SLEW_PPB);
+
+        const int64_t absErrorMicros = std::llabs(error) / 1000;
+        if (absErrorMicros > state.maxAbsErrorMicros.load(std::memory_order_relaxed))
+            state.maxAbsErrorMicros.store(absErrorMicros, std::memory_order_relaxed);
+    }
+    state.lastErrorMicros.store(error / 1000, std::memory_order_relaxed);
+    state.numCorrections.fetch_add(1, std::memory_order_relaxed);
+
+    const uint32_t sequence = state.sequence.load(std::memory_order_relaxed);
+    state.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    state.steadyBase.store(sample.steadyNanos, std::memory_order_relaxed);
+    state.unixBase.store(ours, std::memory_order_relaxed);
+    state.slewPpb.store(slewPpb, std::memory_order_relaxed);
+    state.sequence.store(sequence + 2, std::memory_order_release);
+
+    state.nextCorrection.store(sample.steadyNanos + CORRECTION_INTERVAL.count(),
+                               std::memory_order_relaxed);
+    state.isCorrecting.store(false, std::memory_order_release);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+
+/// @brief Reads the wall clock between two steady clock reads and pairs it with their midpoint.
+///        Of a few tries, keeps the one with the tightest bracket, i.e. the one least likely
+///        to have been preempted halfway through.
+WallClockSample SampleWallClock()
+{
+    using namespace std::chrono;
+    constexpr int NUM_TRIES = 5;
+
+    WallClockSample best{};
+    int64_t bestWidth = INT64_MAX;
+    for (int i = 0; i < NUM_TRIES; i++)
+    {
+        const auto before = steady_clock::now();
+        const auto wall = system_clock::now();
+        const auto after = steady_clock::now();
+
+        const int64_t width = duration_cast<nanoseconds>(after - before).count();
+        if (width < bestWidth)
+        {
+            bestWidth = width;
+            best.steadyNanos =
+                duration_cast<nanoseconds>(before.time_since_epoch()).count() + width / 2;
+            best.unixNanos = duration_cast<nanoseconds>(wall.time_since_epoch()).count();
+        }
+    }
+    return best;
+}
+
+}  // namespace Helpers
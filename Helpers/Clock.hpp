@@ -0,0 +1,136 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace Helpers
+{
+
+/// @brief Process-wide source of Unix timestamps for everything the study logs.
+///        The wall clock is read once, the first time a timestamp is taken, and anchored to
+///        std::chrono::steady_clock. From then on a timestamp is a steady clock read plus an
+///        offset: it has sub-microsecond resolution, never jumps when the system clock is set,
+///        and costs about as much as steady_clock::now() (a vDSO call on Linux,
+///        QueryPerformanceCounter on Windows).
+///
+///        So that a long session does not drift away from the wall clock (the steady clock is
+///        not NTP disciplined everywhere), the first timestamp taken after each
+///        CORRECTION_INTERVAL compares the two clocks again and slews the offset toward the
+///        wall clock over the next interval, by at most MAX_SLEW_PPM. Timestamps stay
+///        monotonic. Differences larger than MAX_SLEW_ERROR (someone set the clock, or the
+///        machine slept) are not followed, only counted.
+class Clock
+{
+   public:
+    using SteadyClock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::nanoseconds CORRECTION_INTERVAL = std::chrono::seconds(1);
+    static constexpr int64_t MAX_SLEW_PPM = 500;
+    static constexpr std::chrono::nanoseconds MAX_SLEW_ERROR = std::chrono::seconds(1);
+
+    struct Stats
+    {
+        uint64_t numCorrections;
+        uint64_t numIgnoredSteps;      // wall clock jumps larger than MAX_SLEW_ERROR
+        int64_t lastErrorMicros;       // wall clock minus our timestamps, at the last correction
+        int64_t maxAbsErrorMicros;     // largest |error| that was slewed away
+    };
+
+    static uint64_t NowUnixMicros() { return ToUnixMicros(SteadyClock::now()); }
+    static uint64_t NowUnixMillis() { return NowUnixMicros() / 1000; }
+
+    /// @brief Converts a time point taken for scheduling into a Unix timestamp,
+    ///        so a loop that already read the clock doesn't have to read it again.
+    static uint64_t ToUnixMicros(SteadyClock::time_point time);
+    static uint64_t ToUnixMillis(SteadyClock::time_point time) { return ToUnixMicros(time) / 1000; }
+
+    static Stats GetStats();
+
+    /// @brief CPU time the calling thread has used so far, for working out how busy a loop is.
+    static std::chrono::nanoseconds GetThreadCpuTime();
+
+   private:
+    /// @brief One piece of the piecewise linear map from steady clock to Unix time:
+    ///        unix = unixBase + elapsed + min(elapsed, CORRECTION_INTERVAL) * slew
+    ///        Each correction starts a new segment where the previous one ends,
+    ///        which is what keeps timestamps continuous.
+    struct Segment
+    {
+        int64_t steadyBase;
+        int64_t unixBase;
+        int64_t slewPpb;
+    };
+
+    /// @brief The current segment, published through a sequence lock so readers never block.
+    ///        There is only ever one writer, the thread that won isCorrecting.
+    struct State
+    {
+        State();
+
+        std::atomic<uint32_t> sequence;
+        std::atomic<int64_t> steadyBase;
+        std::atomic<int64_t> unixBase;
+        std::atomic<int64_t> slewPpb;
+        std::atomic<int64_t> nextCorrection;
+        std::atomic<bool> isCorrecting;
+
+        std::atomic<uint64_t> numCorrections;
+        std::atomic<uint64_t> numIgnoredSteps;
+        std::atomic<int64_t> lastErrorMicros;
+        std::atomic<int64_t> maxAbsErrorMicros;
+    };
+
+    static State& GetState()
+    {
+        static State state;
+        return state;
+    }
+
+    static int64_t ToNanos(SteadyClock::time_point time)
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch())
+            .count();
+    }
+
+    static Segment LoadSegment(const State& state);
+    static int64_t Evaluate(const Segment& segment, int64_t steadyNanos);
+    static void Correct(State& state);
+};
+
+inline uint64_t Clock::ToUnixMicros(SteadyClock::time_point time)
+{
+    State& state = GetState();
+    const int64_t steadyNanos = ToNanos(time);
+    if (steadyNanos >= state.nextCorrection.load(std::memory_order_relaxed))
+        Correct(state);
+
+    return static_cast<uint64_t>(Evaluate(LoadSegment(state), steadyNanos) / 1000);
+}
+
+inline Clock::Segment Clock::LoadSegment(const State& state)
+{
+    Segment segment;
+    uint32_t before, after;
+    do
+    {
+        before = state.sequence.load(std::memory_order_acquire);
+        segment.steadyBase = state.steadyBase.load(std::memory_order_relaxed);
+        segment.unixBase = state.unixBase.load(std::memory_order_relaxed);
+        segment.slewPpb = state.slewPpb.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        after = state.sequence.load(std::memory_order_relaxed);
+    } while ((before & 1) != 0 || before != after);
+    return segment;
+}
+
+inline int64_t Clock::Evaluate(const Segment& segment, int64_t steadyNanos)
+{
+    const int64_t elapsed = steadyNanos - segment.steadyBase;
+    int64_t slewed = elapsed < CORRECTION_INTERVAL.count() ? elapsed : CORRECTION_INTERVAL.count();
+    if (slewed < 0)
+        slewed = 0;
+    return segment.unixBase + elapsed + slewed * segment.slewPpb / 1'000'000'000;
+}
+
+}  // namespace Helpers
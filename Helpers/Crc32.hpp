@@ -0,0 +1,35 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+namespace Helpers
+{
+
+/// @brief Lookup table for the reflected CRC-32 polynomial 0xEDB88320 (zlib, PNG, ...).
+constexpr std::array<uint32_t, 256> CRC32_TABLE = []
+{
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        table[i] = crc;
+    }
+    return table;
+}();
+
+/// @brief CRC-32 of data. Pass the previous result as crc to checksum data in pieces.
+constexpr uint32_t Crc32(std::string_view data, uint32_t crc = 0)
+{
+    crc = ~crc;
+    for (char c : data)
+        crc = CRC32_TABLE[(crc ^ static_cast<uint8_t>(c)) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+static_assert(Crc32("123456789") == 0xCBF43926u, "CRC-32 check value");
+
+}  // namespace Helpers
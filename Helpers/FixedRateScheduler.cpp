@@ -0,0 +1,129 @@
+#include "FixedRateScheduler.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <thread>
+
+#if defined(_WIN32)
+#include <Windows.h>
+#elif defined(__linux__)
+#include <time.h>
+#endif
+
+namespace Helpers
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+void SleepUntil(FixedRateScheduler::TimePoint deadline);
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+FixedRateScheduler::FixedRateScheduler(uint32_t rateHz)
+    : m_rateHz(std::max<uint32_t>(rateHz, 1)), m_nextTick(0), m_stats{}
+{
+    Restart();
+}
+
+void FixedRateScheduler::Restart()
+{
+    m_start = Clock::SteadyClock::now();
+    m_nextTick = 0;
+}
+
+FixedRateScheduler::TimePoint FixedRateScheduler::WaitForNextTick()
+{
+    using namespace std::chrono;
+
+    // the most recent deadline that has already passed
+    const auto elapsed = duration_cast<nanoseconds>(Clock::SteadyClock::now() - m_start).count();
+    const uint64_t dueTick =
+        elapsed > 0 ? static_cast<uint64_t>(elapsed) * m_rateHz / 1'000'000'000 : 0;
+    if (dueTick > m_nextTick)
+    {
+        // the loop overran whole periods: run the latest of them once, skip the rest
+        m_stats.numMissedTicks += dueTick - m_nextTick;
+        m_nextTick = dueTick;
+    }
+
+    const TimePoint deadline = GetDeadline(m_nextTick);
+    SleepUntil(deadline);
+    TimePoint wakeup = Clock::SteadyClock::now();
+    while (wakeup < deadline)  // timers are allowed to fire a little early on some platforms
+    {
+        SleepUntil(deadline);
+        wakeup = Clock::SteadyClock::now();
+    }
+
+    const int64_t jitter = duration_cast<nanoseconds>(wakeup - deadline).count();
+    m_stats.numTicks++;
+    m_stats.totalJitterNanos += jitter;
+    m_stats.maxJitterNanos = std::max(m_stats.maxJitterNanos, jitter);
+    if (jitter > 250'000'000 / static_cast<int64_t>(m_rateHz))
+        m_stats.numLateTicks++;
+
+    m_nextTick++;
+    return wakeup;
+}
+
+FixedRateScheduler::TimePoint FixedRateScheduler::GetDeadline(uint64_t tick) const
+{
+    return m_start + std::chrono::nanoseconds(tick * 1'000'000'000 / m_rateHz);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+void SleepUntil(FixedRateScheduler::TimePoint deadline)
+{
+#if defined(__linux__)
+    // libstdc++ and libc++ both implement steady_clock with CLOCK_MONOTONIC
+    const auto sinceEpoch =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+    timespec wakeup{};
+    wakeup.tv_sec = static_cast<time_t>(sinceEpoch / 1'000'000'000);
+    wakeup.tv_nsec = static_cast<long>(sinceEpoch % 1'000'000'000);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wakeup, nullptr) == EINTR)
+        ;
+#elif defined(_WIN32)
+    // The default timer resolution on Windows is 15.6ms, far too coarse for 1kHz.
+    // High-resolution waitable timers (Windows 10 1803+) don't need timeBeginPeriod for that.
+    // Their absolute due times follow the wall clock, so the wait is made relative here and
+    // WaitForNextTick re-checks the deadline against the steady clock.
+    struct WaitableTimer
+    {
+        HANDLE handle = CreateWaitableTimerExW(nullptr, nullptr,
+                                               CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                               TIMER_ALL_ACCESS);
+        ~WaitableTimer()
+        {
+            if (handle)
+                CloseHandle(handle);
+        }
+    };
+    thread_local WaitableTimer timer;
+
+    const auto remaining = deadline - Clock::SteadyClock::now();
+    if (remaining <= remaining.zero())
+        return;
+
+    LARGE_INTEGER dueTime;
+    dueTime.QuadPart =
+        -std::chrono::duration_cast<std::chrono::duration<int64_t, std::ratio<1, 10'000'000>>>(
+             remaining)
+             .count();
+    if (timer.handle && dueTime.QuadPart < 0 &&
+        SetWaitableTimer(timer.handle, &dueTime, 0, nullptr, nullptr, FALSE))
+    {
+        WaitForSingleObject(timer.handle, INFINITE);
+        return;
+    }
+    std::this_thread::sleep_until(deadline);
+#else
+    std::this_thread::sleep_until(deadline);
+#endif
+}
+
+}  // namespace Helpers
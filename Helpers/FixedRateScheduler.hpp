@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "Clock.hpp"
+
+namespace Helpers
+{
+
+/// @brief Paces a loop at a fixed rate.
+///        Deadline n is start + n / rate, computed from the start of the schedule rather than
+///        from the previous wakeup, so lateness in one iteration never shifts the ones after it.
+///        The wait itself is an absolute sleep (clock_nanosleep with TIMER_ABSTIME on Linux,
+///        a high-resolution waitable timer on Windows), which is good enough for 1kHz.
+///        A loop that overruns whole periods skips the deadlines it missed instead of running
+///        them back to back.
+class FixedRateScheduler
+{
+   public:
+    using TimePoint = Clock::SteadyClock::time_point;
+
+    /// @brief Lateness of every wakeup relative to its deadline.
+    struct Stats
+    {
+        uint64_t numTicks;
+        uint64_t numMissedTicks;  // deadlines skipped because the loop overran them
+        uint64_t numLateTicks;    // woke more than a quarter period after the deadline
+        int64_t totalJitterNanos;
+        int64_t maxJitterNanos;
+    };
+
+    explicit FixedRateScheduler(uint32_t rateHz);
+
+    /// @brief Starts a new schedule whose first deadline is now. Stats are kept.
+    void Restart();
+
+    /// @brief Sleeps until the next deadline.
+    /// @return When the caller was woken up, which is never before the deadline.
+    TimePoint WaitForNextTick();
+
+    uint32_t GetRateHz() const { return m_rateHz; }
+    const Stats& GetStats() const { return m_stats; }
+
+   private:
+    const uint32_t m_rateHz;
+    TimePoint m_start;
+    uint64_t m_nextTick;
+    Stats m_stats;
+
+    TimePoint GetDeadline(uint64_t tick) const;
+};
+
+}  // namespace Helpers
@@ -2,11 +2,16 @@
 
 #include <rapidjson/document.h>
 #include <rapidjson/rapidjson.h>
+#include <rapidjson/reader.h>
 #include <rapidjson/schema.h>
 
 #include <Helpers/Expected.hpp>
 #include <Programs/UserStudy/Logging.hpp>
+#include <array>
+#include <concepts>
+#include <memory>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 namespace Helpers
@@ -33,6 +38,14 @@ enum class ParseError
 template <typename T>
 concept RequestData = std::derived_from<T, RequestData_t>;
 
+/// @brief A request that carries logging events, either one event or an array of them.
+///        Its schema and deserializer are generated from the event's Logging::EventSchema.
+template <typename T>
+concept EventRequest = RequestData<T> && Logging::Loggable<typename T::Event>;
+
+template <EventRequest T>
+constexpr bool IS_BATCH_REQUEST = std::same_as<decltype(T::data), std::vector<typename T::Event>>;
+
 // Function declarations
 template <RequestData T>
 Expected<T, ParseError> ParseRequest(std::string jsonRequest);
@@ -45,22 +58,26 @@ struct Start : public RequestData_t
 
 struct EventFieldCompletion : public RequestData_t
 {
-    Logging::Events::FieldCompletion data;
+    using Event = Logging::Events::FieldCompletion;
+    Event data;
 };
 
 struct EventTaskCompletion : public RequestData_t
 {
-    Logging::Events::TaskCompletion data;
+    using Event = Logging::Events::TaskCompletion;
+    Event data;
 };
 
 struct EventClick : public RequestData_t
 {
-    std::vector<Logging::Events::Click> data;
+    using Event = Logging::Events::Click;
+    std::vector<Event> data;
 };
 
 struct EventKeystroke : public RequestData_t
 {
-    std::vector<Logging::Events::Keystroke> data;
+    using Event = Logging::Events::Keystroke;
+    std::vector<Event> data;
 };
 
 template <RequestData T>
@@ -76,161 +93,370 @@ template <RequestData T>
 consteval std::string_view GetRequestSchema();
 
 template <RequestData T>
-Expected<T, ParseError> ParseRequest(std::string jsonRequest)
+const rapidjson::SchemaDocument* GetSchemaDocument();
+
+template <typename Type, typename V>
+bool AssignJsonValue(Type& member, const V& value);
+
+///////////////////////////////////////////////////////////////////////////////
+// Schemas generated from the event schema
+///////////////////////////////////////////////////////////////////////////////
+
+/// @brief Writes a JSON schema into a buffer, or only measures it if there is no buffer,
+///        so the schema can be built at compile time in two passes.
+class SchemaWriter
 {
-    constexpr std::string_view schemaString = GetRequestSchema<T>();
-    rapidjson::Document rawSchemaDocument;
-    rawSchemaDocument.Parse(schemaString.data(), schemaString.size());
-    if (rawSchemaDocument.HasParseError())
-        return Expected<T, ParseError>(ParseError::SchemaNotValidJSON);
+   public:
+    constexpr SchemaWriter(char* out = nullptr) : out(out), size(0) {}
 
-    rapidjson::Document requestDocument;
-    requestDocument.Parse(jsonRequest.data(), jsonRequest.size());
-    if (requestDocument.HasParseError())
-        return Expected<T, ParseError>(ParseError::RequestNotValidJSON);
+    constexpr void Append(std::string_view text)
+    {
+        if (out)
+            std::copy(text.begin(), text.end(), out + size);
+        size += text.size();
+    }
 
-    rapidjson::SchemaDocument schema(rawSchemaDocument);
-    rapidjson::SchemaValidator validator(schema);
-    if (!requestDocument.Accept(validator))
-        return Expected<T, ParseError>(ParseError::RequestDoesNotFollowSchema);
+    constexpr size_t Size() const { return size; }
 
-    // TODO: maybe don't require an rvalue reference in the constructor
-    return Expected<T, ParseError>(DeserializeRequest<T>(requestDocument));
-}
+   private:
+    char* out;
+    size_t size;
+};
 
-template <>
-consteval std::string_view GetRequestSchema<Start>()
-{
-    return R"(
+template <typename Type>
+consteval std::string_view JsonTypeName()
 {
-    "title": "Request_Start",
-    "type": "object",
-    "properties": {
-        "userId": {
-            "type": "integer",
-            "description": "The user ID to initialize a user study with."
-        }
-    },
-    "required": ["userId"],
-    "unevaluatedProperties": false
-}
-    )";
+    if constexpr (std::is_same_v<Type, bool>)
+        return "boolean";
+    else if constexpr (std::is_same_v<Type, std::string> || std::is_enum_v<Type>)
+        return "string";
+    else
+        return "integer";
 }
 
-template <>
-consteval std::string_view GetRequestSchema<EventFieldCompletion>()
-{
-    return R"(
+/// @brief Writes the members of the schema of one event object, without the braces around them.
+template <Logging::Loggable Event>
+constexpr void WriteEventSchema(SchemaWriter& writer)
 {
-    "title": "Request_Events_Field",
-    "type": "object",
-    "properties": {
-        "timestampMillis": {
-            "type": "integer",
-            "description": "The Unix time (in milliseconds) at which the event occurred."
-        },
-        "fieldIndex": {
-            "type": "integer",
-            "description": "The index of the field that was completed."
-        }
-    },
-    "requried": ["timestampMillis", "fieldIndex"],
-    "unevaluatedProperties": false
+    writer.Append(R"("type": "object", "properties": {)");
+    bool isFirst = true;
+    Logging::ForEachField<Event>(
+        [&](const auto& field)
+        {
+            using Type = typename Logging::FieldOf<decltype(field)>::Type;
+            writer.Append(isFirst ? "\"" : ", \"");
+            writer.Append(field.name);
+            writer.Append(R"(": {"type": ")");
+            writer.Append(JsonTypeName<Type>());
+            writer.Append("\"");
+            if constexpr (std::is_enum_v<Type>)
+            {
+                writer.Append(R"(, "enum": [)");
+                for (size_t i = 0; i < Logging::EnumSchema<Type>::VALUES.size(); i++)
+                {
+                    writer.Append(i == 0 ? "\"" : ", \"");
+                    writer.Append(Logging::EnumSchema<Type>::VALUES[i]);
+                    writer.Append("\"");
+                }
+                writer.Append("]");
+            }
+            writer.Append(R"(, "description": ")");
+            writer.Append(field.description);
+            writer.Append("\"}");
+            isFirst = false;
+        });
+
+    writer.Append(R"(}, "required": [)");
+    isFirst = true;
+    Logging::ForEachField<Event>(
+        [&](const auto& field)
+        {
+            writer.Append(isFirst ? "\"" : ", \"");
+            writer.Append(field.name);
+            writer.Append("\"");
+            isFirst = false;
+        });
+    writer.Append(R"(], "additionalProperties": false)");
 }
-    )";
+
+template <EventRequest T>
+constexpr void WriteRequestSchema(SchemaWriter& writer)
+{
+    writer.Append(R"({"title": "Request_Events_)");
+    writer.Append(Logging::EventSchema<typename T::Event>::NAME);
+    writer.Append("\", ");
+    if constexpr (IS_BATCH_REQUEST<T>)
+    {
+        writer.Append(R"("type": "array", "items": {)");
+        WriteEventSchema<typename T::Event>(writer);
+        writer.Append("}");
+    }
+    else
+    {
+        WriteEventSchema<typename T::Event>(writer);
+    }
+    writer.Append("}");
 }
 
-template <>
-consteval std::string_view GetRequestSchema<EventTaskCompletion>()
+/// @brief The schema of an event request, assembled at compile time.
+template <EventRequest T>
+struct GeneratedSchema
 {
-    return R"(
+    static constexpr size_t SIZE = []
+    {
+        SchemaWriter writer;
+        WriteRequestSchema<T>(writer);
+        return writer.Size();
+    }();
+    static constexpr std::array<char, SIZE> CHARS = []
+    {
+        std::array<char, SIZE> chars{};
+        SchemaWriter writer(chars.data());
+        WriteRequestSchema<T>(writer);
+        return chars;
+    }();
+    static constexpr std::string_view VIEW{CHARS.data(), CHARS.size()};
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// SAX deserializers generated from the event schema
+///////////////////////////////////////////////////////////////////////////////
+
+/// @brief Fills in events straight from the parser's callbacks, without building a DOM.
+///        Runs behind a schema validator, so it only has to reject what the schema can't
+///        (returning false from any callback ends the parse).
+template <Logging::Loggable Event>
+class EventHandler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, EventHandler<Event>>
 {
-    "title": "Request_Events_Task",
-    "type": "object",
-    "properties": {
-        "timestampMillis": {
-            "type": "integer",
-            "description": "The Unix time (in milliseconds) at which the event occurred."
-        },
-        "taskIndex": {
-            "type": "integer",
-            "description": "The index of the task that was completed."
-        }
-    },
-    "requried": ["timestampMillis", "taskIndex"],
-    "unevaluatedProperties": false
-}
-    )";
+   public:
+    EventHandler(std::vector<Event>& events, bool isBatch)
+        : events(events), isBatch(isBatch), isInArray(false), isInEvent(false), currentField(0)
+    {
+    }
+
+    bool Default() { return false; }
+
+    // a batch is an array of event objects, anything else is a single event object
+    bool StartArray()
+    {
+        if (!isBatch || isInArray || !events.empty())
+            return false;
+        isInArray = true;
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType)
+    {
+        isInArray = false;
+        return true;
+    }
+
+    bool StartObject()
+    {
+        if (isInEvent || isInArray != isBatch || (!isBatch && !events.empty()))
+            return false;
+        isInEvent = true;
+        events.emplace_back();
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType)
+    {
+        isInEvent = false;
+        return true;
+    }
+
+    bool Key(const char* name, rapidjson::SizeType length, bool)
+    {
+        const std::string_view key(name, length);
+        size_t index = 0;
+        currentField = Logging::NUM_FIELDS<Event>;
+        Logging::ForEachField<Event>(
+            [&](const auto& field)
+            {
+                if (field.name == key)
+                    currentField = index;
+                index++;
+            });
+        return isInEvent && currentField < Logging::NUM_FIELDS<Event>;
+    }
+
+    bool Bool(bool value) { return SetField(value); }
+    bool Int(int value) { return SetField(static_cast<int64_t>(value)); }
+    bool Uint(unsigned value) { return SetField(static_cast<uint64_t>(value)); }
+    bool Int64(int64_t value) { return SetField(value); }
+    bool Uint64(uint64_t value) { return SetField(value); }
+
+    bool String(const char* value, rapidjson::SizeType length, bool)
+    {
+        return SetField(std::string_view(value, length));
+    }
+
+   private:
+    std::vector<Event>& events;
+    const bool isBatch;
+    bool isInArray;
+    bool isInEvent;
+    size_t currentField;
+
+    template <typename V>
+    bool SetField(const V& value)
+    {
+        if (!isInEvent)
+            return false;
+
+        bool isSet = false;
+        size_t index = 0;
+        Logging::ForEachField<Event>(
+            [&](const auto& field)
+            {
+                using F = Logging::FieldOf<decltype(field)>;
+                if (index++ == currentField)
+                    isSet = AssignJsonValue(events.back().*F::MEMBER, value);
+            });
+        return isSet;
+    }
+};
+
+/// @brief Stores a JSON value into an event member.
+/// @return false if the value does not fit the member.
+template <typename Type, typename V>
+bool AssignJsonValue(Type& member, const V& value)
+{
+    if constexpr (std::is_same_v<Type, bool> && std::is_same_v<V, bool>)
+    {
+        member = value;
+        return true;
+    }
+    else if constexpr (std::is_same_v<Type, std::string> && std::is_same_v<V, std::string_view>)
+    {
+        member = value;
+        return true;
+    }
+    else if constexpr (std::is_enum_v<Type> && std::is_same_v<V, std::string_view>)
+    {
+        return Logging::EnumFromString(value, member);
+    }
+    else if constexpr (std::is_integral_v<Type> && !std::is_same_v<Type, bool> &&
+                       std::is_integral_v<V> && !std::is_same_v<V, bool>)
+    {
+        if (!std::in_range<Type>(value))
+            return false;
+        member = static_cast<Type>(value);
+        return true;
+    }
+    else
+    {
+        return false;
+    }
 }
 
-template <>
-consteval std::string_view GetRequestSchema<EventClick>()
+template <EventRequest T>
+Expected<T, ParseError> ParseEventRequest(const std::string& jsonRequest,
+                                          const rapidjson::SchemaDocument& schema)
 {
-    return R"(
+    using Event = typename T::Event;
+
+    std::vector<Event> events;
+    EventHandler<Event> handler(events, IS_BATCH_REQUEST<T>);
+    rapidjson::GenericSchemaValidator<rapidjson::SchemaDocument, EventHandler<Event>> validator(
+        schema, handler);
+    rapidjson::Reader reader;
+    rapidjson::StringStream stream(jsonRequest.c_str());
+    const bool isParsed = !reader.Parse(stream, validator).IsError();
+
+    // a rejection from the schema or the handler also stops the parse, so check that first
+    if (!validator.IsValid())
+        return Expected<T, ParseError>(ParseError::RequestDoesNotFollowSchema);
+    if (!isParsed)
+        return Expected<T, ParseError>(ParseError::RequestNotValidJSON);
+
+    T request;
+    if constexpr (IS_BATCH_REQUEST<T>)
+    {
+        request.data = std::move(events);
+    }
+    else
+    {
+        if (events.size() != 1)
+            return Expected<T, ParseError>(ParseError::RequestDoesNotFollowSchema);
+        request.data = std::move(events.front());
+    }
+    return Expected<T, ParseError>(std::move(request));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Request parsing
+///////////////////////////////////////////////////////////////////////////////
+template <RequestData T>
+Expected<T, ParseError> ParseRequest(std::string jsonRequest)
 {
-    "title": "Request_Events_Click",
-    "type": "array",
-    "items": {
-        "$ref": "#/$defs/click"
-    },
-    "$defs": {
-        "click": {
-            "type": "object",
-            "properties": {
-                "timestampMillis": {
-                    "type": "integer",
-                    "description": "The Unix time (in milliseconds) at which the event occurred."
-                },
-                "location": {
-                    "type": "string",
-                    "description": "The location on the page that the click was heard at."
-                },
-                "wasCorrect": {
-                    "type": "boolean",
-                    "description": "Did the click hit the part of the page it was supposed to at this time?"
-                }
-            },
-            "required": ["timestampMillis", "location", "wasCorrect"],
-            "unevaluatedProperties": false
-        }
+    const rapidjson::SchemaDocument* schema = GetSchemaDocument<T>();
+    if (!schema)
+        return Expected<T, ParseError>(ParseError::SchemaNotValidJSON);
+
+    if constexpr (EventRequest<T>)
+    {
+        return ParseEventRequest<T>(jsonRequest, *schema);
+    }
+    else
+    {
+        rapidjson::Document requestDocument;
+        requestDocument.Parse(jsonRequest.data(), jsonRequest.size());
+        if (requestDocument.HasParseError())
+            return Expected<T, ParseError>(ParseError::RequestNotValidJSON);
+
+        rapidjson::SchemaValidator validator(*schema);
+        if (!requestDocument.Accept(validator))
+            return Expected<T, ParseError>(ParseError::RequestDoesNotFollowSchema);
+
+        // TODO: maybe don't require an rvalue reference in the constructor
+        return Expected<T, ParseError>(DeserializeRequest<T>(requestDocument));
     }
 }
-    )";
+
+/// @brief Schemas are only parsed once per request type, the first time one comes in.
+/// @return nullptr if the schema string is not valid JSON.
+template <RequestData T>
+const rapidjson::SchemaDocument* GetSchemaDocument()
+{
+    static const std::unique_ptr<rapidjson::SchemaDocument> schema =
+        []() -> std::unique_ptr<rapidjson::SchemaDocument>
+    {
+        constexpr std::string_view schemaString = GetRequestSchema<T>();
+        rapidjson::Document rawSchemaDocument;
+        rawSchemaDocument.Parse(schemaString.data(), schemaString.size());
+        if (rawSchemaDocument.HasParseError())
+            return nullptr;
+        return std::make_unique<rapidjson::SchemaDocument>(rawSchemaDocument);
+    }();
+    return schema.get();
+}
+
+template <RequestData T>
+consteval std::string_view GetRequestSchema()
+{
+    static_assert(EventRequest<T>, "requests that are not events need a hand-written schema");
+    return GeneratedSchema<T>::VIEW;
 }
 
 template <>
-consteval std::string_view GetRequestSchema<EventKeystroke>()
+consteval std::string_view GetRequestSchema<Start>()
 {
     return R"(
 {
-    "title": "Request_Events_Keystroke",
-    "type": "array",
-    "items": {
-        "$ref": "#/$defs/keystroke"
-    },
-    "$defs": {
-        "keystroke": {
-            "type": "object",
-            "properties": {
-                "timestampMillis": {
-                    "type": "integer",
-                    "description": "The Unix time (in milliseconds) at which the event occurred."
-                },
-                "keycode": {
-                    "type": "string",
-                    "description": "The key that was pressed."
-                },
-                "wasCorrect": {
-                    "type": "boolean",
-                    "description": "Was this character valid input?"
-                }
-            },
-            "required": ["timestampMillis", "keycode", "wasCorrect"],
-            "unevaluatedProperties": false
+    "title": "Request_Start",
+    "type": "object",
+    "properties": {
+        "userId": {
+            "type": "integer",
+            "description": "The user ID to initialize a user study with."
         }
-    }
+    },
+    "required": ["userId"],
+    "unevaluatedProperties": false
 }
     )";
 }
 
-}  // namespace Helpers
\ No newline at end of file
+}  // namespace Helpers
@@ -0,0 +1,60 @@
+#include "LatencyHistogram.hpp"
+
+#include <cmath>
+
+namespace Helpers
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+LatencyHistogram::LatencyHistogram() : m_counts{}, m_totalNanos(0), m_maxNanos(0) {}
+
+LatencyHistogram::Snapshot LatencyHistogram::GetSnapshot() const
+{
+    Snapshot snapshot{};
+    for (size_t i = 0; i < NUM_BUCKETS; i++)
+    {
+        snapshot.counts[i] = m_counts[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.counts[i];
+    }
+    snapshot.totalNanos = m_totalNanos.load(std::memory_order_relaxed);
+    snapshot.maxNanos = m_maxNanos.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+uint64_t LatencyHistogram::GetBucketEnd(size_t bucket)
+{
+    if (bucket < NUM_SUB_BUCKETS)
+        return bucket;
+
+    const uint64_t shift = bucket / NUM_SUB_BUCKETS - 1;
+    const uint64_t start = (NUM_SUB_BUCKETS + bucket % NUM_SUB_BUCKETS) << shift;
+    return start + (uint64_t{1} << shift) - 1;
+}
+
+double LatencyHistogram::Snapshot::GetMeanNanos() const
+{
+    return count > 0 ? static_cast<double>(totalNanos) / static_cast<double>(count) : 0.0;
+}
+
+uint64_t LatencyHistogram::Snapshot::GetPercentileNanos(double percent) const
+{
+    if (count == 0)
+        return 0;
+
+    // the rank of the value wanted, counting from 1
+    const double clamped = std::clamp(percent, 0.0, 100.0);
+    const uint64_t rank =
+        std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(clamped / 100.0 * count)));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < NUM_BUCKETS; i++)
+    {
+        seen += counts[i];
+        if (seen >= rank)
+            return std::min(GetBucketEnd(i), maxNanos);
+    }
+    return maxNanos;
+}
+
+}  // namespace Helpers
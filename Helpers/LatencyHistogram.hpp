@@ -0,0 +1,92 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace Helpers
+{
+
+/// @brief A histogram of durations in the style of HdrHistogram: buckets are exact below 32ns,
+///        and from there every power of two is split into 32 buckets, so a value read back is
+///        within 1/32 (about 3%) of what was recorded, from nanoseconds up to minutes.
+///
+///        Record is wait-free (a few relaxed atomic adds), so any number of threads can record
+///        into one histogram, and any thread can take a Snapshot while they do.
+class LatencyHistogram
+{
+   public:
+    static constexpr int SUB_BUCKET_BITS = 5;
+    static constexpr uint64_t NUM_SUB_BUCKETS = uint64_t{1} << SUB_BUCKET_BITS;
+
+    /// @brief Longer durations (about 18 minutes) are counted as this long.
+    static constexpr int MAX_VALUE_BITS = 40;
+    static constexpr uint64_t MAX_NANOS = (uint64_t{1} << MAX_VALUE_BITS) - 1;
+    static constexpr size_t NUM_BUCKETS = NUM_SUB_BUCKETS * (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1);
+
+    /// @brief The counts at one moment. Taken while other threads record, it may be missing
+    ///        some of the values being recorded right then, but every count in it is true.
+    struct Snapshot
+    {
+        std::array<uint64_t, NUM_BUCKETS> counts;
+        uint64_t count;  // the sum of counts
+        uint64_t totalNanos;
+        uint64_t maxNanos;
+
+        double GetMeanNanos() const;
+
+        /// @return The duration that percent of the values are at or below, rounded up to the
+        ///         end of its bucket (but no higher than the max). 0 if nothing was recorded.
+        uint64_t GetPercentileNanos(double percent) const;
+    };
+
+    LatencyHistogram();
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /// @brief Negative durations (from clocks that disagree) are counted as 0.
+    void Record(std::chrono::nanoseconds duration);
+
+    Snapshot GetSnapshot() const;
+
+    static size_t GetBucket(uint64_t nanos);
+
+    /// @return The longest duration that goes in the bucket.
+    static uint64_t GetBucketEnd(size_t bucket);
+
+   private:
+    std::array<std::atomic<uint64_t>, NUM_BUCKETS> m_counts;
+    std::atomic<uint64_t> m_totalNanos;
+    std::atomic<uint64_t> m_maxNanos;
+};
+
+inline void LatencyHistogram::Record(std::chrono::nanoseconds duration)
+{
+    const uint64_t nanos =
+        std::min(static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0)), MAX_NANOS);
+    m_counts[GetBucket(nanos)].fetch_add(1, std::memory_order_relaxed);
+    m_totalNanos.fetch_add(nanos, std::memory_order_relaxed);
+
+    uint64_t maxNanos = m_maxNanos.load(std::memory_order_relaxed);
+    while (nanos > maxNanos &&
+           !m_maxNanos.compare_exchange_weak(maxNanos, nanos, std::memory_order_relaxed))
+    {
+    }
+}
+
+inline size_t LatencyHistogram::GetBucket(uint64_t nanos)
+{
+    if (nanos < NUM_SUB_BUCKETS)
+        return static_cast<size_t>(nanos);
+
+    // the top SUB_BUCKET_BITS + 1 bits of the value pick the bucket
+    const int shift = std::bit_width(nanos) - 1 - SUB_BUCKET_BITS;
+    return static_cast<size_t>((shift + 1) * NUM_SUB_BUCKETS + (nanos >> shift) - NUM_SUB_BUCKETS);
+}
+
+}  // namespace Helpers
@@ -0,0 +1,272 @@
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Helpers
+{
+
+#ifdef _WIN32
+
+MappedFile::MappedFile()
+    : m_file(INVALID_HANDLE_VALUE),
+      m_mapping(nullptr),
+      m_data(nullptr),
+      m_size(0),
+      m_isOpen(false)
+{
+}
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::Open(const std::string& filename)
+{
+    Close();
+
+    // FILE_SHARE_WRITE so a log that is still being written can be analyzed
+    m_file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                         nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size))
+    {
+        Close();
+        return false;
+    }
+
+    m_isOpen = true;
+    m_size = static_cast<size_t>(size.QuadPart);
+    if (m_size == 0)
+        return true;  // empty files can't be mapped
+
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_mapping != nullptr)
+        m_data = static_cast<const char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+
+    if (m_data == nullptr)
+    {
+        Close();
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+    if (m_file != INVALID_HANDLE_VALUE)
+        CloseHandle(m_file);
+
+    m_file = INVALID_HANDLE_VALUE;
+    m_mapping = nullptr;
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+}
+
+WritableMappedFile::WritableMappedFile()
+    : m_file(INVALID_HANDLE_VALUE), m_mapping(nullptr), m_data(nullptr), m_size(0)
+{
+}
+
+WritableMappedFile::~WritableMappedFile()
+{
+    if (IsOpen())
+        Close(m_size);
+}
+
+bool WritableMappedFile::Create(const std::string& filename, size_t size)
+{
+    if (IsOpen())
+        Close(m_size);
+
+    m_file = CreateFileA(filename.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                         CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE)
+        return false;
+
+    if (!Map(size))
+    {
+        CloseHandle(m_file);
+        m_file = INVALID_HANDLE_VALUE;
+        return false;
+    }
+    return true;
+}
+
+void WritableMappedFile::Close(size_t finalSize)
+{
+    Unmap();
+    if (m_file != INVALID_HANDLE_VALUE)
+    {
+        LARGE_INTEGER end;
+        end.QuadPart = static_cast<LONGLONG>(finalSize);
+        if (SetFilePointerEx(m_file, end, nullptr, FILE_BEGIN))
+            SetEndOfFile(m_file);
+        CloseHandle(m_file);
+    }
+    m_file = INVALID_HANDLE_VALUE;
+}
+
+bool WritableMappedFile::Map(size_t size)
+{
+    // a mapping larger than the file extends the file
+    const uint64_t size64 = size;
+    m_mapping = CreateFileMappingA(m_file, nullptr, PAGE_READWRITE,
+                                   static_cast<DWORD>(size64 >> 32), static_cast<DWORD>(size64),
+                                   nullptr);
+    if (m_mapping == nullptr)
+        return false;
+
+    m_data = static_cast<char*>(MapViewOfFile(m_mapping, FILE_MAP_WRITE, 0, 0, size));
+    if (m_data == nullptr)
+    {
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+        return false;
+    }
+    m_size = size;
+    return true;
+}
+
+void WritableMappedFile::Unmap()
+{
+    if (m_data != nullptr)
+        UnmapViewOfFile(m_data);
+    if (m_mapping != nullptr)
+        CloseHandle(m_mapping);
+    m_mapping = nullptr;
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#else
+
+MappedFile::MappedFile() : m_data(nullptr), m_size(0), m_isOpen(false) {}
+
+MappedFile::~MappedFile() { Close(); }
+
+bool MappedFile::Open(const std::string& filename)
+{
+    Close();
+
+    const int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+        return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0)
+    {
+        close(fd);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(info.st_size);
+    if (m_size > 0)
+    {
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            close(fd);
+            m_size = 0;
+            return false;
+        }
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char*>(data);
+    }
+
+    // the mapping keeps the file alive on its own
+    close(fd);
+    m_isOpen = true;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_data != nullptr)
+        munmap(const_cast<char*>(m_data), m_size);
+
+    m_data = nullptr;
+    m_size = 0;
+    m_isOpen = false;
+}
+
+
+WritableMappedFile::WritableMappedFile() : m_file(-1), m_data(nullptr), m_size(0) {}
+
+WritableMappedFile::~WritableMappedFile()
+{
+    if (IsOpen())
+        Close(m_size);
+}
+
+bool WritableMappedFile::Create(const std::string& filename, size_t size)
+{
+    if (IsOpen())
+        Close(m_size);
+
+    m_file = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (m_file < 0)
+        return false;
+
+    if (!Map(size))
+    {
+        close(m_file);
+        m_file = -1;
+        return false;
+    }
+    return true;
+}
+
+void WritableMappedFile::Close(size_t finalSize)
+{
+    Unmap();
+    if (m_file >= 0)
+    {
+        // if this fails the file keeps a zero-filled tail, which is still valid
+        [[maybe_unused]] const int result = ftruncate(m_file, static_cast<off_t>(finalSize));
+        close(m_file);
+    }
+    m_file = -1;
+}
+
+bool WritableMappedFile::Map(size_t size)
+{
+    struct stat info;
+    if (fstat(m_file, &info) != 0)
+        return false;
+    if (static_cast<size_t>(info.st_size) < size &&
+        ftruncate(m_file, static_cast<off_t>(size)) != 0)
+        return false;
+
+    void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_file, 0);
+    if (data == MAP_FAILED)
+        return false;
+
+    m_data = static_cast<char*>(data);
+    m_size = size;
+    return true;
+}
+
+void WritableMappedFile::Unmap()
+{
+    if (m_data != nullptr)
+        munmap(m_data, m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+
+#endif
+
+}  // namespace Helpers
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace Helpers
+{
+
+/// @brief Read-only memory mapping of a whole file.
+///        The contents can be walked like one big string without ever copying them.
+class MappedFile
+{
+   public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// @brief Maps the file, unmapping any previously mapped one. Empty files map to an empty view.
+    bool Open(const std::string& filename);
+    void Close();
+
+    bool IsOpen() const { return m_isOpen; }
+    std::string_view View() const { return std::string_view(m_data, m_size); }
+
+   private:
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#endif
+    const char* m_data;
+    size_t m_size;
+    bool m_isOpen;
+};
+
+/// @brief Read-write memory mapping of a file that this process creates and fills in.
+///        Stores into the mapping land in the file without any write calls. The OS writes the
+///        pages back on its own, and they survive the process crashing (not the machine).
+class WritableMappedFile
+{
+   public:
+    WritableMappedFile();
+    ~WritableMappedFile();
+
+    WritableMappedFile(const WritableMappedFile&) = delete;
+    WritableMappedFile& operator=(const WritableMappedFile&) = delete;
+
+    /// @brief Creates the file, replacing any existing one, zero-filled to the given size,
+    ///        and maps all of it. Closes any previously mapped file first.
+    bool Create(const std::string& filename, size_t size);
+
+    /// @brief Unmaps and closes the file, cutting it down to finalSize first.
+    void Close(size_t finalSize);
+
+    bool IsOpen() const { return m_data != nullptr; }
+    char* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+
+   private:
+#ifdef _WIN32
+    void* m_file;
+    void* m_mapping;
+#else
+    int m_file;
+#endif
+    char* m_data;
+    size_t m_size;
+
+    /// @brief Maps the first size bytes of the file, extending it if it's shorter.
+    bool Map(size_t size);
+    void Unmap();
+};
+
+}  // namespace Helpers
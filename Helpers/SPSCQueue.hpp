@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+namespace Helpers
+{
+
+/// @brief Bounded single-producer/single-consumer ring buffer of fixed-size items.
+///        Both sides are wait-free: a push or pop is a copy plus one release store,
+///        and each side only reads the other side's cursor when its cached copy says the ring
+///        looks full (or empty), so in the steady state the two threads share no cache lines.
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+class SPSCQueue
+{
+   public:
+    /// @param capacity Number of slots in the ring. Must be a power of two.
+    explicit SPSCQueue(size_t capacity);
+
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    /// @brief Must only ever be called from the single producer thread.
+    /// @return false if the ring was full and the item was not enqueued.
+    bool TryPush(const T& item);
+
+    /// @brief Must only ever be called from the single consumer thread.
+    /// @return false if the ring was empty.
+    bool TryPop(T& item);
+
+    /// @brief Approximate number of items in the ring. Exact only from the producer thread
+    ///        or the consumer thread.
+    size_t Size() const;
+
+    size_t Capacity() const { return m_mask + 1; }
+
+   private:
+    // keeps the producer and consumer cursors from sharing a cache line
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    const size_t m_mask;
+    std::unique_ptr<T[]> m_items;
+
+    // producer side
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;  // next slot the producer will write
+    size_t m_cachedHead;                                   // last value of m_head it saw
+
+    // consumer side
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head;  // next slot the consumer will read
+    size_t m_cachedTail;                                   // last value of m_tail it saw
+};
+
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+SPSCQueue<T>::SPSCQueue(size_t capacity)
+    : m_mask(capacity - 1),
+      m_items(std::make_unique<T[]>(capacity)),
+      m_tail(0),
+      m_cachedHead(0),
+      m_head(0),
+      m_cachedTail(0)
+{
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+        throw std::invalid_argument("SPSCQueue capacity must be a power of two.");
+}
+
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+bool SPSCQueue<T>::TryPush(const T& item)
+{
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_cachedHead > m_mask)
+    {
+        m_cachedHead = m_head.load(std::memory_order_acquire);
+        if (tail - m_cachedHead > m_mask)
+            return false;
+    }
+
+    m_items[tail & m_mask] = item;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+bool SPSCQueue<T>::TryPop(T& item)
+{
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_cachedTail)
+    {
+        m_cachedTail = m_tail.load(std::memory_order_acquire);
+        if (head == m_cachedTail)
+            return false;
+    }
+
+    item = m_items[head & m_mask];
+    // hands the slot back to the producer
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+size_t SPSCQueue<T>::Size() const
+{
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+}
+
+}  // namespace Helpers
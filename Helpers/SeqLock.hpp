@@ -0,0 +1,107 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace Helpers
+{
+
+/// @brief A value with one writer and any number of readers, none of which ever take a lock.
+///        The writer bumps a sequence number to odd, writes, and bumps it back to even.
+///        A reader copies the value out between two reads of the sequence number and retries
+///        if they differ or were odd, so it only ever returns a value from a single Store.
+///        The value is kept as atomic words, so a reader racing the writer is well-defined
+///        (it reads a mix of old and new words, notices, and throws the copy away).
+///        Readers never slow the writer down; a reader only waits while a Store is in flight.
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+class SeqLock
+{
+   public:
+    /// @brief Holds a value-initialized T until the first Store.
+    SeqLock();
+
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    /// @brief Must only ever be called from one thread at a time.
+    void Store(const T& value);
+
+    /// @brief Safe to call from any thread, concurrently with Store.
+    T Load() const;
+
+    /// @brief Number of Stores completed so far.
+    uint64_t GetVersion() const { return m_sequence.load(std::memory_order_acquire) / 2; }
+
+   private:
+    static constexpr size_t NUM_WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+    // a reader that keeps losing to the writer gives it the CPU after this many tries
+    static constexpr int SPINS_BEFORE_YIELD = 64;
+
+    // keeps readers polling the sequence number off the lines the writer is filling
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<uint64_t> m_sequence;
+    alignas(CACHE_LINE_SIZE) std::array<std::atomic<uint64_t>, NUM_WORDS> m_words;
+};
+
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+SeqLock<T>::SeqLock() : m_sequence(0)
+{
+    std::array<uint64_t, NUM_WORDS> words{};
+    const T value{};
+    std::memcpy(words.data(), &value, sizeof(T));
+    for (size_t i = 0; i < NUM_WORDS; i++)
+        m_words[i].store(words[i], std::memory_order_relaxed);
+}
+
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+void SeqLock<T>::Store(const T& value)
+{
+    std::array<uint64_t, NUM_WORDS> words{};
+    std::memcpy(words.data(), &value, sizeof(T));
+
+    const uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    // keeps the word stores below from becoming visible before the odd sequence number
+    std::atomic_thread_fence(std::memory_order_release);
+    for (size_t i = 0; i < NUM_WORDS; i++)
+        m_words[i].store(words[i], std::memory_order_relaxed);
+    m_sequence.store(sequence + 2, std::memory_order_release);
+}
+
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+T SeqLock<T>::Load() const
+{
+    std::array<uint64_t, NUM_WORDS> words;
+    for (int attempt = 1;; attempt++)
+    {
+        const uint64_t before = m_sequence.load(std::memory_order_acquire);
+        if ((before & 1) == 0)
+        {
+            for (size_t i = 0; i < NUM_WORDS; i++)
+                words[i] = m_words[i].load(std::memory_order_relaxed);
+            // keeps the word loads above from moving past the second sequence read
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (m_sequence.load(std::memory_order_relaxed) == before)
+                break;
+        }
+        if (attempt % SPINS_BEFORE_YIELD == 0)
+            std::this_thread::yield();
+    }
+
+    T value;
+    std::memcpy(static_cast<void*>(&value), words.data(), sizeof(T));
+    return value;
+}
+
+}  // namespace Helpers
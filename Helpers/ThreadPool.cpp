@@ -0,0 +1,73 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace Helpers
+{
+
+ThreadPool::ThreadPool(size_t numThreads) : m_numActiveJobs(0), m_isStopping(false)
+{
+    if (numThreads == 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (size_t i = 0; i < numThreads; i++)
+        m_workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopping = true;
+    }
+    m_jobAvailable.notify_all();
+
+    for (auto& worker : m_workers)
+        worker.join();
+}
+
+void ThreadPool::Submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_jobs.push(std::move(job));
+    }
+    m_jobAvailable.notify_one();
+}
+
+void ThreadPool::Wait()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_allJobsDone.wait(lock, [this] { return m_jobs.empty() && m_numActiveJobs == 0; });
+}
+
+void ThreadPool::WorkerLoop()
+{
+    while (true)
+    {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobAvailable.wait(lock, [this] { return m_isStopping || !m_jobs.empty(); });
+
+            // drain the queue before stopping so no submitted job is lost
+            if (m_jobs.empty())
+                return;
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop();
+            m_numActiveJobs++;
+        }
+
+        job();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_numActiveJobs--;
+            if (m_jobs.empty() && m_numActiveJobs == 0)
+                m_allJobsDone.notify_all();
+        }
+    }
+}
+
+}  // namespace Helpers
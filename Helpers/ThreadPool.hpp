@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace Helpers
+{
+
+/// @brief Fixed set of worker threads pulling jobs off a shared queue.
+///        Meant for coarse jobs (one file, one batch), not for per-event work.
+class ThreadPool
+{
+   public:
+    /// @param numThreads 0 means one per hardware thread.
+    explicit ThreadPool(size_t numThreads = 0);
+
+    /// @brief Finishes every submitted job, then joins the workers.
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void Submit(std::function<void()> job);
+
+    /// @brief Blocks until every job submitted so far has finished.
+    void Wait();
+
+    size_t NumThreads() const { return m_workers.size(); }
+
+   private:
+    std::vector<std::thread> m_workers;
+    std::queue<std::function<void()>> m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_jobAvailable;
+    std::condition_variable m_allJobsDone;
+    size_t m_numActiveJobs;
+    bool m_isStopping;
+
+    void WorkerLoop();
+};
+
+}  // namespace Helpers
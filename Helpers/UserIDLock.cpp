@@ -32,6 +32,10 @@ void UserIDLock::Lock(int id)
         return;
 
     lockedIds.push_back(id);
+
+    // written right away so the ID stays locked even if the study crashes
+    std::ofstream file(filename, std::ios::app);
+    file << id << "\n";
 }
 
 bool UserIDLock::IsLocked(int id)
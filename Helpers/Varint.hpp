@@ -0,0 +1,104 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace Helpers
+{
+
+/// @brief Appends an unsigned LEB128 varint (7 bits per byte, high bit = continuation).
+/// @tparam Buffer std::string or anything else with operator+=(char).
+template <typename Buffer>
+void AppendVarint(Buffer& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out += static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out += static_cast<char>(value);
+}
+
+/// @brief Maps signed values onto unsigned ones so small magnitudes stay small:
+///        0 => 0, -1 => 1, 1 => 2, -2 => 3, ...
+inline uint64_t ZigZagEncode(int64_t value)
+{
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t ZigZagDecode(uint64_t value)
+{
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+template <typename Buffer>
+void AppendSignedVarint(Buffer& out, int64_t value)
+{
+    AppendVarint(out, ZigZagEncode(value));
+}
+
+/// @brief Bounds-checked cursor over an encoded byte buffer.
+///        Reads past the end set the error flag and return zeroes instead of throwing,
+///        so a decoder can check HasError() once after a whole block.
+class ByteReader
+{
+   public:
+    ByteReader(std::string_view data) : m_data(data), m_offset(0), m_hasError(false) {}
+
+    uint64_t ReadVarint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            if (m_offset >= m_data.size())
+            {
+                m_hasError = true;
+                return 0;
+            }
+            const uint8_t byte = static_cast<uint8_t>(m_data[m_offset++]);
+            value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0)
+                return value;
+        }
+        m_hasError = true;  // more than 10 bytes is not a valid 64-bit varint
+        return 0;
+    }
+
+    int64_t ReadSignedVarint() { return ZigZagDecode(ReadVarint()); }
+
+    uint8_t ReadByte()
+    {
+        if (m_offset >= m_data.size())
+        {
+            m_hasError = true;
+            return 0;
+        }
+        return static_cast<uint8_t>(m_data[m_offset++]);
+    }
+
+    std::string_view ReadBytes(size_t length)
+    {
+        if (length > m_data.size() - m_offset)
+        {
+            m_hasError = true;
+            m_offset = m_data.size();
+            return {};
+        }
+        std::string_view bytes = m_data.substr(m_offset, length);
+        m_offset += length;
+        return bytes;
+    }
+
+    bool HasError() const { return m_hasError; }
+    bool IsAtEnd() const { return m_offset == m_data.size(); }
+    size_t Offset() const { return m_offset; }
+
+   private:
+    std::string_view m_data;
+    size_t m_offset;
+    bool m_hasError;
+};
+
+}  // namespace Helpers
@@ -0,0 +1,88 @@
+#include "FrameCapture.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+namespace Input::Leap
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+FrameRecord ToRecord(const TrackingFrame& frame)
+{
+    FrameRecord record{};
+    record.trackingFrameId = frame.trackingFrameId;
+    record.timestampMicros = frame.timestampMicros;
+    record.framerate = frame.framerate;
+    record.nHands = std::min(frame.nHands, MAX_TRACKED_HANDS);
+    std::copy_n(frame.hands.begin(), record.nHands, record.hands.begin());
+    return record;
+}
+
+TrackingFrame FromRecord(const FrameRecord& record)
+{
+    TrackingFrame frame{};
+    frame.trackingFrameId = record.trackingFrameId;
+    frame.timestampMicros = record.timestampMicros;
+    frame.framerate = record.framerate;
+    frame.nHands = std::min(record.nHands, MAX_TRACKED_HANDS);
+    std::copy_n(record.hands.begin(), frame.nHands, frame.hands.begin());
+    return frame;
+}
+
+bool WriteFrameCapture(const std::string& filename, const std::vector<TrackingFrame>& frames)
+{
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file)
+        return false;
+
+    FrameCaptureHeader header{};
+    header.magic = FRAME_CAPTURE_MAGIC;
+    header.version = FRAME_CAPTURE_VERSION;
+    header.recordSize = sizeof(FrameRecord);
+    header.numFrames = frames.size();
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (const TrackingFrame& frame : frames)
+    {
+        const FrameRecord record = ToRecord(frame);
+        file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    }
+    return static_cast<bool>(file.flush());
+}
+
+FrameCaptureReader::FrameCaptureReader() : m_numFrames(0) {}
+
+bool FrameCaptureReader::Open(const std::string& filename)
+{
+    m_numFrames = 0;
+    if (!m_file.Open(filename))
+        return false;
+
+    const std::string_view data = m_file.View();
+    FrameCaptureHeader header;
+    if (data.size() < FRAME_CAPTURE_HEADER_SIZE)
+        return false;
+    std::memcpy(&header, data.data(), FRAME_CAPTURE_HEADER_SIZE);
+    if (header.magic != FRAME_CAPTURE_MAGIC || header.version != FRAME_CAPTURE_VERSION ||
+        header.recordSize != sizeof(FrameRecord))
+        return false;
+
+    // a capture that was cut short has fewer whole records than its header claims
+    const size_t numWholeRecords = (data.size() - FRAME_CAPTURE_HEADER_SIZE) / sizeof(FrameRecord);
+    m_numFrames = static_cast<size_t>(std::min<uint64_t>(header.numFrames, numWholeRecords));
+    return true;
+}
+
+TrackingFrame FrameCaptureReader::GetFrame(size_t index) const
+{
+    // records aren't necessarily aligned in the mapping, so they are copied out
+    FrameRecord record;
+    std::memcpy(&record, m_file.View().data() + FRAME_CAPTURE_HEADER_SIZE + index * sizeof(record),
+                sizeof(record));
+    return FromRecord(record);
+}
+
+}  // namespace Input::Leap
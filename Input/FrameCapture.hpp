@@ -0,0 +1,89 @@
+#pragma once
+
+#include <LeapC.h>
+
+#include <Helpers/MappedFile.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "FrameSource.hpp"
+
+namespace Input::Leap
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Frame capture format
+///////////////////////////////////////////////////////////////////////////////
+//
+// A frame capture is a recording of the tracking stream: a FrameCaptureHeader followed by
+// FrameRecords, all the same size, so frame i starts at
+//     FRAME_CAPTURE_HEADER_SIZE + i * sizeof(FrameRecord)
+// and any frame can be read without reading the ones before it.
+//
+// Records are the in-memory layout of LEAP_HAND and friends, so a capture is only readable on
+// the same platform and LeapC version it was recorded with. The header carries the record size
+// so a reader notices when that is not the case.
+
+constexpr std::array<char, 8> FRAME_CAPTURE_MAGIC = {'H', 'G', 'U', 'S', 'F', 'R', 'M', 'S'};
+constexpr uint32_t FRAME_CAPTURE_VERSION = 1;
+
+struct FrameCaptureHeader
+{
+    std::array<char, 8> magic;
+    uint32_t version;
+    uint32_t recordSize;  // sizeof(FrameRecord) where it was recorded
+    uint64_t numFrames;   // records written so far; anything after them is not a frame yet
+    uint64_t reserved[5];
+};
+
+constexpr size_t FRAME_CAPTURE_HEADER_SIZE = sizeof(FrameCaptureHeader);
+static_assert(FRAME_CAPTURE_HEADER_SIZE == 64);
+
+/// @brief One recorded frame: a TrackingFrame without what its source filled in.
+struct FrameRecord
+{
+    int64_t trackingFrameId;
+    int64_t timestampMicros;
+    float framerate;
+    uint32_t nHands;
+    std::array<LEAP_HAND, MAX_TRACKED_HANDS> hands;
+};
+
+// records in a page aligned mapping of a capture are aligned, so they can be written in place
+static_assert(FRAME_CAPTURE_HEADER_SIZE % alignof(FrameRecord) == 0);
+
+FrameRecord ToRecord(const TrackingFrame& frame);
+
+/// @brief sequence, receivedAt and receivedMicros are left zero, for the frame's source to fill
+///        in.
+TrackingFrame FromRecord(const FrameRecord& record);
+
+/// @brief Writes a whole capture at once, replacing the file if there is one.
+bool WriteFrameCapture(const std::string& filename, const std::vector<TrackingFrame>& frames);
+
+/// @brief Random access to the frames of a capture, which is memory mapped rather than read.
+class FrameCaptureReader
+{
+   public:
+    FrameCaptureReader();
+
+    FrameCaptureReader(const FrameCaptureReader&) = delete;
+    FrameCaptureReader& operator=(const FrameCaptureReader&) = delete;
+
+    /// @return false if the file can't be mapped or isn't a capture this build can read.
+    bool Open(const std::string& filename);
+
+    size_t GetNumFrames() const { return m_numFrames; }
+
+    /// @brief O(1). index must be less than GetNumFrames().
+    TrackingFrame GetFrame(size_t index) const;
+
+   private:
+    Helpers::MappedFile m_file;
+    size_t m_numFrames;
+};
+
+}  // namespace Input::Leap
@@ -0,0 +1,143 @@
+#include "FrameRecorder.hpp"
+
+#include <Helpers/Clock.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+namespace Input::Leap
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+size_t GetCaptureSize(size_t numFrames);
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+FrameRecorder::FrameRecorder()
+    : m_capacity(0), m_stats{}, m_prefaultedSize(0), m_isStopping(false)
+{
+}
+
+FrameRecorder::~FrameRecorder() { Stop(); }
+
+bool FrameRecorder::Start(const std::string& filename, size_t capacity)
+{
+    if (IsRecording())
+        Stop();
+
+    m_capacity = std::max<size_t>(capacity, 1);
+    m_stats = Stats{};
+    if (!m_file.Create(filename, GetCaptureSize(m_capacity)))
+        return false;
+
+    // before the header is written, since touching a page zeroes its first byte
+    m_prefaultedSize.store(0, std::memory_order_relaxed);
+    Prefault(0);
+
+    // the rest of the file, numFrames included, starts out as zeroes
+    FrameCaptureHeader* header = GetHeader();
+    header->magic = FRAME_CAPTURE_MAGIC;
+    header->version = FRAME_CAPTURE_VERSION;
+    header->recordSize = sizeof(FrameRecord);
+
+    m_isStopping.store(false, std::memory_order_relaxed);
+    m_prefaulter = std::thread(&FrameRecorder::PrefaultLoop, this);
+    return true;
+}
+
+void FrameRecorder::Record(const LEAP_TRACKING_EVENT& event)
+{
+    const auto start = Helpers::Clock::SteadyClock::now();
+
+    // growing the file would mean remapping it, and writing to an untouched page faulting it
+    // in, either of which can take milliseconds
+    if (m_stats.numFrames == m_capacity ||
+        GetCaptureSize(m_stats.numFrames + 1) > m_prefaultedSize.load(std::memory_order_acquire))
+    {
+        m_stats.numDropped++;
+        return;
+    }
+
+    // hands past nHands are left as the zeroes the file was created with
+    FrameRecord* record = GetRecord(m_stats.numFrames);
+    record->trackingFrameId = event.tracking_frame_id;
+    record->timestampMicros = event.info.timestamp;
+    record->framerate = event.framerate;
+    record->nHands = std::min(event.nHands, MAX_TRACKED_HANDS);
+    std::memcpy(record->hands.data(), event.pHands, record->nHands * sizeof(LEAP_HAND));
+
+    // the count goes in last, so it never covers a record that is only partly written
+    m_stats.numFrames++;
+    std::atomic_ref<uint64_t>(GetHeader()->numFrames)
+        .store(m_stats.numFrames, std::memory_order_release);
+
+    const auto elapsed = Helpers::Clock::SteadyClock::now() - start;
+    const int64_t nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    m_stats.totalNanos += nanos;
+    m_stats.maxNanos = std::max(m_stats.maxNanos, nanos);
+}
+
+FrameRecorder::Stats FrameRecorder::Stop()
+{
+    if (m_prefaulter.joinable())
+    {
+        m_isStopping.store(true, std::memory_order_relaxed);
+        m_prefaulter.join();
+    }
+    if (IsRecording())
+        m_file.Close(GetCaptureSize(m_stats.numFrames));
+    return m_stats;
+}
+
+FrameCaptureHeader* FrameRecorder::GetHeader() const
+{
+    return reinterpret_cast<FrameCaptureHeader*>(m_file.Data());
+}
+
+FrameRecord* FrameRecorder::GetRecord(size_t index) const
+{
+    // the mapping is page aligned and FRAME_CAPTURE_HEADER_SIZE keeps records aligned after it
+    return reinterpret_cast<FrameRecord*>(m_file.Data() + GetCaptureSize(index));
+}
+
+void FrameRecorder::Prefault(uint64_t numFrames)
+{
+    const size_t prefaultedSize = m_prefaultedSize.load(std::memory_order_relaxed);
+    const size_t wantedSize = GetCaptureSize(std::min(numFrames + PREFAULT_FRAMES, m_capacity));
+    if (wantedSize <= prefaultedSize)
+        return;
+
+    // the file starts out as zeroes, so writing a zero to each page changes nothing but whether
+    // it's been faulted in
+    const size_t newSize = std::min((wantedSize + PAGE_SIZE - 1) / PAGE_SIZE * PAGE_SIZE,
+                                    m_file.Size());
+    for (size_t offset = prefaultedSize; offset < newSize; offset += PAGE_SIZE)
+        *reinterpret_cast<volatile char*>(m_file.Data() + offset) = 0;
+    m_prefaultedSize.store(newSize, std::memory_order_release);
+}
+
+void FrameRecorder::PrefaultLoop()
+{
+    while (!m_isStopping.load(std::memory_order_relaxed))
+    {
+        const uint64_t numFrames =
+            std::atomic_ref<uint64_t>(GetHeader()->numFrames).load(std::memory_order_acquire);
+        Prefault(numFrames);
+        // a millisecond is a fraction of a frame at any rate LeapC tracks at
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+size_t GetCaptureSize(size_t numFrames)
+{
+    return FRAME_CAPTURE_HEADER_SIZE + numFrames * sizeof(FrameRecord);
+}
+
+}  // namespace Input::Leap
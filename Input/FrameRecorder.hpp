@@ -0,0 +1,95 @@
+#pragma once
+
+#include <LeapC.h>
+
+#include <Helpers/MappedFile.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <thread>
+
+#include "FrameCapture.hpp"
+
+namespace Input::Leap
+{
+
+/// @brief Records the tracking stream into a frame capture (see FrameCapture.hpp) as it arrives.
+///        The capture file is created by Start at a size that holds capacity frames and memory
+///        mapped, and every frame is written straight from the LEAP_TRACKING_EVENT into its
+///        record in the mapping, followed by the header's frame count. There is no write call,
+///        no intermediate copy and no remapping, so recording costs about as much as copying the
+///        hands. Once the capture is full, frames are dropped and counted rather than making the
+///        polling thread wait for the file to grow.
+///
+///        The first write to each page of the mapping is a page fault, which can take
+///        milliseconds while the file system finds room for it, so a thread of the recorder's
+///        own touches the pages ahead of the frames being recorded. Record only writes to pages
+///        that have been touched; if it ever catches up, the frame is dropped instead.
+///
+///        The header's frame count is only advanced once a record is complete, so a capture left
+///        behind by a crash reads back as every frame recorded before it.
+///        Not thread safe; LeapConnection hands its recorders to the polling thread through an
+///        atomic pointer, and only starts and stops them on other threads.
+class FrameRecorder
+{
+   public:
+    /// @brief A whole study session: an hour at 120 frames a second. Stop cuts the file down to
+    ///        what was recorded.
+    static constexpr size_t DEFAULT_CAPACITY_FRAMES = 120 * 60 * 60;
+
+    /// @brief How far ahead of the recorded frames the pages are touched: about 2MB, or eight
+    ///        seconds at 120 frames a second.
+    static constexpr size_t PREFAULT_FRAMES = 1024;
+
+    struct Stats
+    {
+        uint64_t numFrames;
+        uint64_t numDropped;  // the capture was full, or its pages weren't touched yet
+        int64_t totalNanos;  // spent in Record
+        int64_t maxNanos;
+    };
+
+    FrameRecorder();
+    ~FrameRecorder();
+
+    FrameRecorder(const FrameRecorder&) = delete;
+    FrameRecorder& operator=(const FrameRecorder&) = delete;
+
+    /// @brief Starts a new capture with room for capacity frames, stopping the current one if
+    ///        there is one. The first PREFAULT_FRAMES worth of pages are touched before it returns.
+    bool Start(const std::string& filename, size_t capacity = DEFAULT_CAPACITY_FRAMES);
+
+    /// @brief Appends the frame, keeping up to MAX_TRACKED_HANDS of its hands, or drops it if
+    ///        the capture is full.
+    void Record(const LEAP_TRACKING_EVENT& event);
+
+    /// @brief Cuts the capture down to the frames recorded and closes it.
+    /// @return Stats of the capture that was stopped.
+    Stats Stop();
+
+    bool IsRecording() const { return m_file.IsOpen(); }
+    const Stats& GetStats() const { return m_stats; }
+
+   private:
+    static constexpr size_t PAGE_SIZE = 4096;
+
+    Helpers::WritableMappedFile m_file;
+    size_t m_capacity;
+    Stats m_stats;
+
+    // Bytes from the start of the file whose pages have been touched. Page aligned, or the
+    // whole file. Only the prefaulter writes past it, and only Record writes before it.
+    std::atomic<size_t> m_prefaultedSize;
+    std::atomic<bool> m_isStopping;
+    std::thread m_prefaulter;
+
+    FrameCaptureHeader* GetHeader() const;
+    FrameRecord* GetRecord(size_t index) const;
+
+    /// @brief Touches every page up to the one holding PREFAULT_FRAMES past numFrames.
+    void Prefault(uint64_t numFrames);
+    void PrefaultLoop();
+};
+
+}  // namespace Input::Leap
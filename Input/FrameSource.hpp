@@ -0,0 +1,138 @@
+#pragma once
+
+#include <LeapC.h>
+
+#include <Helpers/Clock.hpp>
+#include <Helpers/SeqLock.hpp>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace Input::Leap
+{
+
+/// @brief The most hands a TrackingFrame keeps. LeapC tracks at most one left and one right hand.
+constexpr uint32_t MAX_TRACKED_HANDS = 2;
+
+/// @brief A tracking frame that owns its hands.
+///        LEAP_TRACKING_EVENT only points at hands in LeapC's own buffers, which get reused once
+///        the next message is polled, so the hands are copied in here instead.
+struct TrackingFrame
+{
+    /// @brief Counts frames published by the source from 1, see FrameSource::WaitForFrame.
+    uint64_t sequence;
+
+    /// @brief When the source published the frame.
+    Helpers::Clock::SteadyClock::time_point receivedAt;
+
+    int64_t trackingFrameId;
+    int64_t timestampMicros;  // LeapC's clock, see LeapGetNow
+    int64_t receivedMicros;   // LeapC's clock when the device's frame came in, 0 if not from one
+    float framerate;
+    uint32_t nHands;  // hands[0, nHands) are valid
+    std::array<LEAP_HAND, MAX_TRACKED_HANDS> hands;
+};
+
+/// @brief Somewhere tracking frames come from: the Leap Motion device (LeapConnection),
+///        or a recording of it (ReplayFrameSource).
+///        Frames are published by the source's own thread; any number of threads can read them.
+class FrameSource
+{
+   public:
+    virtual ~FrameSource() = default;
+
+    /// @brief Is the source producing frames?
+    virtual bool IsConnected() const = 0;
+
+    /// @brief Returns a copy of the latest frame, or a frame with no hands if there hasn't been
+    ///        one yet. Lock-free, and never a mix of two frames.
+    virtual TrackingFrame GetFrame() const = 0;
+
+    /// @brief Sequence number of the latest frame, 0 before the first one.
+    virtual uint64_t GetFrameSequence() const = 0;
+
+    /// @brief Blocks until there is a frame newer than the given sequence number,
+    ///        or until WakeFrameWaiters is called.
+    /// @return The latest frame's sequence number, which is the one passed in if there is none
+    ///         newer (the wait was cut short).
+    virtual uint64_t WaitForFrame(uint64_t sequence) = 0;
+
+    /// @brief Cuts short every WaitForFrame in progress, so waiters can check on other state.
+    virtual void WakeFrameWaiters() = 0;
+
+    /// @brief Whether the source can record at all. Sources that can't fail every StartRecording.
+    virtual bool CanRecord() const { return false; }
+
+    /// @brief Starts recording every frame into a new frame capture (see FrameCapture.hpp),
+    ///        stopping the current recording first. Safe to call from any thread.
+    /// @return false if the capture couldn't be created, or the source doesn't record.
+    virtual bool StartRecording(const std::string& /*filename*/) { return false; }
+
+    /// @brief Stops recording, if the source was. Safe to call from any thread.
+    virtual void StopRecording() {}
+
+    virtual bool IsRecording() const { return false; }
+};
+
+/// @brief The latest frame of a source, which does the publishing and waiting for FrameSources.
+///        Frames are kept in a Helpers::SeqLock, so only one thread may Publish.
+class FrameSlot
+{
+   public:
+    /// @brief Numbers the frame, stamps it with the current time, and wakes every waiter.
+    void Publish(TrackingFrame frame);
+
+    TrackingFrame Load() const { return m_frame.Load(); }
+    uint64_t GetSequence() const { return m_frame.GetVersion(); }
+
+    /// @brief See FrameSource::WaitForFrame. Once the slot is closed, never blocks.
+    uint64_t WaitForNewer(uint64_t sequence) const;
+
+    void WakeWaiters();
+
+    /// @brief Marks that no more frames are coming and wakes every waiter.
+    void Close();
+    bool IsClosed() const { return m_isClosed.load(std::memory_order_acquire); }
+
+   private:
+    Helpers::SeqLock<TrackingFrame> m_frame;
+    std::atomic<uint64_t> m_signal{0};  // bumped on every Publish, WakeWaiters and Close
+    std::atomic<bool> m_isClosed{false};
+};
+
+inline void FrameSlot::Publish(TrackingFrame frame)
+{
+    frame.sequence = GetSequence() + 1;
+    frame.receivedAt = Helpers::Clock::SteadyClock::now();
+    m_frame.Store(frame);
+    WakeWaiters();
+}
+
+inline uint64_t FrameSlot::WaitForNewer(uint64_t sequence) const
+{
+    // The signal is read before anything it guards: a frame stored (or the slot closed) after
+    // the checks below bumps the signal afterwards, so the wait returns straight away
+    // instead of missing it.
+    const uint64_t signal = m_signal.load(std::memory_order_acquire);
+    const uint64_t latest = GetSequence();
+    if (latest != sequence || IsClosed())
+        return latest;
+
+    m_signal.wait(signal, std::memory_order_acquire);
+    return GetSequence();
+}
+
+inline void FrameSlot::WakeWaiters()
+{
+    m_signal.fetch_add(1, std::memory_order_release);
+    m_signal.notify_all();
+}
+
+inline void FrameSlot::Close()
+{
+    m_isClosed.store(true, std::memory_order_release);
+    WakeWaiters();
+}
+
+}  // namespace Input::Leap
@@ -0,0 +1,56 @@
+#include "GestureClassifier.hpp"
+
+namespace Input::Leap
+{
+
+// the study's classifier has to be ProcessHandState, cone for cone
+static_assert(ConePoseDetector<>::CLICK.cosineSquared == CLICK_CONE.cosineSquared);
+static_assert(SectorQuantizer<>::DIRECTIONS.size() == CURSOR_DIRECTIONS.size());
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+std::optional<GestureClassifierType> ParseGestureClassifierType(std::string_view name)
+{
+    if (name == "study")
+        return GestureClassifierType::Study;
+    if (name == "dwell-click")
+        return GestureClassifierType::DwellClick;
+    if (name == "continuous")
+        return GestureClassifierType::Continuous;
+    if (name == "sixteen-way")
+        return GestureClassifierType::SixteenWay;
+    return std::nullopt;
+}
+
+const char* GetGestureClassifierName(GestureClassifierType type)
+{
+    switch (type)
+    {
+        case GestureClassifierType::DwellClick:
+            return "dwell-click";
+        case GestureClassifierType::Continuous:
+            return "continuous";
+        case GestureClassifierType::SixteenWay:
+            return "sixteen-way";
+        default:
+            return "study";
+    }
+}
+
+AnyGestureClassifier MakeGestureClassifier(GestureClassifierType type)
+{
+    switch (type)
+    {
+        case GestureClassifierType::DwellClick:
+            return DwellClickGestureClassifier{};
+        case GestureClassifierType::Continuous:
+            return ContinuousGestureClassifier{};
+        case GestureClassifierType::SixteenWay:
+            return SixteenWayGestureClassifier{};
+        default:
+            return StudyGestureClassifier{};
+    }
+}
+
+}  // namespace Input::Leap
@@ -0,0 +1,224 @@
+#pragma once
+
+#include <Math/MathHelpers.hpp>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <optional>
+#include <string_view>
+#include <variant>
+
+#include "LeapMotionGestureProvider.hpp"
+
+namespace Input::Leap
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Gesture classifiers
+///////////////////////////////////////////////////////////////////////////////
+//
+// A GestureClassifier decides what the driver does with a hand, from three policies:
+//   - a PoseDetector says if the hand is in the click pose, the movement pose, or neither,
+//   - a DirectionQuantizer turns the finger angle of a hand in the movement pose into a cursor
+//     direction,
+//   - a ClickPolicy says when being in the click pose makes a click.
+// The policies are template parameters, so every call is resolved at compile time and the hot
+// path has no virtual calls. The driver picks a classifier once, by GestureClassifierType, and
+// runs a loop compiled for it.
+
+enum class GesturePose
+{
+    None,
+    Click,
+    Move
+};
+
+template <typename T>
+concept PoseDetector = requires(const T detector, const UnprocessedHandState& hand) {
+    { detector.Detect(hand) } -> std::same_as<GesturePose>;
+};
+
+/// @brief Quantize gets the average finger angle of a hand in the movement pose, from 0 to pi,
+///        and returns the direction a left hand moves the cursor in.
+template <typename T>
+concept DirectionQuantizer = requires(const T quantizer, float averageFingerAngle) {
+    { quantizer.Quantize(averageFingerAngle) } -> std::same_as<CursorDirection>;
+};
+
+/// @brief Update gets every tracked hand's pose and the time since the last frame, and returns
+///        whether to click now. Reset is called when frames stop following on from each other
+///        (the hand is lost, or the driver was parked).
+template <typename T>
+concept ClickPolicy = requires(T policy, GesturePose pose, float frameSeconds) {
+    { policy.Update(pose, frameSeconds) } -> std::same_as<bool>;
+    policy.Reset();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Policies
+///////////////////////////////////////////////////////////////////////////////
+
+/// @brief The poses of ProcessHandState: the palm normal in a cone around down for the click
+///        pose, or around the thumb side for the movement pose.
+template <float ConeDegrees = TOLERANCE_CONE_ANGLE_DEGREES>
+struct ConePoseDetector
+{
+    static constexpr float CONE_RADIANS = ConeDegrees * Math::DEG_TO_RAD;
+    static constexpr Math::Cone CLICK{CLICK_CONE.axis, CONE_RADIANS};
+    static constexpr Math::Cone LEFT_MOVE{LEFT_MOVE_CONE.axis, CONE_RADIANS};
+    static constexpr Math::Cone RIGHT_MOVE{RIGHT_MOVE_CONE.axis, CONE_RADIANS};
+
+    GesturePose Detect(const UnprocessedHandState& hand) const
+    {
+        if (CLICK.Contains(hand.palmNormal))
+            return GesturePose::Click;
+        const Math::Cone& move = hand.isLeft ? LEFT_MOVE : RIGHT_MOVE;
+        return move.Contains(hand.palmNormal) ? GesturePose::Move : GesturePose::None;
+    }
+};
+
+/// @brief The cursor directions of ProcessHandState, for NumDirections directions.
+template <int NumDirections = NUM_CURSOR_DIRECTIONS>
+struct SectorQuantizer
+{
+    static constexpr auto DIRECTIONS = MakeCursorDirections<NumDirections>();
+
+    CursorDirection Quantize(float averageFingerAngle) const
+    {
+        return DIRECTIONS[GetCursorSector<NumDirections>(averageFingerAngle)];
+    }
+};
+
+/// @brief No quantization: the cursor goes where the fingers point.
+struct ContinuousQuantizer
+{
+    CursorDirection Quantize(float averageFingerAngle) const
+    {
+        return CursorDirection{std::sin(averageFingerAngle), std::cos(averageFingerAngle)};
+    }
+};
+
+/// @brief The driver's click: once on entering the click pose, and not again until the hand has
+///        been in another pose.
+class LatchClick
+{
+   public:
+    bool Update(GesturePose pose, float /*frameSeconds*/)
+    {
+        const bool shouldClick = pose == GesturePose::Click && !m_isEngaged;
+        m_isEngaged = pose == GesturePose::Click;
+        return shouldClick;
+    }
+
+    /// @brief A click made before the hand was lost stays made.
+    void Reset() {}
+
+   private:
+    bool m_isEngaged = false;
+};
+
+/// @brief Clicks once the click pose has been held for DwellMillis, so a hand that only flickers
+///        into the click pose on its way between poses doesn't click.
+template <int DwellMillis>
+class DwellClick
+{
+   public:
+    bool Update(GesturePose pose, float frameSeconds)
+    {
+        if (pose != GesturePose::Click)
+        {
+            m_heldSeconds = 0.0f;
+            m_hasClicked = false;
+            return false;
+        }
+        m_heldSeconds += frameSeconds;
+        if (m_hasClicked || m_heldSeconds < DwellMillis / 1000.0f)
+            return false;
+        m_hasClicked = true;
+        return true;
+    }
+
+    /// @brief The pose has to be held for the whole dwell after the hand comes back.
+    void Reset() { m_heldSeconds = 0.0f; }
+
+   private:
+    float m_heldSeconds = 0.0f;
+    bool m_hasClicked = false;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Classifiers
+///////////////////////////////////////////////////////////////////////////////
+
+struct GestureDecision
+{
+    /// @brief The hand as ProcessHandState would have it.
+    ProcessedHandState hand;
+
+    /// @brief Click now. Only ever set in the click pose.
+    bool shouldClick;
+};
+
+template <PoseDetector Detector, DirectionQuantizer Quantizer, ClickPolicy Click>
+class GestureClassifier
+{
+   public:
+    GestureDecision Classify(const UnprocessedHandState& hand, float frameSeconds)
+    {
+        GestureDecision decision{};
+        const GesturePose pose = m_detector.Detect(hand);
+        decision.hand.isInClickPose = pose == GesturePose::Click;
+        if (pose == GesturePose::Move)
+        {
+            const float averageAngle = GetAverageFingerAngle(hand);
+            const float side = hand.isLeft ? 1.0f : -1.0f;
+            const CursorDirection direction = m_quantizer.Quantize(averageAngle);
+            decision.hand.cursorDirectionX = direction.x * side;
+            decision.hand.cursorDirectionY = direction.y;
+            decision.hand.averageFingerDirectionX = std::sin(averageAngle) * side;
+            decision.hand.averageFingerDirectionY = std::cos(averageAngle);
+        }
+        decision.shouldClick = m_click.Update(pose, frameSeconds);
+        return decision;
+    }
+
+    /// @brief Call when frames stop following on from each other.
+    void Reset() { m_click.Reset(); }
+
+   private:
+    Detector m_detector;
+    Quantizer m_quantizer;
+    Click m_click;
+};
+
+/// @brief ProcessHandState and the driver's click, as the study was run.
+using StudyGestureClassifier =
+    GestureClassifier<ConePoseDetector<>, SectorQuantizer<>, LatchClick>;
+using DwellClickGestureClassifier =
+    GestureClassifier<ConePoseDetector<>, SectorQuantizer<>, DwellClick<100>>;
+using ContinuousGestureClassifier =
+    GestureClassifier<ConePoseDetector<>, ContinuousQuantizer, LatchClick>;
+using SixteenWayGestureClassifier =
+    GestureClassifier<ConePoseDetector<>, SectorQuantizer<16>, LatchClick>;
+
+enum class GestureClassifierType
+{
+    Study,
+    DwellClick,
+    Continuous,
+    SixteenWay
+};
+
+/// @brief Any one of the classifiers, to be used through std::visit once, outside the hot path.
+using AnyGestureClassifier = std::variant<StudyGestureClassifier, DwellClickGestureClassifier,
+                                          ContinuousGestureClassifier, SixteenWayGestureClassifier>;
+
+/// @return The type called "study", "dwell-click", "continuous" or "sixteen-way", or nothing if
+///         it's none of those.
+std::optional<GestureClassifierType> ParseGestureClassifierType(std::string_view name);
+
+const char* GetGestureClassifierName(GestureClassifierType type);
+
+AnyGestureClassifier MakeGestureClassifier(GestureClassifierType type);
+
+}  // namespace Input::Leap
@@ -0,0 +1,351 @@
+#include "HandStateBatch.hpp"
+
+#include <Math/MathHelpers.hpp>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define HAND_STATE_BATCH_SSE2 1
+#include <emmintrin.h>
+#else
+#define HAND_STATE_BATCH_SSE2 0
+#endif
+
+using Vec3 = Math::Vector3Common;
+
+namespace Input::Leap
+{
+
+constexpr float SECTOR_ARC_LENGTH = CURSOR_SECTOR_ARC_LENGTH;
+
+// How close (relative) a comparison may come to going the other way before the hand is handed to
+// ProcessHandState. The approximate finger angles are good to about 1e-6 radians.
+constexpr float CONE_MARGIN = 1e-5f;
+constexpr float SIGN_MARGIN = 1e-5f;
+constexpr float SECTOR_MARGIN = 1e-4f;  // in sectors
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+void ProcessOne(const HandStateBatch& in, size_t index, ProcessedHandStateBatch& out);
+#if HAND_STATE_BATCH_SSE2
+size_t ProcessFour(const HandStateBatch& in, size_t index, ProcessedHandStateBatch& out);
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+void HandStateBatch::Reserve(size_t numHands)
+{
+    isLeft.reserve(numHands);
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        palmNormal[axis].reserve(numHands);
+        handDirection[axis].reserve(numHands);
+        for (auto& finger : fingerDirections)
+            finger[axis].reserve(numHands);
+    }
+}
+
+void HandStateBatch::Clear()
+{
+    isLeft.clear();
+    for (size_t axis = 0; axis < 3; axis++)
+    {
+        palmNormal[axis].clear();
+        handDirection[axis].clear();
+        for (auto& finger : fingerDirections)
+            finger[axis].clear();
+    }
+}
+
+void HandStateBatch::Push(const UnprocessedHandState& state)
+{
+    isLeft.push_back(state.isLeft);
+    palmNormal[0].push_back(state.palmNormal.X());
+    palmNormal[1].push_back(state.palmNormal.Y());
+    palmNormal[2].push_back(state.palmNormal.Z());
+    handDirection[0].push_back(state.handDirection.X());
+    handDirection[1].push_back(state.handDirection.Y());
+    handDirection[2].push_back(state.handDirection.Z());
+    for (size_t i = 0; i < fingerDirections.size(); i++)
+    {
+        fingerDirections[i][0].push_back(state.fingerDirections[i].X());
+        fingerDirections[i][1].push_back(state.fingerDirections[i].Y());
+        fingerDirections[i][2].push_back(state.fingerDirections[i].Z());
+    }
+}
+
+UnprocessedHandState HandStateBatch::Get(size_t index) const
+{
+    UnprocessedHandState state{};
+    state.isTracking = true;
+    state.isLeft = isLeft[index];
+    state.palmNormal = Vec3(palmNormal[0][index], palmNormal[1][index], palmNormal[2][index]);
+    state.handDirection =
+        Vec3(handDirection[0][index], handDirection[1][index], handDirection[2][index]);
+    for (size_t i = 0; i < fingerDirections.size(); i++)
+    {
+        state.fingerDirections[i] = Vec3(fingerDirections[i][0][index],
+                                         fingerDirections[i][1][index],
+                                         fingerDirections[i][2][index]);
+    }
+    return state;
+}
+
+void ProcessedHandStateBatch::Resize(size_t numHands)
+{
+    isInClickPose.resize(numHands);
+    cursorDirectionX.resize(numHands);
+    cursorDirectionY.resize(numHands);
+    averageFingerAngle.resize(numHands);
+}
+
+size_t ProcessHandStates(const HandStateBatch& in, ProcessedHandStateBatch& out)
+{
+    out.Resize(in.Size());
+
+    size_t index = 0;
+    size_t numScalar = 0;
+#if HAND_STATE_BATCH_SSE2
+    for (; index + 4 <= in.Size(); index += 4)
+        numScalar += ProcessFour(in, index, out);
+#endif
+    for (; index < in.Size(); index++, numScalar++)
+        ProcessOne(in, index, out);
+    return numScalar;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+void ProcessOne(const HandStateBatch& in, size_t index, ProcessedHandStateBatch& out)
+{
+    UnprocessedHandState state = in.Get(index);
+    const ProcessedHandState processed = ProcessHandState(state);
+    out.isInClickPose[index] = processed.isInClickPose;
+    out.cursorDirectionX[index] = processed.cursorDirectionX;
+    out.cursorDirectionY[index] = processed.cursorDirectionY;
+
+    const bool isMove = !processed.isInClickPose && (processed.cursorDirectionX != 0.0f ||
+                                                     processed.cursorDirectionY != 0.0f);
+    out.averageFingerAngle[index] =
+        isMove ? std::atan2(processed.averageFingerDirectionX * (state.isLeft ? 1.0f : -1.0f),
+                            processed.averageFingerDirectionY)
+               : 0.0f;
+}
+
+#if HAND_STATE_BATCH_SSE2
+
+struct Vec3x4
+{
+    __m128 x, y, z;
+};
+
+Vec3x4 Load(const std::array<std::vector<float>, 3>& component, size_t index)
+{
+    return {_mm_loadu_ps(&component[0][index]), _mm_loadu_ps(&component[1][index]),
+            _mm_loadu_ps(&component[2][index])};
+}
+
+// The arithmetic below is done in the same order as raylib's, so the cone tests come out the same
+__m128 Dot(Vec3x4 a, Vec3x4 b)
+{
+    return _mm_add_ps(_mm_add_ps(_mm_mul_ps(a.x, b.x), _mm_mul_ps(a.y, b.y)),
+                      _mm_mul_ps(a.z, b.z));
+}
+
+Vec3x4 Cross(Vec3x4 a, Vec3x4 b)
+{
+    return {_mm_sub_ps(_mm_mul_ps(a.y, b.z), _mm_mul_ps(a.z, b.y)),
+            _mm_sub_ps(_mm_mul_ps(a.z, b.x), _mm_mul_ps(a.x, b.z)),
+            _mm_sub_ps(_mm_mul_ps(a.x, b.y), _mm_mul_ps(a.y, b.x))};
+}
+
+__m128 Abs(__m128 v) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), v); }
+
+__m128 Select(__m128 mask, __m128 ifTrue, __m128 ifFalse)
+{
+    return _mm_or_ps(_mm_and_ps(mask, ifTrue), _mm_andnot_ps(mask, ifFalse));
+}
+
+/// @brief atan2(y, x) for y >= 0, good to about 1e-7 radians (the Cephes atanf polynomial).
+__m128 Atan2(__m128 y, __m128 x)
+{
+    const __m128 absX = Abs(x);
+    const __m128 isSteep = _mm_cmpgt_ps(y, absX);
+    __m128 t = _mm_div_ps(_mm_min_ps(y, absX), _mm_max_ps(y, absX));
+
+    // atan(t) = pi/4 + atan((t - 1) / (t + 1)) keeps the polynomial's argument under tan(pi/8)
+    const __m128 isBig = _mm_cmpgt_ps(t, _mm_set1_ps(0.41421356f));
+    const __m128 one = _mm_set1_ps(1.0f);
+    t = Select(isBig, _mm_div_ps(_mm_sub_ps(t, one), _mm_add_ps(t, one)), t);
+
+    const __m128 z = _mm_mul_ps(t, t);
+    __m128 p = _mm_set1_ps(8.05374449538e-2f);
+    p = _mm_sub_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.38776856032e-1f));
+    p = _mm_add_ps(_mm_mul_ps(p, z), _mm_set1_ps(1.99777106478e-1f));
+    p = _mm_sub_ps(_mm_mul_ps(p, z), _mm_set1_ps(3.33329491539e-1f));
+    __m128 angle = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(p, z), t), t);
+    angle = _mm_add_ps(angle, _mm_and_ps(isBig, _mm_set1_ps(Math::_PI / 4.0f)));
+
+    angle = Select(isSteep, _mm_sub_ps(_mm_set1_ps(Math::_PI / 2.0f), angle), angle);
+    return Select(_mm_cmplt_ps(x, _mm_setzero_ps()), _mm_sub_ps(_mm_set1_ps(Math::_PI), angle),
+                  angle);
+}
+
+/// @brief Math::Cone::Contains, for the cones of ProcessHandState. dist is the palm normal's
+///        component along the cone's axis.
+///        uncertain gets the lanes too close to the cone's surface to trust.
+__m128 IsInCone(__m128 dist, __m128 magnitudeSquared, __m128& uncertain)
+{
+    static_assert(CLICK_CONE.cosineSquared == LEFT_MOVE_CONE.cosineSquared &&
+                  CLICK_CONE.cosineSquared == RIGHT_MOVE_CONE.cosineSquared);
+    const __m128 distSquared = _mm_mul_ps(dist, dist);
+    const __m128 surfaceSquared =
+        _mm_mul_ps(_mm_set1_ps(CLICK_CONE.cosineSquared), magnitudeSquared);
+
+    const __m128 gap = Abs(_mm_sub_ps(distSquared, surfaceSquared));
+    uncertain = _mm_or_ps(uncertain,
+                          _mm_cmple_ps(gap, _mm_mul_ps(_mm_set1_ps(CONE_MARGIN), surfaceSquared)));
+    return _mm_cmpgt_ps(distSquared, surfaceSquared);
+}
+
+/// @brief The average finger angle, as in ProcessHandState.
+///        fingerUncertain gets the lanes whose cursor direction the approximation can't settle.
+__m128 GetAverageFingerAngle(const HandStateBatch& in, size_t index, Vec3x4 n, Vec3x4 d,
+                             __m128& fingerUncertain)
+{
+    const Vec3x4 bendNormal = Cross(d, n);
+    const __m128 bendNormalSquared = Dot(bendNormal, bendNormal);
+    const __m128 zero = _mm_setzero_ps();
+    fingerUncertain = _mm_cmple_ps(bendNormalSquared, zero);  // and NaNs, below
+    __m128 sumAngle = zero;
+    for (const auto& finger : in.fingerDirections)
+    {
+        const Vec3x4 f = Load(finger, index);
+        const __m128 scale = _mm_div_ps(Dot(f, bendNormal), bendNormalSquared);
+        const Vec3x4 p = {_mm_sub_ps(f.x, _mm_mul_ps(bendNormal.x, scale)),
+                          _mm_sub_ps(f.y, _mm_mul_ps(bendNormal.y, scale)),
+                          _mm_sub_ps(f.z, _mm_mul_ps(bendNormal.z, scale))};
+
+        const Vec3x4 crossDP = Cross(d, p);
+        const __m128 lengthDP = _mm_sqrt_ps(Dot(crossDP, crossDP));
+        const __m128 dotDP = Dot(d, p);
+        const Vec3x4 crossNP = Cross(n, p);
+        const __m128 lengthNP = _mm_sqrt_ps(Dot(crossNP, crossNP));
+        const __m128 dotNP = Dot(n, p);
+
+        // the angle from the palm normal is over 90 degrees exactly when the dot is negative:
+        // such fingers are bent backwards, and count as 0 or 180 degrees
+        const __m128 isBackwards = _mm_cmplt_ps(dotNP, zero);
+        const __m128 isPastRightAngle = _mm_cmplt_ps(dotDP, zero);
+        const __m128 angle =
+            Select(isBackwards, _mm_and_ps(isPastRightAngle, _mm_set1_ps(Math::_PI)),
+                   Atan2(lengthDP, dotDP));
+        sumAngle = _mm_add_ps(sumAngle, angle);
+
+        const __m128 signMargin = _mm_set1_ps(SIGN_MARGIN);
+        fingerUncertain = _mm_or_ps(
+            fingerUncertain, _mm_cmple_ps(Abs(dotNP), _mm_mul_ps(signMargin, lengthNP)));
+        fingerUncertain = _mm_or_ps(
+            fingerUncertain,
+            _mm_and_ps(isBackwards,
+                       _mm_cmple_ps(Abs(dotDP), _mm_mul_ps(signMargin, lengthDP))));
+    }
+    const __m128 averageAngle = _mm_div_ps(sumAngle, _mm_set1_ps(4.0f));
+
+    // the sector is the whole part of averageAngle / SECTOR_ARC_LENGTH. Sectors 2k - 1 and 2k
+    // share a cursor direction, so only the boundaries at odd sectors change the outcome.
+    const __m128 sectors = _mm_div_ps(averageAngle, _mm_set1_ps(SECTOR_ARC_LENGTH));
+    const __m128i nearestBoundary = _mm_cvtps_epi32(sectors);
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128 isOddBoundary =
+        _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(nearestBoundary, one), one));
+    const __m128 boundaryGap = Abs(_mm_sub_ps(sectors, _mm_cvtepi32_ps(nearestBoundary)));
+    fingerUncertain = _mm_or_ps(
+        fingerUncertain,
+        _mm_and_ps(isOddBoundary, _mm_cmple_ps(boundaryGap, _mm_set1_ps(SECTOR_MARGIN))));
+    // out of range, NaN included
+    const __m128 numSectors = _mm_set1_ps(static_cast<float>(NUM_CURSOR_SECTORS));
+    fingerUncertain =
+        _mm_or_ps(fingerUncertain, _mm_or_ps(_mm_cmpnge_ps(sectors, zero),
+                                             _mm_cmpnlt_ps(sectors, numSectors)));
+    return averageAngle;
+}
+
+/// @return How many of the four went through ProcessHandState.
+size_t ProcessFour(const HandStateBatch& in, size_t index, ProcessedHandStateBatch& out)
+{
+    const Vec3x4 n = Load(in.palmNormal, index);
+    const Vec3x4 d = Load(in.handDirection, index);
+    __m128 uncertain = _mm_setzero_ps();
+
+    // click cone around [0, -1, 0], movement cone around [1, 0, 0] for the left hand and
+    // [-1, 0, 0] for the right
+    const __m128 magnitudeSquared = Dot(n, n);
+    const __m128 isClick = IsInCone(n.y, magnitudeSquared, uncertain);
+
+    int32_t isLeftBytes = 0;
+    for (int lane = 0; lane < 4; lane++)
+        isLeftBytes |= (in.isLeft[index + lane] ? 0xFF : 0) << (lane * 8);
+    __m128i isLeftInt = _mm_cvtsi32_si128(isLeftBytes);
+    isLeftInt = _mm_unpacklo_epi8(isLeftInt, isLeftInt);
+    isLeftInt = _mm_unpacklo_epi16(isLeftInt, isLeftInt);
+    const __m128 isLeft = _mm_castsi128_ps(isLeftInt);
+    const __m128 referenceX = Select(isLeft, _mm_set1_ps(1.0f), _mm_set1_ps(-1.0f));
+
+    __m128 sideUncertain = _mm_setzero_ps();
+    const __m128 isMove =
+        _mm_andnot_ps(isClick, IsInCone(n.x, magnitudeSquared, sideUncertain));
+    uncertain = _mm_or_ps(uncertain, _mm_andnot_ps(isClick, sideUncertain));
+
+    // the fingers only matter to hands in the movement pose
+    const int moveBits = _mm_movemask_ps(isMove);
+    __m128 averageAngle = _mm_setzero_ps();
+    if (moveBits != 0)
+    {
+        __m128 fingerUncertain = _mm_setzero_ps();
+        averageAngle = GetAverageFingerAngle(in, index, n, d, fingerUncertain);
+        uncertain = _mm_or_ps(uncertain, _mm_and_ps(isMove, fingerUncertain));
+    }
+
+    alignas(16) float angleLanes[4];
+    alignas(16) float referenceLanes[4];
+    _mm_store_ps(angleLanes, averageAngle);
+    _mm_store_ps(referenceLanes, referenceX);
+    const int clickBits = _mm_movemask_ps(isClick);
+    const int uncertainBits = _mm_movemask_ps(uncertain);
+
+    size_t numScalar = 0;
+    for (int lane = 0; lane < 4; lane++)
+    {
+        const size_t i = index + lane;
+        if (uncertainBits & (1 << lane))
+        {
+            ProcessOne(in, i, out);
+            numScalar++;
+            continue;
+        }
+
+        out.isInClickPose[i] = (clickBits >> lane) & 1;
+        if (moveBits & (1 << lane))
+        {
+            // the same division and truncation as the uncertainty check made
+            const int sector = static_cast<int>(angleLanes[lane] / SECTOR_ARC_LENGTH);
+            out.cursorDirectionX[i] = CURSOR_DIRECTIONS[sector].x * referenceLanes[lane];
+            out.cursorDirectionY[i] = CURSOR_DIRECTIONS[sector].y;
+            out.averageFingerAngle[i] = angleLanes[lane];
+        }
+        else
+        {
+            out.cursorDirectionX[i] = 0.0f;
+            out.cursorDirectionY[i] = 0.0f;
+            out.averageFingerAngle[i] = 0.0f;
+        }
+    }
+    return numScalar;
+}
+
+#endif
+
+}  // namespace Input::Leap
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "LeapMotionGestureProvider.hpp"
+
+namespace Input::Leap
+{
+
+/// @brief Many UnprocessedHandStates, stored as one array per component (structure of arrays)
+///        so that ProcessHandStates can load four hands' worth of a component at once.
+///        isTracking isn't kept; every hand in a batch is taken to be tracked.
+struct HandStateBatch
+{
+    std::vector<uint8_t> isLeft;
+    std::array<std::vector<float>, 3> palmNormal;     // [x, y, z][hand]
+    std::array<std::vector<float>, 3> handDirection;  // [x, y, z][hand]
+    std::array<std::array<std::vector<float>, 3>, 4> fingerDirections;  // [finger][x, y, z][hand]
+
+    size_t Size() const { return isLeft.size(); }
+    void Reserve(size_t numHands);
+    void Clear();
+    void Push(const UnprocessedHandState& state);
+    UnprocessedHandState Get(size_t index) const;
+};
+
+/// @brief ProcessedHandStates for a batch, one array per field.
+///        The debug-only average finger direction is kept as the angle it comes from;
+///        it is sin(angle) * (isLeft ? 1 : -1), cos(angle) in ProcessedHandState.
+struct ProcessedHandStateBatch
+{
+    std::vector<uint8_t> isInClickPose;
+    std::vector<float> cursorDirectionX;
+    std::vector<float> cursorDirectionY;
+    std::vector<float> averageFingerAngle;  // 0 unless the hand is in the movement pose
+
+    size_t Size() const { return isInClickPose.size(); }
+    void Resize(size_t numHands);
+};
+
+/// @brief ProcessHandState for every hand in the batch, four at a time with SSE2 where the
+///        target has it. Click and movement poses and cursor directions come out bit-identical
+///        to ProcessHandState's. The SSE2 path approximates the finger angles, so hands that land
+///        too close to a cone or sector boundary for that to be safe go through ProcessHandState.
+/// @return How many hands went through ProcessHandState, for benchmarks.
+size_t ProcessHandStates(const HandStateBatch& in, ProcessedHandStateBatch& out);
+
+}  // namespace Input::Leap
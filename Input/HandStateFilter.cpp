@@ -0,0 +1,331 @@
+#include "HandStateFilter.hpp"
+
+#include <Math/MathHelpers.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace Input::Leap
+{
+
+using Vec3 = Math::Vector3Common;
+
+// The lag isn't measured while the palm normal turns slower than this, in units per second
+// (about 17 degrees per second): jitter would swamp the motion.
+constexpr double MIN_LAG_RATE = 0.3;
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+FilterChannels ToChannels(const UnprocessedHandState& state);
+void FromChannels(const FilterChannels& channels, UnprocessedHandState& state);
+Vec3 GetDirection(const FilterChannels& channels, size_t direction);
+float GetSmoothingFactor(float cutoffHz, float seconds);
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+std::optional<HandFilterType> ParseHandFilterType(std::string_view name)
+{
+    if (name == "none")
+        return HandFilterType::None;
+    if (name == "one-euro")
+        return HandFilterType::OneEuro;
+    if (name == "kalman")
+        return HandFilterType::Kalman;
+    return std::nullopt;
+}
+
+const char* GetHandFilterName(HandFilterType type)
+{
+    switch (type)
+    {
+        case HandFilterType::OneEuro:
+            return "one-euro";
+        case HandFilterType::Kalman:
+            return "kalman";
+        default:
+            return "none";
+    }
+}
+
+OneEuroFilter::OneEuroFilter(const OneEuroParams& params)
+    : m_params(params), m_hasPrevious(false), m_value{}, m_rate{}
+{
+}
+
+void OneEuroFilter::Reset() { m_hasPrevious = false; }
+
+void OneEuroFilter::Filter(FilterChannels& channels, float frameSeconds)
+{
+    if (!m_hasPrevious)
+    {
+        m_value = channels;
+        m_rate.fill(0.0f);
+        m_hasPrevious = true;
+        return;
+    }
+
+    // a frame with the same timestamp as the last one has nothing new to say
+    if (frameSeconds <= 0.0f)
+    {
+        channels = m_value;
+        return;
+    }
+
+    const float rateSmoothing = GetSmoothingFactor(m_params.derivativeCutoffHz, frameSeconds);
+    for (size_t i = 0; i < NUM_FILTER_CHANNELS; i++)
+    {
+        const float rate = (channels[i] - m_value[i]) / frameSeconds;
+        m_rate[i] += rateSmoothing * (rate - m_rate[i]);
+
+        const float cutoffHz = m_params.minCutoffHz + m_params.beta * std::abs(m_rate[i]);
+        m_value[i] += GetSmoothingFactor(cutoffHz, frameSeconds) * (channels[i] - m_value[i]);
+        channels[i] = m_value[i];
+    }
+}
+
+KalmanFilter::KalmanFilter(const KalmanParams& params)
+    : m_params(params),
+      m_hasPrevious(false),
+      m_value{},
+      m_rate{},
+      m_valueVariance{},
+      m_covariance{},
+      m_rateVariance{}
+{
+}
+
+void KalmanFilter::Reset() { m_hasPrevious = false; }
+
+void KalmanFilter::Filter(FilterChannels& channels, float frameSeconds)
+{
+    if (!m_hasPrevious)
+    {
+        m_value = channels;
+        m_rate.fill(0.0f);
+        m_valueVariance.fill(m_params.measurementNoise);
+        m_covariance.fill(0.0f);
+        m_rateVariance.fill(m_params.initialRateVariance);
+        m_hasPrevious = true;
+        return;
+    }
+
+    // the process noise of a rate disturbed by white noise, integrated over the frame
+    const float dt = std::max(frameSeconds, 0.0f);
+    const float q = m_params.rateNoise;
+    const float valueNoise = q * dt * dt * dt / 3.0f;
+    const float covarianceNoise = q * dt * dt / 2.0f;
+    const float rateNoise = q * dt;
+
+    for (size_t i = 0; i < NUM_FILTER_CHANNELS; i++)
+    {
+        // predict
+        m_value[i] += m_rate[i] * dt;
+        m_valueVariance[i] += dt * (2.0f * m_covariance[i] + dt * m_rateVariance[i]) + valueNoise;
+        m_covariance[i] += dt * m_rateVariance[i] + covarianceNoise;
+        m_rateVariance[i] += rateNoise;
+
+        // update, with the value as the only thing measured
+        const float innovation = channels[i] - m_value[i];
+        const float innovationVariance = m_valueVariance[i] + m_params.measurementNoise;
+        const float valueGain = m_valueVariance[i] / innovationVariance;
+        const float rateGain = m_covariance[i] / innovationVariance;
+        m_value[i] += valueGain * innovation;
+        m_rate[i] += rateGain * innovation;
+        m_rateVariance[i] -= rateGain * m_covariance[i];
+        m_valueVariance[i] *= 1.0f - valueGain;
+        m_covariance[i] *= 1.0f - valueGain;
+
+        channels[i] = m_value[i];
+    }
+}
+
+std::unique_ptr<HandFilter> MakeHandFilter(HandFilterType type)
+{
+    switch (type)
+    {
+        case HandFilterType::OneEuro:
+            return std::make_unique<OneEuroFilter>();
+        case HandFilterType::Kalman:
+            return std::make_unique<KalmanFilter>();
+        default:
+            return nullptr;
+    }
+}
+
+double HandFilterStats::GetMeanLagSeconds() const
+{
+    return numLagFrames > 0 ? totalLagSeconds / static_cast<double>(numLagFrames) : 0.0;
+}
+
+HandFilterStage::HandFilterStage(const HandFilterConfig& config)
+    : m_filter(MakeHandFilter(config.type)),
+      m_lagBudgetSeconds(config.lagBudgetSeconds),
+      m_isLeft(false),
+      m_history{},
+      m_historyHead(0),
+      m_historySize(0),
+      m_stats{}
+{
+}
+
+void HandFilterStage::Process(UnprocessedHandState& state, float frameSeconds)
+{
+    if (!m_filter)
+        return;
+
+    FilterChannels channels = ToChannels(state);
+    const bool isFinite = std::all_of(channels.begin(), channels.end(),
+                                      [](float channel) { return std::isfinite(channel); });
+    if (!isFinite)
+    {
+        // ProcessHandState gets to deal with it as it is, and the filter isn't poisoned
+        Reset();
+        return;
+    }
+    if (m_historySize > 0 && state.isLeft != m_isLeft)
+        Reset();
+    m_isLeft = state.isLeft;
+
+    const Vec3 rawPalmNormal = state.palmNormal;
+    double seconds = 0.0;
+    if (m_historySize > 0)
+    {
+        const HistoryEntry& last =
+            m_history[(m_historyHead + FILTER_HISTORY_SIZE - 1) % FILTER_HISTORY_SIZE];
+        seconds = last.seconds + frameSeconds;
+        m_stats.rawPathLength += Vec3::Subtract(rawPalmNormal, last.rawPalmNormal).Magnitude();
+    }
+    m_history[m_historyHead] = {seconds, rawPalmNormal};
+    m_historyHead = (m_historyHead + 1) % FILTER_HISTORY_SIZE;
+    m_historySize = std::min(m_historySize + 1, FILTER_HISTORY_SIZE);
+
+    const auto start = std::chrono::steady_clock::now();
+    m_filter->Filter(channels, frameSeconds);
+    FromChannels(channels, state);
+    const auto filterTime = std::chrono::steady_clock::now() - start;
+
+    m_stats.numFrames++;
+    m_stats.totalFilterTime += filterTime;
+    m_stats.maxFilterTime = std::max<std::chrono::nanoseconds>(m_stats.maxFilterTime, filterTime);
+    if (m_historySize > 1)
+    {
+        m_stats.filteredPathLength +=
+            Vec3::Subtract(state.palmNormal, m_lastFilteredPalmNormal).Magnitude();
+    }
+    m_lastFilteredPalmNormal = state.palmNormal;
+
+    if (const std::optional<double> lag = MeasureLag(state.palmNormal))
+    {
+        m_stats.numLagFrames++;
+        m_stats.totalLagSeconds += *lag;
+        m_stats.maxLagSeconds = std::max(m_stats.maxLagSeconds, *lag);
+        if (*lag > m_lagBudgetSeconds)
+            m_stats.numFramesOverBudget++;
+    }
+}
+
+void HandFilterStage::Reset()
+{
+    if (!m_filter)
+        return;
+    m_filter->Reset();
+    if (m_historySize > 0)
+        m_stats.numResets++;
+    m_historyHead = 0;
+    m_historySize = 0;
+}
+
+std::optional<double> HandFilterStage::MeasureLag(Math::Vector3Common filteredPalmNormal) const
+{
+    if (m_historySize < FILTER_HISTORY_SIZE)
+        return std::nullopt;
+
+    // A straight line fitted through the history stands in for where the palm normal really is
+    // now, without the jitter. The lag is how far the filtered palm normal is behind that,
+    // along the line, over how fast the line moves.
+    double meanSeconds = 0.0;
+    std::array<double, 3> mean{};
+    for (const HistoryEntry& entry : m_history)
+    {
+        meanSeconds += entry.seconds;
+        mean[0] += entry.rawPalmNormal.X();
+        mean[1] += entry.rawPalmNormal.Y();
+        mean[2] += entry.rawPalmNormal.Z();
+    }
+    meanSeconds /= FILTER_HISTORY_SIZE;
+    for (double& component : mean)
+        component /= FILTER_HISTORY_SIZE;
+
+    double secondsVariance = 0.0;
+    std::array<double, 3> slope{};
+    for (const HistoryEntry& entry : m_history)
+    {
+        const double t = entry.seconds - meanSeconds;
+        secondsVariance += t * t;
+        slope[0] += t * (entry.rawPalmNormal.X() - mean[0]);
+        slope[1] += t * (entry.rawPalmNormal.Y() - mean[1]);
+        slope[2] += t * (entry.rawPalmNormal.Z() - mean[2]);
+    }
+    if (secondsVariance <= 0.0)
+        return std::nullopt;
+    for (double& component : slope)
+        component /= secondsVariance;
+
+    const double rateSquared = slope[0] * slope[0] + slope[1] * slope[1] + slope[2] * slope[2];
+    if (rateSquared < MIN_LAG_RATE * MIN_LAG_RATE)
+        return std::nullopt;
+
+    const HistoryEntry& newest =
+        m_history[(m_historyHead + FILTER_HISTORY_SIZE - 1) % FILTER_HISTORY_SIZE];
+    const std::array<double, 3> filtered = {filteredPalmNormal.X(), filteredPalmNormal.Y(),
+                                            filteredPalmNormal.Z()};
+    double behind = 0.0;
+    for (size_t i = 0; i < 3; i++)
+    {
+        const double fitted = mean[i] + slope[i] * (newest.seconds - meanSeconds);
+        behind += (fitted - filtered[i]) * slope[i];
+    }
+    return behind / rateSquared;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+FilterChannels ToChannels(const UnprocessedHandState& state)
+{
+    FilterChannels channels;
+    auto put = [&channels](size_t direction, const Vec3& vec)
+    {
+        channels[direction * 3] = vec.X();
+        channels[direction * 3 + 1] = vec.Y();
+        channels[direction * 3 + 2] = vec.Z();
+    };
+    put(0, state.palmNormal);
+    put(1, state.handDirection);
+    for (size_t finger = 0; finger < state.fingerDirections.size(); finger++)
+        put(finger + 2, state.fingerDirections[finger]);
+    return channels;
+}
+
+void FromChannels(const FilterChannels& channels, UnprocessedHandState& state)
+{
+    // smoothing shortens the directions when they turn, so they are made unit length again
+    state.palmNormal = Vec3::Normalize(GetDirection(channels, 0));
+    state.handDirection = Vec3::Normalize(GetDirection(channels, 1));
+    for (size_t finger = 0; finger < state.fingerDirections.size(); finger++)
+        state.fingerDirections[finger] = Vec3::Normalize(GetDirection(channels, finger + 2));
+}
+
+Vec3 GetDirection(const FilterChannels& channels, size_t direction)
+{
+    return Vec3(channels[direction * 3], channels[direction * 3 + 1], channels[direction * 3 + 2]);
+}
+
+float GetSmoothingFactor(float cutoffHz, float seconds)
+{
+    const float timeConstant = 1.0f / (2.0f * Math::_PI * cutoffHz);
+    return 1.0f / (1.0f + timeConstant / seconds);
+}
+
+}  // namespace Input::Leap
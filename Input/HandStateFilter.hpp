@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "LeapMotionGestureProvider.hpp"
+
+namespace Input::Leap
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Temporal filtering
+///////////////////////////////////////////////////////////////////////////////
+//
+// ProcessHandState judges every frame on its own, so tracking jitter on a hand held near the edge
+// of a cone or a sector makes the pose and the cursor direction flicker from frame to frame.
+// A HandFilterStage sits between ToUnprocessedHandState and ProcessHandState and smooths the
+// directions ProcessHandState reads with a HandFilter. Smoothing costs responsiveness: the
+// filtered hand trails the real one, and the stage measures by how much.
+
+/// @brief The directions a HandFilter smooths, x, y and z of each in turn: the palm normal, the
+///        hand direction (the finger angle is measured against it), then the four fingers.
+constexpr size_t NUM_FILTERED_DIRECTIONS = 6;
+constexpr size_t NUM_FILTER_CHANNELS = NUM_FILTERED_DIRECTIONS * 3;
+using FilterChannels = std::array<float, NUM_FILTER_CHANNELS>;
+
+/// @brief How many of the latest frames a HandFilterStage keeps to measure its lag against.
+constexpr size_t FILTER_HISTORY_SIZE = 16;
+
+enum class HandFilterType
+{
+    None,
+    OneEuro,
+    Kalman
+};
+
+/// @return The type called "none", "one-euro" or "kalman", or nothing if it's none of those.
+std::optional<HandFilterType> ParseHandFilterType(std::string_view name);
+
+const char* GetHandFilterName(HandFilterType type);
+
+struct HandFilterConfig
+{
+    HandFilterType type = HandFilterType::None;
+
+    /// @brief Frames where the filtered hand trails the real one by more than this are counted,
+    ///        see HandFilterStats::numFramesOverBudget.
+    float lagBudgetSeconds = 0.03f;
+};
+
+/// @brief Smooths a stream of hands, every channel on its own.
+class HandFilter
+{
+   public:
+    virtual ~HandFilter() = default;
+
+    /// @brief Forgets every frame so far. The next frame passes through unchanged.
+    virtual void Reset() = 0;
+
+    /// @brief Filters the next frame in place.
+    /// @param frameSeconds Time since the previous frame.
+    virtual void Filter(FilterChannels& channels, float frameSeconds) = 0;
+};
+
+struct OneEuroParams
+{
+    float minCutoffHz = 1.0f;         // the cutoff of a channel that isn't changing
+    float beta = 4.0f;                // how much the cutoff rises per unit per second
+    float derivativeCutoffHz = 1.0f;  // for the rate of change that drives the cutoff
+};
+
+/// @brief The 1€ filter (Casiez et al., 2012): a low-pass filter whose cutoff rises with how fast
+///        the channel changes, so a still hand is smoothed hard and a moving one hardly at all.
+class OneEuroFilter : public HandFilter
+{
+   public:
+    explicit OneEuroFilter(const OneEuroParams& params = OneEuroParams{});
+
+    void Reset() override;
+    void Filter(FilterChannels& channels, float frameSeconds) override;
+
+   private:
+    OneEuroParams m_params;
+    bool m_hasPrevious;
+    FilterChannels m_value;
+    FilterChannels m_rate;
+};
+
+struct KalmanParams
+{
+    float rateNoise = 4.0f;            // spectral density of the changes of rate, /s^3
+    float measurementNoise = 1e-3f;    // variance of a tracked value
+    float initialRateVariance = 1.0f;  // /s^2, how fast the hand might be turning at first
+};
+
+/// @brief A Kalman filter per channel that models it as changing at a steady rate, disturbed by
+///        random changes of rate. Unlike a low-pass filter it doesn't trail a steady turn of the
+///        hand, but it overshoots when the hand stops turning.
+class KalmanFilter : public HandFilter
+{
+   public:
+    explicit KalmanFilter(const KalmanParams& params = KalmanParams{});
+
+    void Reset() override;
+    void Filter(FilterChannels& channels, float frameSeconds) override;
+
+   private:
+    KalmanParams m_params;
+    bool m_hasPrevious;
+    FilterChannels m_value;
+    FilterChannels m_rate;
+    // the covariance of each channel's value and rate
+    FilterChannels m_valueVariance;
+    FilterChannels m_covariance;
+    FilterChannels m_rateVariance;
+};
+
+/// @return The filter of the given type with its default parameters, nullptr for None.
+std::unique_ptr<HandFilter> MakeHandFilter(HandFilterType type);
+
+struct HandFilterStats
+{
+    uint64_t numFrames;
+    uint64_t numResets;  // of a filter that had seen a frame
+
+    // The lag is how many seconds of the palm normal's recent motion the filtered palm normal is
+    // behind by. It is only measured while the palm is turning fast enough for that to mean much.
+    uint64_t numLagFrames;
+    uint64_t numFramesOverBudget;
+    double totalLagSeconds;
+    double maxLagSeconds;
+
+    // how far the palm normal travelled, before and after filtering: less is smoother
+    double rawPathLength;
+    double filteredPathLength;
+
+    std::chrono::nanoseconds totalFilterTime;
+    std::chrono::nanoseconds maxFilterTime;
+
+    double GetMeanLagSeconds() const;
+};
+
+/// @brief Runs a HandFilter over the driver's hands, and measures how far behind it leaves them
+///        and how long it takes.
+class HandFilterStage
+{
+   public:
+    explicit HandFilterStage(const HandFilterConfig& config);
+
+    bool IsEnabled() const { return m_filter != nullptr; }
+
+    /// @brief Filters the hand in place, unless the stage is disabled. A hand that isn't the
+    ///        same hand as the last one, or that has a non-finite direction, resets the filter.
+    void Process(UnprocessedHandState& state, float frameSeconds);
+
+    /// @brief Call when frames stop coming in order, like when the hand is lost.
+    void Reset();
+
+    const HandFilterStats& GetStats() const { return m_stats; }
+
+   private:
+    struct HistoryEntry
+    {
+        double seconds;  // since the last reset
+        Math::Vector3Common rawPalmNormal;
+    };
+
+    std::unique_ptr<HandFilter> m_filter;
+    const float m_lagBudgetSeconds;
+
+    bool m_isLeft;
+    std::array<HistoryEntry, FILTER_HISTORY_SIZE> m_history;
+    size_t m_historyHead;  // the slot the next frame goes in
+    size_t m_historySize;
+    Math::Vector3Common m_lastFilteredPalmNormal;
+
+    HandFilterStats m_stats;
+
+    /// @return How many seconds the filtered palm normal is behind, if the palm is turning.
+    std::optional<double> MeasureLag(Math::Vector3Common filteredPalmNormal) const;
+};
+
+}  // namespace Input::Leap
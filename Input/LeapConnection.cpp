@@ -1,5 +1,6 @@
 #include "LeapConnection.hpp"
 
+#include <algorithm>
 #include <format>
 #include <iostream>
 #include <stdexcept>
@@ -76,9 +77,6 @@ LeapConnection::LeapConnection()
 
     m_isRunning = true;
 
-    m_lastFrame = static_cast<LEAP_TRACKING_EVENT*>(malloc(sizeof(LEAP_TRACKING_EVENT)));
-    *m_lastFrame = {};
-
     m_lastDevice = static_cast<LEAP_DEVICE_INFO*>(malloc(sizeof(LEAP_DEVICE_INFO)));
     *m_lastDevice = {};
 
@@ -90,20 +88,68 @@ LeapConnection::~LeapConnection()
     m_isRunning = false;
     LeapCloseConnection(m_connection);
     m_pollingThread.join();
+    StopRecording();
     LeapDestroyConnection(m_connection);
     m_isInitialized = false;
 }
 
 bool LeapConnection::IsConnected() const { return m_isConnected; }
 
-LEAP_TRACKING_EVENT* LeapConnection::GetFrame() const
+TrackingFrame LeapConnection::GetFrame() const { return m_lastFrame.Load(); }
+
+uint64_t LeapConnection::GetFrameSequence() const { return m_lastFrame.GetSequence(); }
+
+uint64_t LeapConnection::WaitForFrame(uint64_t sequence)
 {
-    LEAP_TRACKING_EVENT* currentFrame;
-    {
-        std::lock_guard<std::mutex> guard(m_dataLock);
-        currentFrame = m_lastFrame;
-    }
-    return currentFrame;
+    return m_lastFrame.WaitForNewer(sequence);
+}
+
+void LeapConnection::WakeFrameWaiters() { m_lastFrame.WakeWaiters(); }
+
+bool LeapConnection::StartRecording(const std::string& filename)
+{
+    std::lock_guard<std::mutex> guard(m_recorderLock);
+    if (m_recorder)
+        StopRecordingLocked();
+
+    // the file is created and mapped before the polling thread ever sees the recorder
+    auto recorder = std::make_unique<FrameRecorder>();
+    if (!recorder->Start(filename))
+        return false;
+    m_recorder = std::move(recorder);
+    m_activeRecorder.store(m_recorder.get(), std::memory_order_seq_cst);
+    std::cout << "[Leap Motion] Recording frames to " << filename << ".\n";
+    return true;
+}
+
+void LeapConnection::StopRecording()
+{
+    std::lock_guard<std::mutex> guard(m_recorderLock);
+    if (m_recorder)
+        StopRecordingLocked();
+}
+
+bool LeapConnection::IsRecording() const
+{
+    return m_activeRecorder.load(std::memory_order_acquire) != nullptr;
+}
+
+void LeapConnection::StopRecordingLocked()
+{
+    // Once the recorder is taken out of m_activeRecorder, the polling thread can't start using
+    // it again (SetFrame checks again after marking it in use), so it's only left to wait out
+    // a frame it's already recording: a few microseconds.
+    FrameRecorder* recorder = m_activeRecorder.exchange(nullptr, std::memory_order_seq_cst);
+    while (m_recorderInUse.load(std::memory_order_seq_cst) == recorder)
+        std::this_thread::yield();
+
+    const FrameRecorder::Stats stats = m_recorder->Stop();
+    m_recorder.reset();
+    const int64_t meanNanos =
+        stats.numFrames > 0 ? stats.totalNanos / static_cast<int64_t>(stats.numFrames) : 0;
+    std::cout << std::format(
+        "[Leap Motion] Recorded {} frames ({} dropped), {}ns per frame on average, {}ns at most.\n",
+        stats.numFrames, stats.numDropped, meanNanos, stats.maxNanos);
 }
 
 LEAP_DEVICE_INFO* LeapConnection::GetDeviceProperties() const
@@ -132,8 +178,24 @@ void LeapConnection::SetDevice(const LEAP_DEVICE_INFO* deviceProps)
 
 void LeapConnection::SetFrame(const LEAP_TRACKING_EVENT* frame)
 {
-    std::lock_guard<std::mutex> guard(m_dataLock);
-    *m_lastFrame = *frame;
+    TrackingFrame copy{};
+    copy.receivedMicros = LeapGetNow();
+    copy.trackingFrameId = frame->tracking_frame_id;
+    copy.timestampMicros = frame->info.timestamp;
+    copy.framerate = frame->framerate;
+    copy.nHands = std::min(frame->nHands, MAX_TRACKED_HANDS);
+    std::copy_n(frame->pHands, copy.nHands, copy.hands.begin());
+    m_lastFrame.Publish(copy);
+
+    FrameRecorder* recorder = m_activeRecorder.load(std::memory_order_seq_cst);
+    if (recorder == nullptr)
+        return;
+    // marked in use before checking it's still active, so StopRecordingLocked either sees the
+    // mark and waits, or took the recorder away first and this sees that
+    m_recorderInUse.store(recorder, std::memory_order_seq_cst);
+    if (m_activeRecorder.load(std::memory_order_seq_cst) == recorder)
+        recorder->Record(*frame);
+    m_recorderInUse.store(nullptr, std::memory_order_seq_cst);
 }
 
 void LeapConnection::MessageLoop()
@@ -221,7 +283,11 @@ bool LeapConnection::m_isInitialized = false;
 bool LeapConnection::m_isConnected = false;
 volatile bool LeapConnection::m_isRunning = false;
 LEAP_CONNECTION LeapConnection::m_connection{};
-LEAP_TRACKING_EVENT* LeapConnection::m_lastFrame = nullptr;
+FrameSlot LeapConnection::m_lastFrame{};
+std::unique_ptr<FrameRecorder> LeapConnection::m_recorder{};
+std::atomic<FrameRecorder*> LeapConnection::m_activeRecorder{nullptr};
+std::atomic<FrameRecorder*> LeapConnection::m_recorderInUse{nullptr};
+std::mutex LeapConnection::m_recorderLock{};
 LEAP_DEVICE_INFO* LeapConnection::m_lastDevice = nullptr;
 std::thread LeapConnection::m_pollingThread{};
 std::mutex LeapConnection::m_dataLock{};
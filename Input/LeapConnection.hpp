@@ -2,10 +2,15 @@
 
 #include <LeapC.h>
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <thread>
 
+#include "FrameRecorder.hpp"
+#include "FrameSource.hpp"
+
 namespace Input::Leap
 {
 
@@ -25,7 +30,7 @@ void DebugPrint(const std::string &message);
 std::string GetEnumString(eLeapRS res);
 
 /// @brief Singleton that encapsulates a connection to a Leap Motion device.
-class LeapConnection
+class LeapConnection : public FrameSource
 {
    public:
     /// @brief RAII initializer for a Leap Motion connection.
@@ -35,10 +40,20 @@ class LeapConnection
     virtual ~LeapConnection();
 
     /// @brief Is the connection to the device valid?
-    bool IsConnected() const;
+    bool IsConnected() const override;
+
+    TrackingFrame GetFrame() const override;
+    uint64_t GetFrameSequence() const override;
+    uint64_t WaitForFrame(uint64_t sequence) override;
+    void WakeFrameWaiters() override;
 
-    /// @brief Returns the current frame obtained by the Leap Motion device.
-    LEAP_TRACKING_EVENT *GetFrame() const;
+    /// @brief Frames are recorded by the polling thread as they arrive, see FrameRecorder.
+    ///        Creating and closing the capture is done on the calling thread; the polling thread
+    ///        never waits for it.
+    bool CanRecord() const override { return true; }
+    bool StartRecording(const std::string &filename) override;
+    void StopRecording() override;
+    bool IsRecording() const override;
 
     /// @brief Returns a struct containing information about the Leap Motion device.
     LEAP_DEVICE_INFO *GetDeviceProperties() const;
@@ -51,7 +66,14 @@ class LeapConnection
     static bool m_isConnected;
     static volatile bool m_isRunning;
     static LEAP_CONNECTION m_connection;
-    static LEAP_TRACKING_EVENT *m_lastFrame;
+    static FrameSlot m_lastFrame;  // published to by the polling thread only
+    // The recorder is made and started under m_recorderLock, then handed to the polling thread
+    // through m_activeRecorder, which it checks without locking. m_recorderInUse is the
+    // recorder the polling thread is writing to, if any, so it can be taken back safely.
+    static std::unique_ptr<FrameRecorder> m_recorder;
+    static std::atomic<FrameRecorder *> m_activeRecorder;
+    static std::atomic<FrameRecorder *> m_recorderInUse;
+    static std::mutex m_recorderLock;  // never taken by the polling thread
     static LEAP_DEVICE_INFO *m_lastDevice;
     static std::thread m_pollingThread;
     static std::mutex m_dataLock;
@@ -60,6 +82,10 @@ class LeapConnection
     static void SetDevice(const LEAP_DEVICE_INFO *deviceProps);
     static void SetFrame(const LEAP_TRACKING_EVENT *frame);
 
+    // Takes the recorder back from the polling thread, stops it and prints how the recording
+    // went. m_recorderLock must be held.
+    static void StopRecordingLocked();
+
     // The actual message loop that the Leap Motion device "posts to."
     static void MessageLoop();
 
@@ -8,31 +8,39 @@ using Vec3 = Math::Vector3Common;
 namespace Input::Leap
 {
 
-ProcessedHandState ProcessHandState(UnprocessedHandState& inState)
+// the cones and cursor directions are worked out by the compiler
+static_assert(CLICK_CONE.Contains(Vec3{0.0f, -1.0f, 0.0f}) &&
+              CLICK_CONE.Contains(Vec3{0.0f, 1.0f, 0.0f}) &&
+              !CLICK_CONE.Contains(Vec3{0.0f, -1.0f, 1.0f}));
+static_assert(CURSOR_DIRECTIONS[0].x == 0.0f && CURSOR_DIRECTIONS[0].y == 1.0f &&
+              CURSOR_DIRECTIONS[NUM_CURSOR_SECTORS - 1].y == -1.0f);
+
+UnprocessedHandState ToUnprocessedHandState(const LEAP_HAND& hand)
 {
-    ProcessedHandState outState{};
-
-    // check if the hand is in the click pose
-    Vec3 palmNormal = inState.palmNormal;
-
-    outState.isInClickPose =
-        Math::IsVectorInCone(Vec3{0.0f, -1.0f, 0.0f}, TOLERANCE_CONE_ANGLE_RADIANS, palmNormal);
-
-    // if true return
-    // click pose and mouse pose are mutually exclusive
-    if (outState.isInClickPose) return outState;
+    UnprocessedHandState state{};
+    state.isTracking = true;
+    state.isLeft = hand.type == eLeapHandType_Left;
+    state.palmNormal = Vec3(hand.palm.normal);
+    state.handDirection = Vec3(hand.palm.direction);
 
-    // else check if the hand is in the cursor movement pose
-    Vec3 referenceVec = inState.isLeft ? Vec3{1.0f, 0.0f, 0.0f} : Vec3{-1.0f, 0.0f, 0.0f};
+    for (int i = 1; i < 5; i++)
+    {
+        const LEAP_DIGIT& finger = hand.digits[i];
+        Vec3 distalTip(finger.distal.next_joint);
+        Vec3 distalBase(finger.distal.prev_joint);
 
-    if (!Math::IsVectorInCone(referenceVec, TOLERANCE_CONE_ANGLE_RADIANS, palmNormal))
-        return outState;
+        // direction of the distal bone of the finger
+        state.fingerDirections[i - 1] = Vec3::Subtract(distalTip, distalBase);
+    }
+    return state;
+}
 
+float GetAverageFingerAngle(const UnprocessedHandState& inState)
+{
     // calculate finger angles
     Vec3 fingerBendPlaneNormal = Vec3::CrossProduct(inState.handDirection, inState.palmNormal);
 
     float averageAngle = 0.0f;
-    float averageSigningAngle = 0.0f;
     for (auto dir : inState.fingerDirections)
     {
         Vec3 projectedDir = Vec3::ProjectOntoPlane(dir, fingerBendPlaneNormal);
@@ -63,25 +71,34 @@ ProcessedHandState ProcessHandState(UnprocessedHandState& inState)
 
     // calculate average finger angle
     averageAngle /= inState.fingerDirections.size();
+    return averageAngle;
+}
+
+ProcessedHandState ProcessHandState(UnprocessedHandState& inState)
+{
+    ProcessedHandState outState{};
+
+    // check if the hand is in the click pose
+    Vec3 palmNormal = inState.palmNormal;
+
+    outState.isInClickPose = CLICK_CONE.Contains(palmNormal);
+
+    // if true return
+    // click pose and mouse pose are mutually exclusive
+    if (outState.isInClickPose) return outState;
+
+    // else check if the hand is in the cursor movement pose
+    const Math::Cone& moveCone = inState.isLeft ? LEFT_MOVE_CONE : RIGHT_MOVE_CONE;
+    Vec3 referenceVec = moveCone.axis;
+
+    if (!moveCone.Contains(palmNormal)) return outState;
+
+    float averageAngle = GetAverageFingerAngle(inState);
 
     // calculate cursor direction
-    constexpr int numCursorDirections = 8;                              // a.k.a. N
-    constexpr int numSectors = 2 * numCursorDirections;                 // a.k.a. 2N
-    constexpr float sectorArcLength = Math::_PI / numCursorDirections;  // a.k.a. phi = 2pi / 2N
-
-    // find the index of the sector that averageAngle is currently in,
-    // which is the integer part of averageAngle / sectorArcLength
-    int sectorIndex = static_cast<int>(averageAngle / sectorArcLength);
-
-    // {-1, 0} => 0phi
-    // {1, 2} => 2phi
-    // {3, 4} => 4phi
-    // etc...
-    // integer division means these factors do NOT cancel out
-    int scaleFactor = ((sectorIndex + 1) / 2) * 2;
-
-    outState.cursorDirectionX = std::sin(scaleFactor * sectorArcLength) * referenceVec.X();
-    outState.cursorDirectionY = std::cos(scaleFactor * sectorArcLength);
+    const CursorDirection& direction = CURSOR_DIRECTIONS[GetCursorSector(averageAngle)];
+    outState.cursorDirectionX = direction.x * referenceVec.X();
+    outState.cursorDirectionY = direction.y;
 
     outState.averageFingerDirectionX = std::sin(averageAngle) * referenceVec.X();
     outState.averageFingerDirectionY = std::cos(averageAngle);
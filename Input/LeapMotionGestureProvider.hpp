@@ -2,6 +2,7 @@
 
 #include <LeapC.h>
 
+#include <Math/ConstexprMath.hpp>
 #include <Math/MathHelpers.hpp>
 #include <Math/Vector3Common.hpp>
 #include <array>
@@ -16,6 +17,21 @@ namespace Input::Leap
 constexpr float TOLERANCE_CONE_ANGLE_DEGREES = 25.0f;
 constexpr float TOLERANCE_CONE_ANGLE_RADIANS = TOLERANCE_CONE_ANGLE_DEGREES * Math::DEG_TO_RAD;
 
+/// @brief How many directions the cursor can move in. Each hand covers half of them.
+constexpr int NUM_CURSOR_DIRECTIONS = 8;
+
+/// @brief The range of finger angles in a sector: half the angle between cursor directions.
+constexpr float CURSOR_SECTOR_ARC_LENGTH = Math::_PI / NUM_CURSOR_DIRECTIONS;
+
+/// @brief The cones ProcessHandState tests the palm normal against.
+///        The movement cone of the right hand points the other way.
+constexpr Math::Cone CLICK_CONE(Math::Vector3Common{0.0f, -1.0f, 0.0f},
+                                TOLERANCE_CONE_ANGLE_RADIANS);
+constexpr Math::Cone LEFT_MOVE_CONE(Math::Vector3Common{1.0f, 0.0f, 0.0f},
+                                    TOLERANCE_CONE_ANGLE_RADIANS);
+constexpr Math::Cone RIGHT_MOVE_CONE(Math::Vector3Common{-1.0f, 0.0f, 0.0f},
+                                     TOLERANCE_CONE_ANGLE_RADIANS);
+
 ///////////////////////////////////////////////////////////////////////////////
 // Structures
 ///////////////////////////////////////////////////////////////////////////////
@@ -59,10 +75,68 @@ struct ProcessedHandState
     float averageFingerDirectionY;
 };
 
+/// @brief The direction a left hand moves the cursor in. A right hand's goes the other way in x.
+struct CursorDirection
+{
+    float x;
+    float y;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Cursor directions
+///////////////////////////////////////////////////////////////////////////////
+//
+// The finger angle, 0 to pi, is split into N sectors (N cursor directions), and sectors 2k - 1 and 2k share the
+// direction 2k sectors round from straight up. Angles of exactly pi land in sector N.
+
+constexpr int NUM_CURSOR_SECTORS = NUM_CURSOR_DIRECTIONS + 1;
+
+/// @return The sector an average finger angle is in, between 0 and N. NaNs are in sector 0.
+template <int NumDirections = NUM_CURSOR_DIRECTIONS>
+constexpr int GetCursorSector(float averageFingerAngle)
+{
+    constexpr float sectorArcLength = Math::_PI / NumDirections;
+    const float sectors = averageFingerAngle / sectorArcLength;
+    if (!(sectors >= 0.0f))
+        return 0;
+    return sectors < NumDirections ? static_cast<int>(sectors) : NumDirections;
+}
+
+template <int NumDirections = NUM_CURSOR_DIRECTIONS>
+constexpr std::array<CursorDirection, NumDirections + 1> MakeCursorDirections()
+{
+    constexpr float sectorArcLength = Math::_PI / NumDirections;
+    std::array<CursorDirection, NumDirections + 1> directions{};
+    for (int sector = 0; sector <= NumDirections; sector++)
+    {
+        // {-1, 0} => 0phi
+        // {1, 2} => 2phi
+        // {3, 4} => 4phi
+        // etc...
+        // integer division means these factors do NOT cancel out
+        const int scaleFactor = ((sector + 1) / 2) * 2;
+        const float angle = scaleFactor * sectorArcLength;
+        directions[sector].x = static_cast<float>(Math::Constexpr::Sin(angle));
+        directions[sector].y = static_cast<float>(Math::Constexpr::Cos(angle));
+    }
+    return directions;
+}
+
+/// @brief The cursor direction of every sector, worked out at compile time.
+constexpr std::array<CursorDirection, NUM_CURSOR_SECTORS> CURSOR_DIRECTIONS =
+    MakeCursorDirections();
+
 ///////////////////////////////////////////////////////////////////////////////
 // Data processing
 ///////////////////////////////////////////////////////////////////////////////
 
+/// @brief Reads the directions ProcessHandState needs off a tracked hand.
+UnprocessedHandState ToUnprocessedHandState(const LEAP_HAND& hand);
+
+/// @brief How far the fingers are bent towards the palm, on average, from 0 (straight) to pi.
+///        Only meaningful for a hand in the movement pose. See ProcessHandState.
+float GetAverageFingerAngle(const UnprocessedHandState& inState);
+
 ProcessedHandState ProcessHandState(UnprocessedHandState& inState);
 
 }  // namespace Input::Leap
\ No newline at end of file
@@ -0,0 +1,494 @@
+#include "PoseRecognizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "FrameCapture.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define POSE_RECOGNIZER_SSE
+#endif
+
+using Vec3 = Math::Vector3Common;
+using Matrix = std::array<std::array<double, Input::Leap::NUM_POSE_FEATURES>,
+                          Input::Leap::NUM_POSE_FEATURES>;
+
+namespace Input::Leap
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+bool IsFinite(const PoseFeatures& features);
+std::vector<PoseExemplar> RemoveNonFinite(std::vector<PoseExemplar> exemplars);
+float GetDistanceSquared(const PoseFeatures& a, const PoseFeatures& b);
+void FindEigenvectors(Matrix& matrix, Matrix& eigenvectors);
+void InsertNeighbor(PoseNeighbor candidate, size_t k, PoseNeighbor* neighbors,
+                    size_t& numNeighbors);
+float GetWorstDistanceSquared(size_t k, const PoseNeighbor* neighbors, size_t numNeighbors);
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+std::optional<PoseLabel> ParsePoseLabel(std::string_view name)
+{
+    if (name == "neutral")
+        return PoseLabel::Neutral;
+    if (name == "click")
+        return PoseLabel::Click;
+    if (name == "move")
+        return PoseLabel::Move;
+    if (name == "right-click")
+        return PoseLabel::RightClick;
+    if (name == "drag")
+        return PoseLabel::Drag;
+    if (name == "scroll")
+        return PoseLabel::Scroll;
+    return std::nullopt;
+}
+
+const char* GetPoseLabelName(PoseLabel label)
+{
+    switch (label)
+    {
+        case PoseLabel::Click:
+            return "click";
+        case PoseLabel::Move:
+            return "move";
+        case PoseLabel::RightClick:
+            return "right-click";
+        case PoseLabel::Drag:
+            return "drag";
+        case PoseLabel::Scroll:
+            return "scroll";
+        default:
+            return "neutral";
+    }
+}
+
+PoseFeatures ExtractPoseFeatures(const UnprocessedHandState& hand)
+{
+    PoseFeatures features{};
+    size_t i = 0;
+    auto add = [&features, &i](Vec3 direction)
+    {
+        direction = Vec3::Normalize(direction);
+        features[i++] = direction.X();
+        features[i++] = direction.Y();
+        features[i++] = direction.Z();
+    };
+
+    add(hand.palmNormal);
+    add(hand.handDirection);
+    for (const Vec3& finger : hand.fingerDirections)
+        add(finger);
+    for (const Vec3& finger : hand.fingerDirections)
+        features[i++] = Vec3::Angle(hand.handDirection, finger) / Math::_PI;
+    return features;
+}
+
+PoseFeatures ExtractPoseFeatures(const LEAP_HAND& hand)
+{
+    return ExtractPoseFeatures(ToUnprocessedHandState(hand));
+}
+
+bool AddCaptureExemplars(const std::string& filename, PoseLabel label,
+                         std::vector<PoseExemplar>& exemplars)
+{
+    FrameCaptureReader reader;
+    if (!reader.Open(filename))
+        return false;
+
+    for (size_t i = 0; i < reader.GetNumFrames(); i++)
+    {
+        const TrackingFrame frame = reader.GetFrame(i);
+        for (uint32_t hand = 0; hand < frame.nHands; hand++)
+            exemplars.push_back(PoseExemplar{ExtractPoseFeatures(frame.hands[hand]), label});
+    }
+    return true;
+}
+
+PoseKdTree::PoseKdTree(std::vector<PoseExemplar> exemplars)
+    : m_exemplars(RemoveNonFinite(std::move(exemplars)))
+{
+    if (m_exemplars.empty())
+        return;
+    FindPrincipalAxes();
+
+    m_points.resize(m_exemplars.size());
+    for (uint32_t i = 0; i < m_points.size(); i++)
+        m_points[i] = Point{ToPrincipalAxes(m_exemplars[i].features), i};
+    m_nodes.reserve(2 * m_points.size() / LEAF_SIZE + 1);
+    BuildNode(0, static_cast<uint32_t>(m_points.size()));
+}
+
+size_t PoseKdTree::FindNearest(const PoseFeatures& query, size_t k,
+                               PoseNeighbor* neighbors) const
+{
+    k = std::min(k, MAX_POSE_NEIGHBORS);
+    size_t numNeighbors = 0;
+    if (m_nodes.empty() || k == 0)
+        return 0;
+
+    PoseFeatures boxOffsets{};
+    Search(0, ToPrincipalAxes(query), k, neighbors, numNeighbors, 0.0f, boxOffsets);
+    // the search goes by point, the caller by exemplar
+    for (size_t i = 0; i < numNeighbors; i++)
+        neighbors[i].index = m_points[neighbors[i].index].exemplar;
+    return numNeighbors;
+}
+
+PoseFeatures PoseKdTree::ToPrincipalAxes(const PoseFeatures& features) const
+{
+    PoseFeatures centered;
+    for (size_t f = 0; f < NUM_POSE_FEATURES; f++)
+        centered[f] = features[f] - m_mean[f];
+
+    PoseFeatures coordinates;
+    for (size_t axis = 0; axis < NUM_POSE_FEATURES; axis++)
+    {
+        float sum = 0.0f;
+        for (size_t f = 0; f < NUM_POSE_FEATURES; f++)
+            sum += m_axes[axis][f] * centered[f];
+        coordinates[axis] = sum;
+    }
+    return coordinates;
+}
+
+void PoseKdTree::FindPrincipalAxes()
+{
+    // the axes only have to fit the library well, not exactly, so a sample does
+    const size_t stride = std::max<size_t>(m_exemplars.size() / MAX_AXIS_SAMPLES, 1);
+    const size_t numSamples = (m_exemplars.size() + stride - 1) / stride;
+
+    std::array<double, NUM_POSE_FEATURES> mean{};
+    for (size_t i = 0; i < m_exemplars.size(); i += stride)
+    {
+        for (size_t f = 0; f < NUM_POSE_FEATURES; f++)
+            mean[f] += m_exemplars[i].features[f];
+    }
+    for (double& value : mean)
+        value /= static_cast<double>(numSamples);
+
+    Matrix covariance{};
+    for (size_t i = 0; i < m_exemplars.size(); i += stride)
+    {
+        std::array<double, NUM_POSE_FEATURES> centered;
+        for (size_t f = 0; f < NUM_POSE_FEATURES; f++)
+            centered[f] = m_exemplars[i].features[f] - mean[f];
+        for (size_t row = 0; row < NUM_POSE_FEATURES; row++)
+        {
+            for (size_t column = row; column < NUM_POSE_FEATURES; column++)
+                covariance[row][column] += centered[row] * centered[column];
+        }
+    }
+    for (size_t row = 0; row < NUM_POSE_FEATURES; row++)
+    {
+        for (size_t column = 0; column < row; column++)
+            covariance[row][column] = covariance[column][row];
+    }
+
+    Matrix eigenvectors;
+    FindEigenvectors(covariance, eigenvectors);
+    for (size_t f = 0; f < NUM_POSE_FEATURES; f++)
+    {
+        m_mean[f] = static_cast<float>(mean[f]);
+        for (size_t axis = 0; axis < NUM_POSE_FEATURES; axis++)
+            m_axes[axis][f] = static_cast<float>(eigenvectors[f][axis]);
+    }
+}
+
+uint32_t PoseKdTree::BuildNode(uint32_t begin, uint32_t end)
+{
+    const uint32_t index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.push_back(Node{begin, end, NO_CHILD, NO_CHILD, 0, 0.0f});
+    if (end - begin <= LEAF_SIZE)
+        return index;
+
+    // split the axis that varies most, so the boxes of the nodes stay close to square
+    uint32_t axis = 0;
+    float widestSpread = 0.0f;
+    for (uint32_t a = 0; a < NUM_POSE_FEATURES; a++)
+    {
+        float min = m_points[begin].coordinates[a];
+        float max = min;
+        for (uint32_t i = begin + 1; i < end; i++)
+        {
+            min = std::min(min, m_points[i].coordinates[a]);
+            max = std::max(max, m_points[i].coordinates[a]);
+        }
+        if (max - min > widestSpread)
+        {
+            widestSpread = max - min;
+            axis = a;
+        }
+    }
+    if (widestSpread == 0.0f)
+        return index;  // all the same hand, which no split can tell apart
+
+    const uint32_t middle = begin + (end - begin) / 2;
+    std::nth_element(m_points.begin() + begin, m_points.begin() + middle,
+                     m_points.begin() + end, [axis](const Point& a, const Point& b)
+                     { return a.coordinates[axis] < b.coordinates[axis]; });
+    // read before the children reorder their halves
+    const float split = m_points[middle].coordinates[axis];
+
+    const uint32_t left = BuildNode(begin, middle);
+    const uint32_t right = BuildNode(middle, end);
+    // building the children may have moved the nodes
+    Node& node = m_nodes[index];
+    node.left = left;
+    node.right = right;
+    node.axis = axis;
+    node.split = split;
+    return index;
+}
+
+void PoseKdTree::Search(uint32_t nodeIndex, const PoseFeatures& query, size_t k,
+                        PoseNeighbor* neighbors, size_t& numNeighbors,
+                        float boxDistanceSquared, PoseFeatures& boxOffsets) const
+{
+    const Node& node = m_nodes[nodeIndex];
+    if (node.left == NO_CHILD)
+    {
+        for (uint32_t i = node.begin; i < node.end; i++)
+        {
+            const float distanceSquared = GetDistanceSquared(query, m_points[i].coordinates);
+            InsertNeighbor(PoseNeighbor{distanceSquared, i}, k, neighbors, numNeighbors);
+        }
+        return;
+    }
+
+    // the left child has the points at or below the split, the right those at or above it
+    const float offset = query[node.axis] - node.split;
+    const uint32_t nearChild = offset <= 0.0f ? node.left : node.right;
+    const uint32_t farChild = offset <= 0.0f ? node.right : node.left;
+    Search(nearChild, query, k, neighbors, numNeighbors, boxDistanceSquared, boxOffsets);
+
+    // The far child's box is the query's box, moved over to the split on this axis. Its
+    // distance from the query is a lower bound on every point in it, and a much tighter one
+    // than the offset from this split alone, because it counts every split on the way down.
+    const float previousOffset = boxOffsets[node.axis];
+    const float farDistanceSquared =
+        boxDistanceSquared - previousOffset * previousOffset + offset * offset;
+    if (farDistanceSquared < GetWorstDistanceSquared(k, neighbors, numNeighbors))
+    {
+        boxOffsets[node.axis] = offset;
+        Search(farChild, query, k, neighbors, numNeighbors, farDistanceSquared, boxOffsets);
+        boxOffsets[node.axis] = previousOffset;
+    }
+}
+
+PoseBruteForce::PoseBruteForce(std::vector<PoseExemplar> exemplars)
+    : m_exemplars(RemoveNonFinite(std::move(exemplars)))
+{
+    m_paddedSize = (m_exemplars.size() + 3) / 4 * 4;
+    // the padding is infinitely far from every query, so it's never a neighbour
+    m_columns.assign(NUM_POSE_FEATURES * m_paddedSize, std::numeric_limits<float>::infinity());
+    for (size_t i = 0; i < m_exemplars.size(); i++)
+    {
+        for (size_t f = 0; f < NUM_POSE_FEATURES; f++)
+            m_columns[f * m_paddedSize + i] = m_exemplars[i].features[f];
+    }
+}
+
+size_t PoseBruteForce::FindNearest(const PoseFeatures& query, size_t k,
+                                   PoseNeighbor* neighbors) const
+{
+    k = std::min(k, MAX_POSE_NEIGHBORS);
+    size_t numNeighbors = 0;
+    if (k == 0)
+        return 0;
+
+    // the features are summed in order, as GetDistanceSquared does, so with or without SSE the
+    // distances are the same
+    for (size_t block = 0; block < m_paddedSize; block += 4)
+    {
+        float distancesSquared[4];
+#ifdef POSE_RECOGNIZER_SSE
+        __m128 sum = _mm_setzero_ps();
+        for (size_t f = 0; f < NUM_POSE_FEATURES; f++)
+        {
+            const __m128 column = _mm_loadu_ps(&m_columns[f * m_paddedSize + block]);
+            const __m128 difference = _mm_sub_ps(column, _mm_set1_ps(query[f]));
+            sum = _mm_add_ps(sum, _mm_mul_ps(difference, difference));
+        }
+        _mm_storeu_ps(distancesSquared, sum);
+#else
+        for (size_t lane = 0; lane < 4; lane++)
+        {
+            float sum = 0.0f;
+            for (size_t f = 0; f < NUM_POSE_FEATURES; f++)
+            {
+                const float difference = m_columns[f * m_paddedSize + block + lane] - query[f];
+                sum += difference * difference;
+            }
+            distancesSquared[lane] = sum;
+        }
+#endif
+        // most blocks have nothing nearer than the worst neighbour so far
+        const float worst = GetWorstDistanceSquared(k, neighbors, numNeighbors);
+        for (size_t lane = 0; lane < 4; lane++)
+        {
+            if (distancesSquared[lane] < worst)
+            {
+                const PoseNeighbor candidate{distancesSquared[lane],
+                                             static_cast<uint32_t>(block + lane)};
+                InsertNeighbor(candidate, k, neighbors, numNeighbors);
+            }
+        }
+    }
+    return numNeighbors;
+}
+
+PoseRecognizer::PoseRecognizer(std::vector<PoseExemplar> library,
+                               const PoseRecognizerConfig& config)
+    : m_index(std::move(library)), m_config(config)
+{
+}
+
+PoseRecognition PoseRecognizer::Recognize(const PoseFeatures& features) const
+{
+    PoseNeighbor neighbors[MAX_POSE_NEIGHBORS];
+    const size_t numNeighbors = m_index.FindNearest(features, m_config.k, neighbors);
+
+    PoseRecognition recognition{PoseLabel::Neutral, false, 0,
+                                std::numeric_limits<float>::infinity()};
+    if (numNeighbors == 0)
+        return recognition;
+    recognition.distance = std::sqrt(neighbors[0].distanceSquared);
+    if (recognition.distance > m_config.maxDistance)
+        return recognition;
+
+    // the neighbours are nearest first, so of the labels with the most votes, the first one to
+    // get there is the one with the nearest exemplar
+    std::array<uint32_t, NUM_POSE_LABELS> votes{};
+    for (size_t i = 0; i < numNeighbors; i++)
+    {
+        const PoseLabel label = m_index.GetExemplar(neighbors[i].index).label;
+        const uint32_t labelVotes = ++votes[static_cast<size_t>(label)];
+        if (labelVotes > recognition.votes)
+        {
+            recognition.label = label;
+            recognition.votes = labelVotes;
+        }
+    }
+    recognition.isRecognized = true;
+    return recognition;
+}
+
+PoseRecognition PoseRecognizer::Recognize(const LEAP_HAND& hand) const
+{
+    return Recognize(ExtractPoseFeatures(hand));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+bool IsFinite(const PoseFeatures& features)
+{
+    return std::all_of(features.begin(), features.end(),
+                       [](float feature) { return std::isfinite(feature); });
+}
+
+std::vector<PoseExemplar> RemoveNonFinite(std::vector<PoseExemplar> exemplars)
+{
+    std::erase_if(exemplars,
+                  [](const PoseExemplar& exemplar) { return !IsFinite(exemplar.features); });
+    return exemplars;
+}
+
+float GetDistanceSquared(const PoseFeatures& a, const PoseFeatures& b)
+{
+    float sum = 0.0f;
+    for (size_t f = 0; f < NUM_POSE_FEATURES; f++)
+    {
+        const float difference = b[f] - a[f];
+        sum += difference * difference;
+    }
+    return sum;
+}
+
+/// @brief Cyclic Jacobi: rotates the symmetric matrix until it is diagonal, so the rotations
+///        add up to its eigenvectors, one per column.
+void FindEigenvectors(Matrix& matrix, Matrix& eigenvectors)
+{
+    constexpr int MAX_SWEEPS = 50;
+    constexpr size_t N = NUM_POSE_FEATURES;
+    for (size_t row = 0; row < N; row++)
+    {
+        for (size_t column = 0; column < N; column++)
+            eigenvectors[row][column] = row == column ? 1.0 : 0.0;
+    }
+
+    for (int sweep = 0; sweep < MAX_SWEEPS; sweep++)
+    {
+        double offDiagonal = 0.0;
+        for (size_t p = 0; p < N; p++)
+        {
+            for (size_t q = p + 1; q < N; q++)
+                offDiagonal += matrix[p][q] * matrix[p][q];
+        }
+        if (offDiagonal < 1e-24)
+            return;
+
+        for (size_t p = 0; p < N; p++)
+        {
+            for (size_t q = p + 1; q < N; q++)
+            {
+                if (matrix[p][q] == 0.0)
+                    continue;
+
+                // the rotation in the (p, q) plane that zeroes matrix[p][q]
+                const double theta = (matrix[q][q] - matrix[p][p]) / (2.0 * matrix[p][q]);
+                const double t = std::copysign(1.0, theta) /
+                                 (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                const double c = 1.0 / std::sqrt(t * t + 1.0);
+                const double s = t * c;
+
+                auto rotate = [c, s](double& a, double& b)
+                {
+                    const double oldA = a;
+                    a = c * oldA - s * b;
+                    b = s * oldA + c * b;
+                };
+                for (size_t i = 0; i < N; i++)
+                    rotate(matrix[i][p], matrix[i][q]);
+                for (size_t i = 0; i < N; i++)
+                    rotate(matrix[p][i], matrix[q][i]);
+                for (size_t i = 0; i < N; i++)
+                    rotate(eigenvectors[i][p], eigenvectors[i][q]);
+            }
+        }
+    }
+}
+
+/// @brief Keeps neighbors the k nearest candidates so far, nearest first. A candidate that ties
+///        one already there goes after it.
+void InsertNeighbor(PoseNeighbor candidate, size_t k, PoseNeighbor* neighbors,
+                    size_t& numNeighbors)
+{
+    if (!(candidate.distanceSquared < GetWorstDistanceSquared(k, neighbors, numNeighbors)))
+        return;  // NaN as well
+
+    size_t i = std::min(numNeighbors, k - 1);
+    while (i > 0 && neighbors[i - 1].distanceSquared > candidate.distanceSquared)
+    {
+        neighbors[i] = neighbors[i - 1];
+        i--;
+    }
+    neighbors[i] = candidate;
+    numNeighbors = std::min(numNeighbors + 1, k);
+}
+
+/// @return How near a candidate has to be to be one of the k nearest: infinity until there are k.
+float GetWorstDistanceSquared(size_t k, const PoseNeighbor* neighbors, size_t numNeighbors)
+{
+    if (numNeighbors < k)
+        return std::numeric_limits<float>::infinity();
+    return neighbors[k - 1].distanceSquared;
+}
+
+}  // namespace Input::Leap
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <LeapC.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LeapMotionGestureProvider.hpp"
+
+namespace Input::Leap
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Pose recognition
+///////////////////////////////////////////////////////////////////////////////
+//
+// ProcessHandState knows two poses by their cones. A PoseRecognizer knows whichever poses it has
+// exemplars of instead: every hand is turned into a fixed-length feature vector, and labelled
+// like most of its k nearest neighbours in a library of labelled hands. The library is indexed by
+// a KD-tree, so a query only looks at the exemplars near it.
+
+/// @brief The features of a hand, in order: the palm normal, the hand direction, the four
+///        fingers' directions (x, y and z of each), then how far each finger is curled, from 0
+///        (straight out along the hand direction) to 1 (pointing back at the wrist).
+constexpr size_t NUM_POSE_FEATURES = 3 + 3 + 4 * 3 + 4;
+using PoseFeatures = std::array<float, NUM_POSE_FEATURES>;
+
+enum class PoseLabel : uint8_t
+{
+    Neutral,
+    Click,
+    Move,
+    RightClick,
+    Drag,
+    Scroll
+};
+
+constexpr size_t NUM_POSE_LABELS = 6;
+
+/// @return The label called "neutral", "click", "move", "right-click", "drag" or "scroll", or
+///         nothing if it's none of those.
+std::optional<PoseLabel> ParsePoseLabel(std::string_view name);
+
+const char* GetPoseLabelName(PoseLabel label);
+
+PoseFeatures ExtractPoseFeatures(const UnprocessedHandState& hand);
+PoseFeatures ExtractPoseFeatures(const LEAP_HAND& hand);
+
+struct PoseExemplar
+{
+    PoseFeatures features;
+    PoseLabel label;
+};
+
+/// @brief Adds every hand of a capture, recorded while holding one pose, to exemplars, labelled
+///        label.
+/// @return false if the file isn't a frame capture this build can read.
+bool AddCaptureExemplars(const std::string& filename, PoseLabel label,
+                         std::vector<PoseExemplar>& exemplars);
+
+/// @brief The most neighbours a query can ask for.
+constexpr size_t MAX_POSE_NEIGHBORS = 32;
+
+struct PoseNeighbor
+{
+    float distanceSquared;
+    uint32_t index;  // of the exemplar, for GetExemplar
+};
+
+/// @brief A KD-tree over exemplars. Their features are first turned onto the principal axes of
+///        the library, which keeps every distance the same: hands vary along far fewer directions
+///        than they have features, and the boxes of the nodes fit them much more tightly once
+///        those directions are axes. Nodes split at the median of the axis that varies most.
+class PoseKdTree
+{
+   public:
+    PoseKdTree() = default;
+    /// @brief Exemplars with a NaN or infinite feature are left out.
+    explicit PoseKdTree(std::vector<PoseExemplar> exemplars);
+
+    size_t Size() const { return m_exemplars.size(); }
+
+    const PoseExemplar& GetExemplar(uint32_t index) const { return m_exemplars[index]; }
+
+    /// @brief Finds the k (up to MAX_POSE_NEIGHBORS) exemplars nearest the query, nearest first.
+    ///        The distances are worked out on the principal axes, so they can be a rounding
+    ///        error away from PoseBruteForce's.
+    /// @return How many were found: k, unless there are fewer exemplars or the query is NaN.
+    size_t FindNearest(const PoseFeatures& query, size_t k, PoseNeighbor* neighbors) const;
+
+   private:
+    // Leaves hold up to this many exemplars, and are searched by brute force.
+    static constexpr uint32_t LEAF_SIZE = 8;
+    static constexpr uint32_t NO_CHILD = UINT32_MAX;
+
+    // The library's covariance is estimated from about this many of its exemplars.
+    static constexpr size_t MAX_AXIS_SAMPLES = 16384;
+
+    struct Point
+    {
+        PoseFeatures coordinates;  // on the principal axes
+        uint32_t exemplar;
+    };
+
+    struct Node
+    {
+        uint32_t begin;  // the points under the node
+        uint32_t end;
+        uint32_t left;  // NO_CHILD for a leaf
+        uint32_t right;
+        uint32_t axis;  // left has the points at or below split on this axis
+        float split;
+    };
+
+    std::vector<PoseExemplar> m_exemplars;
+    std::vector<Point> m_points;  // in the order of the nodes
+    std::vector<Node> m_nodes;
+    PoseFeatures m_mean;
+    std::array<PoseFeatures, NUM_POSE_FEATURES> m_axes;  // unit vectors
+
+    PoseFeatures ToPrincipalAxes(const PoseFeatures& features) const;
+    void FindPrincipalAxes();
+    uint32_t BuildNode(uint32_t begin, uint32_t end);
+    /// @param boxDistanceSquared From the query to the box of the node.
+    /// @param boxOffsets From the query to the box of the node, on each axis.
+    void Search(uint32_t node, const PoseFeatures& query, size_t k, PoseNeighbor* neighbors,
+                size_t& numNeighbors, float boxDistanceSquared, PoseFeatures& boxOffsets) const;
+};
+
+/// @brief Every exemplar against every query, four at a time with SSE where there is SSE.
+///        Slower than the KD-tree on large libraries, but its answers are the reference.
+class PoseBruteForce
+{
+   public:
+    PoseBruteForce() = default;
+    explicit PoseBruteForce(std::vector<PoseExemplar> exemplars);
+
+    size_t Size() const { return m_exemplars.size(); }
+
+    const PoseExemplar& GetExemplar(uint32_t index) const { return m_exemplars[index]; }
+
+    /// @brief As PoseKdTree::FindNearest.
+    size_t FindNearest(const PoseFeatures& query, size_t k, PoseNeighbor* neighbors) const;
+
+   private:
+    std::vector<PoseExemplar> m_exemplars;
+    size_t m_paddedSize;           // a multiple of 4
+    std::vector<float> m_columns;  // feature f of exemplar i at f * m_paddedSize + i
+};
+
+struct PoseRecognizerConfig
+{
+    size_t k = 7;
+
+    /// @brief A hand further than this from every exemplar isn't in any pose it knows.
+    float maxDistance = 0.5f;
+};
+
+struct PoseRecognition
+{
+    /// @brief Neutral if the hand wasn't recognized.
+    PoseLabel label;
+
+    bool isRecognized;
+
+    /// @brief How many of the neighbours have the label.
+    uint32_t votes;
+
+    /// @brief To the nearest exemplar.
+    float distance;
+};
+
+class PoseRecognizer
+{
+   public:
+    explicit PoseRecognizer(std::vector<PoseExemplar> library,
+                            const PoseRecognizerConfig& config = PoseRecognizerConfig{});
+
+    /// @brief The label most of the k nearest exemplars have. A tie goes to the label of the
+    ///        nearest of the tied exemplars.
+    PoseRecognition Recognize(const PoseFeatures& features) const;
+    PoseRecognition Recognize(const LEAP_HAND& hand) const;
+
+    const PoseKdTree& GetIndex() const { return m_index; }
+
+   private:
+    PoseKdTree m_index;
+    PoseRecognizerConfig m_config;
+};
+
+}  // namespace Input::Leap
@@ -0,0 +1,94 @@
+#include "ReplayFrameSource.hpp"
+
+#include <chrono>
+#include <stdexcept>
+
+namespace Input::Leap
+{
+
+ReplayFrameSource::ReplayFrameSource(const std::string& filename, double speed, bool isLooping)
+    : m_speed(speed), m_isLooping(isLooping), m_nextFrame(0), m_isRunning(true)
+{
+    if (!m_capture.Open(filename))
+        throw std::runtime_error("Unable to read frame capture " + filename + ".");
+    if (m_capture.GetNumFrames() == 0)
+        throw std::runtime_error("Frame capture " + filename + " has no frames.");
+
+    if (IsThrottled())
+        m_playbackThread = std::thread(&ReplayFrameSource::PlaybackLoop, this);
+}
+
+ReplayFrameSource::~ReplayFrameSource()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_stopLock);
+        m_isRunning = false;
+    }
+    m_stopped.notify_all();
+    if (m_playbackThread.joinable())
+        m_playbackThread.join();
+}
+
+bool ReplayFrameSource::IsConnected() const { return !m_lastFrame.IsClosed(); }
+
+TrackingFrame ReplayFrameSource::GetFrame() const { return m_lastFrame.Load(); }
+
+uint64_t ReplayFrameSource::GetFrameSequence() const { return m_lastFrame.GetSequence(); }
+
+uint64_t ReplayFrameSource::WaitForFrame(uint64_t sequence)
+{
+    if (IsThrottled())
+        return m_lastFrame.WaitForNewer(sequence);
+
+    std::lock_guard<std::mutex> lock(m_pullLock);
+    if (m_lastFrame.GetSequence() == sequence && !m_lastFrame.IsClosed())
+        PublishNext();
+    return m_lastFrame.GetSequence();
+}
+
+void ReplayFrameSource::WakeFrameWaiters() { m_lastFrame.WakeWaiters(); }
+
+void ReplayFrameSource::PublishNext()
+{
+    if (m_nextFrame == m_capture.GetNumFrames())
+    {
+        if (!m_isLooping)
+        {
+            m_lastFrame.Close();
+            return;
+        }
+        m_nextFrame = 0;
+    }
+    m_lastFrame.Publish(m_capture.GetFrame(m_nextFrame++));
+}
+
+void ReplayFrameSource::PlaybackLoop()
+{
+    using namespace std::chrono;
+
+    while (!m_lastFrame.IsClosed())
+    {
+        // every pass through the capture is timed from its own start,
+        // since the recorded timestamps start over too
+        const auto passStart = Helpers::Clock::SteadyClock::now();
+        const int64_t firstMicros = m_capture.GetFrame(0).timestampMicros;
+        for (size_t i = 0; i < m_capture.GetNumFrames(); i++)
+        {
+            const int64_t sinceFirst = m_capture.GetFrame(i).timestampMicros - firstMicros;
+            const auto due = passStart + duration_cast<nanoseconds>(
+                                             duration<double, std::micro>(sinceFirst / m_speed));
+            {
+                std::unique_lock<std::mutex> lock(m_stopLock);
+                if (m_stopped.wait_until(lock, due, [this] { return !m_isRunning.load(); }))
+                    return;
+            }
+            PublishNext();
+        }
+
+        // past the last frame: either closes the slot or starts the next pass at frame 0
+        if (!m_isLooping)
+            PublishNext();
+    }
+}
+
+}  // namespace Input::Leap
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "FrameCapture.hpp"
+#include "FrameSource.hpp"
+
+namespace Input::Leap
+{
+
+/// @brief Plays a frame capture back as if it were the device, so everything downstream of a
+///        FrameSource runs without one.
+///
+///        At a speed above 0, a playback thread publishes every frame when its recorded
+///        timestamp comes up, scaled by the speed: 1 is real time, 10 is ten times as fast.
+///        Consumers that fall behind skip frames, just like with the device.
+///
+///        At UNTHROTTLED there is no thread. Each WaitForFrame call that has seen the latest frame
+///        publishes the next one right away, so a single consumer gets every frame, in order,
+///        as fast as it can process them. That is the mode for benchmarks and regression tests.
+class ReplayFrameSource : public FrameSource
+{
+   public:
+    static constexpr double UNTHROTTLED = 0.0;
+
+    /// @param isLooping Starts over from the first frame after the last one, instead of
+    ///                  disconnecting.
+    /// @throws std::runtime_error if the capture can't be read or has no frames.
+    ReplayFrameSource(const std::string& filename, double speed, bool isLooping = false);
+    ~ReplayFrameSource() override;
+
+    ReplayFrameSource(const ReplayFrameSource&) = delete;
+    ReplayFrameSource& operator=(const ReplayFrameSource&) = delete;
+
+    /// @brief Connected until the last frame has been published, unless looping.
+    bool IsConnected() const override;
+
+    TrackingFrame GetFrame() const override;
+    uint64_t GetFrameSequence() const override;
+
+    /// @brief Once disconnected, returns straight away.
+    uint64_t WaitForFrame(uint64_t sequence) override;
+
+    void WakeFrameWaiters() override;
+
+    size_t GetNumFrames() const { return m_capture.GetNumFrames(); }
+
+   private:
+    FrameCaptureReader m_capture;
+    const double m_speed;
+    const bool m_isLooping;
+
+    FrameSlot m_lastFrame;
+    size_t m_nextFrame;  // owned by the playback thread, or guarded by m_pullLock if unthrottled
+    std::mutex m_pullLock;
+
+    std::atomic<bool> m_isRunning;
+    std::mutex m_stopLock;
+    std::condition_variable m_stopped;
+    std::thread m_playbackThread;
+
+    bool IsThrottled() const { return m_speed > UNTHROTTLED; }
+
+    /// @brief Publishes the next frame, or closes m_lastFrame if there are none left.
+    void PublishNext();
+
+    void PlaybackLoop();
+};
+
+}  // namespace Input::Leap
@@ -0,0 +1,196 @@
+#include "SyntheticHands.hpp"
+
+#include <Math/MathHelpers.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+using Vec3 = Math::Vector3Common;
+
+namespace Input::Leap
+{
+
+// how far each finger is bent from the average curl; they add up to 0
+constexpr std::array<float, 4> FINGER_CURL_SPREAD_RADIANS = {-0.12f, -0.04f, 0.04f, 0.12f};
+constexpr float DISTAL_BONE_LENGTH_MM = 20.0f;
+constexpr LEAP_VECTOR PALM_POSITION_MM = {0.0f, 200.0f, 0.0f};
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+std::array<float, 4> GetFingerCurls(float curlRadians);
+Vec3 GetPalmNormal(const SyntheticHandPose& pose);
+Vec3 GetHandDirection(const SyntheticHandPose& pose);
+bool IsInDoubleCone(Vec3 coneAxis, Vec3 unitVector);
+Vec3 AddNoise(Vec3 unitVector, float noiseRadians, uint64_t& state);
+float NextRandom(uint64_t& state);
+float TriangleWave(uint64_t frame, uint32_t periodFrames);
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+LEAP_HAND MakeSyntheticHand(const SyntheticHandPose& pose, float noiseRadians, uint64_t& state)
+{
+    const Vec3 palmNormal = GetPalmNormal(pose);
+    const Vec3 handDirection = GetHandDirection(pose);
+
+    LEAP_HAND hand{};
+    hand.type = pose.isLeft ? eLeapHandType_Left : eLeapHandType_Right;
+    hand.confidence = 1.0f;
+    hand.palm.position = PALM_POSITION_MM;
+    hand.palm.normal = AddNoise(palmNormal, noiseRadians, state).AsLeap();
+    hand.palm.direction = AddNoise(handDirection, noiseRadians, state).AsLeap();
+
+    // fingers bend from the hand direction towards the palm normal
+    const std::array<float, 4> curls = GetFingerCurls(pose.curlRadians);
+    for (size_t i = 0; i < curls.size(); i++)
+    {
+        Vec3 direction = Vec3::Add(Vec3::ScalarMultiply(handDirection, std::cos(curls[i])),
+                                   Vec3::ScalarMultiply(palmNormal, std::sin(curls[i])));
+        direction = AddNoise(direction, noiseRadians, state);
+
+        // index to pinky, side by side across the palm
+        const Vec3 base(PALM_POSITION_MM.x + 20.0f * (static_cast<float>(i) - 1.5f),
+                        PALM_POSITION_MM.y, PALM_POSITION_MM.z - 80.0f);
+        LEAP_BONE& distal = hand.digits[i + 1].distal;
+        distal.prev_joint = base.AsLeap();
+        distal.next_joint =
+            Vec3::Add(base, Vec3::ScalarMultiply(direction, DISTAL_BONE_LENGTH_MM)).AsLeap();
+        hand.digits[i + 1].is_extended = curls[i] < Math::_PI / 4.0f;
+    }
+    return hand;
+}
+
+ProcessedHandState GetExpectedHandState(const SyntheticHandPose& pose)
+{
+    ProcessedHandState state{};
+
+    const Vec3 palmNormal = GetPalmNormal(pose);
+    state.isInClickPose = IsInDoubleCone(Vec3{0.0f, -1.0f, 0.0f}, palmNormal);
+    if (state.isInClickPose)
+        return state;
+
+    const Vec3 referenceVec = pose.isLeft ? Vec3{1.0f, 0.0f, 0.0f} : Vec3{-1.0f, 0.0f, 0.0f};
+    if (!IsInDoubleCone(referenceVec, palmNormal))
+        return state;
+
+    float averageAngle = 0.0f;
+    for (float curl : GetFingerCurls(pose.curlRadians))
+        averageAngle += curl;
+    averageAngle /= 4.0f;
+
+    // pairs of sectors share a cursor direction, see ProcessHandState
+    constexpr float sectorArcLength = Math::_PI / 8.0f;
+    const int sectorIndex = static_cast<int>(averageAngle / sectorArcLength);
+    const int scaleFactor = ((sectorIndex + 1) / 2) * 2;
+
+    state.cursorDirectionX = std::sin(scaleFactor * sectorArcLength) * referenceVec.X();
+    state.cursorDirectionY = std::cos(scaleFactor * sectorArcLength);
+    state.averageFingerDirectionX = std::sin(averageAngle) * referenceVec.X();
+    state.averageFingerDirectionY = std::cos(averageAngle);
+    return state;
+}
+
+SyntheticHandGenerator::SyntheticHandGenerator(const SyntheticHandConfig& config)
+    : m_config(config), m_frame(0), m_random(config.seed)
+{
+}
+
+SyntheticHandPose SyntheticHandGenerator::NextPose()
+{
+    const uint64_t frame = m_frame++;
+
+    SyntheticHandPose pose{};
+    pose.isLeft = frame % m_config.handPeriodFrames < m_config.handPeriodFrames / 2;
+    pose.rollRadians =
+        m_config.maxRollRadians * (2.0f * TriangleWave(frame, m_config.rollPeriodFrames) - 1.0f);
+    pose.tiltRadians =
+        m_config.maxTiltRadians * (2.0f * TriangleWave(frame, m_config.tiltPeriodFrames) - 1.0f);
+    pose.curlRadians = Math::_PI * TriangleWave(frame, m_config.curlPeriodFrames);
+    return pose;
+}
+
+LEAP_HAND SyntheticHandGenerator::NextHand(SyntheticHandPose* pose)
+{
+    const SyntheticHandPose next = NextPose();
+    if (pose)
+        *pose = next;
+
+    LEAP_HAND hand = MakeSyntheticHand(next, m_config.noiseRadians, m_random);
+    hand.id = static_cast<uint32_t>(m_frame / m_config.handPeriodFrames);
+    return hand;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+std::array<float, 4> GetFingerCurls(float curlRadians)
+{
+    // fingers can't bend past straight or folded back, so the spread is squeezed at either end
+    std::array<float, 4> curls{};
+    for (size_t i = 0; i < curls.size(); i++)
+        curls[i] = std::clamp(curlRadians + FINGER_CURL_SPREAD_RADIANS[i], 0.0f, Math::_PI);
+    return curls;
+}
+
+Vec3 GetPalmNormal(const SyntheticHandPose& pose)
+{
+    // rolled about the hand direction (-z), then tipped towards it
+    const Vec3 rolled(std::sin(pose.rollRadians), -std::cos(pose.rollRadians), 0.0f);
+    return Vec3::Add(Vec3::ScalarMultiply(rolled, std::cos(pose.tiltRadians)),
+                     Vec3{0.0f, 0.0f, -std::sin(pose.tiltRadians)});
+}
+
+Vec3 GetHandDirection(const SyntheticHandPose& pose)
+{
+    // tipped along with the palm normal, so the two stay perpendicular
+    const Vec3 rolled(std::sin(pose.rollRadians), -std::cos(pose.rollRadians), 0.0f);
+    return Vec3::Subtract(Vec3{0.0f, 0.0f, -std::cos(pose.tiltRadians)},
+                          Vec3::ScalarMultiply(rolled, std::sin(pose.tiltRadians)));
+}
+
+bool IsInDoubleCone(Vec3 coneAxis, Vec3 unitVector)
+{
+    // Math::Cone compares squared cosines, so it also accepts vectors in the cone that points
+    // the opposite way (a palm facing up is in the click pose). Expected states follow it.
+    const float cosine = Vec3::DotProduct(coneAxis, unitVector);
+    const float coneCosine = std::cos(TOLERANCE_CONE_ANGLE_RADIANS);
+    return cosine * cosine > coneCosine * coneCosine;
+}
+
+Vec3 AddNoise(Vec3 unitVector, float noiseRadians, uint64_t& state)
+{
+    if (noiseRadians == 0.0f)
+        return unitVector;
+
+    // a small enough offset off the tip of a unit vector turns it by about as many radians
+    // drawn one at a time, since the order arguments are evaluated in differs between compilers
+    const float x = NextRandom(state);
+    const float y = NextRandom(state);
+    const float z = NextRandom(state);
+    const Vec3 offset(x, y, z);
+    return Vec3::Normalize(
+        Vec3::Add(unitVector, Vec3::ScalarMultiply(offset, noiseRadians / std::sqrt(3.0f))));
+}
+
+float NextRandom(uint64_t& state)
+{
+    // SplitMix64, since the distributions in <random> differ between standard libraries
+    state += 0x9E3779B97F4A7C15ull;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+
+    // uniform in [-1, 1)
+    return static_cast<float>(z >> 40) / static_cast<float>(1ull << 23) - 1.0f;
+}
+
+float TriangleWave(uint64_t frame, uint32_t periodFrames)
+{
+    // 0 at the start of the period, 1 halfway through, back to 0 at the end
+    const float phase = static_cast<float>(frame % periodFrames) / static_cast<float>(periodFrames);
+    return 1.0f - std::abs(2.0f * phase - 1.0f);
+}
+
+}  // namespace Input::Leap
@@ -0,0 +1,83 @@
+#pragma once
+
+#include <LeapC.h>
+
+#include <cstdint>
+
+#include "LeapMotionGestureProvider.hpp"
+
+namespace Input::Leap
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Synthetic hands
+///////////////////////////////////////////////////////////////////////////////
+//
+// Made-up hands for pushing ProcessHandState harder than the device can, and for checking it
+// against what a hand was built to be. A hand is described by a SyntheticHandPose:
+//
+//   roll   Rotates the palm about the hand direction. 0 is palm down (the click pose),
+//          +90 degrees faces the palm right (a left hand's movement pose) and -90 degrees faces
+//          it left (a right hand's movement pose).
+//   tilt   Pitches the whole hand, tipping the palm normal towards the hand direction, so the
+//          palm normal can leave the cones in any direction, not just around their rim.
+//   curl   How far the fingers are bent from straight (0) to folded back (pi), measured towards
+//          the palm like ProcessHandState does. Each of the 8 sectors of a hand's half circle is
+//          a cursor direction; left and right hands mirror each other, covering all 16.
+//
+// Only what ProcessHandState and the visualizer read is filled in: palm position, normal and
+// direction, and the distal bones of the fingers.
+
+struct SyntheticHandPose
+{
+    bool isLeft;
+    float rollRadians;
+    float tiltRadians;
+    float curlRadians;  // the average over the four fingers
+};
+
+/// @brief Builds the hand a pose describes. noise, if non-zero, is the most each direction
+///        (palm normal, hand direction, and every finger) is knocked off by, in radians.
+///        The random numbers come from state, which is advanced.
+LEAP_HAND MakeSyntheticHand(const SyntheticHandPose& pose, float noiseRadians, uint64_t& state);
+
+/// @brief What ProcessHandState should make of a noise-free hand built from the pose.
+ProcessedHandState GetExpectedHandState(const SyntheticHandPose& pose);
+
+struct SyntheticHandConfig
+{
+    uint64_t seed = 1;  // of the noise
+    float noiseRadians = 0.0f;
+
+    // The trajectory: every angle sweeps back and forth over its range, with periods that
+    // don't divide each other so the sweeps keep meeting in new combinations.
+    float maxRollRadians = 2.0f;  // sweeps [-max, max], through both movement cones and click
+    float maxTiltRadians = 0.6f;  // sweeps [-max, max]
+    uint32_t rollPeriodFrames = 1009;
+    uint32_t tiltPeriodFrames = 1511;
+    uint32_t curlPeriodFrames = 257;   // sweeps [0, pi]
+    uint32_t handPeriodFrames = 5003;  // left for half of it, right for the other half
+};
+
+/// @brief Deterministic stream of synthetic hands: the same config gives the same hands, on any
+///        platform. Cheap enough to make millions of frames a second.
+class SyntheticHandGenerator
+{
+   public:
+    explicit SyntheticHandGenerator(const SyntheticHandConfig& config = {});
+
+    /// @brief The pose of the next frame along the trajectory, without noise.
+    SyntheticHandPose NextPose();
+
+    /// @brief The hand of the next frame, noise included. pose, if given, gets the frame's pose.
+    LEAP_HAND NextHand(SyntheticHandPose* pose = nullptr);
+
+    uint64_t GetFrameIndex() const { return m_frame; }
+
+   private:
+    SyntheticHandConfig m_config;
+    uint64_t m_frame;
+    uint64_t m_random;
+};
+
+}  // namespace Input::Leap
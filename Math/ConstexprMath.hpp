@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace Math::Constexpr
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// <cmath> functions that can run at compile time
+///////////////////////////////////////////////////////////////////////////////
+//
+// The gesture code wants a few tables and thresholds worked out at compile time, and the <cmath>
+// functions aren't constexpr until C++26. These work in double, so rounded to float they are the
+// correctly rounded result in all but the rarest cases. They are slow next to <cmath>; anything
+// that runs per frame should only use them at compile time.
+
+constexpr double PI = 3.14159265358979323846;
+
+constexpr double Abs(double x) { return x < 0.0 ? -x : x; }
+
+/// @brief Newton's method from an exponent-only first guess. NaN for negative numbers.
+constexpr double Sqrt(double x)
+{
+    if (!(x >= 0.0))
+        return std::numeric_limits<double>::quiet_NaN();
+    if (x == 0.0 || x == std::numeric_limits<double>::infinity())
+        return x;
+
+    double guess = 1.0;
+    for (double scaled = x; scaled > 4.0; scaled /= 4.0)
+        guess *= 2.0;
+    for (double scaled = x; scaled < 0.25; scaled *= 4.0)
+        guess /= 2.0;
+    for (int i = 0; i < 8; i++)
+        guess = 0.5 * (guess + x / guess);
+    return guess;
+}
+
+/// @brief Taylor series, after reducing x to [-pi, pi]. Exact enough for |x| up to about 1e6.
+constexpr double Sin(double x)
+{
+    const double turns = x / (2.0 * PI);
+    const double wholeTurns =
+        static_cast<double>(static_cast<int64_t>(turns + (turns < 0.0 ? -0.5 : 0.5)));
+    x -= wholeTurns * 2.0 * PI;
+
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 20; n++)
+    {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double Cos(double x) { return Sin(x + PI / 2.0); }
+
+/// @brief Taylor series of atan, after halving the angle until the series converges quickly.
+constexpr double Atan(double x)
+{
+    if (x != x)
+        return x;
+    if (Abs(x) > 1.0)
+        return (x > 0.0 ? PI / 2.0 : -PI / 2.0) - Atan(1.0 / x);
+
+    // atan(x) = 2 atan(x / (1 + sqrt(1 + x^2))), twice, takes |x| under tan(pi/16)
+    for (int i = 0; i < 2; i++)
+        x = x / (1.0 + Sqrt(1.0 + x * x));
+
+    double term = x;
+    double sum = x;
+    for (int n = 1; n < 30; n++)
+    {
+        term *= -x * x;
+        sum += term / (2.0 * n + 1.0);
+    }
+    return 4.0 * sum;
+}
+
+/// @brief The angle of [x, y] from the x axis, in (-pi, pi], like std::atan2.
+constexpr double Atan2(double y, double x)
+{
+    if (x > 0.0)
+        return Atan(y / x);
+    if (x < 0.0)
+        return y < 0.0 ? Atan(y / x) - PI : Atan(y / x) + PI;
+    if (y > 0.0)
+        return PI / 2.0;
+    if (y < 0.0)
+        return -PI / 2.0;
+    return 0.0;
+}
+
+}  // namespace Math::Constexpr
@@ -7,6 +7,7 @@
 #include <cmath>
 #endif
 
+#include <Math/ConstexprMath.hpp>
 #include <Math/Vector3Common.hpp>
 
 namespace Math
@@ -16,10 +17,50 @@ constexpr float _PI = M_PI;  // the underscore avoids name conflict with raylib
 constexpr float DEG_TO_RAD = _PI / 180.0f;
 constexpr float RAD_TO_DEG = 180.0f / _PI;
 
-/// @brief Detects if a vector is in a cone.
+/// @brief A cone with its tip at the origin. Its angle is kept as the squared cosine, worked out
+///        once, so testing a vector against it takes two dot products and no trigonometry.
+struct Cone
+{
+    /// @brief The axis of the cone (base to tip).
+    Vector3Common axis;
+
+    /// @brief The squared cosine of the cone's angle, times the axis' squared length.
+    float cosineSquared;
+
+    /// @param coneAxis The axis of the cone (base to tip).
+    /// @param coneAngle The angle between the cone's axis and its outer surface.
+    constexpr Cone(Vector3Common coneAxis, float coneAngle)
+        : axis(coneAxis),
+          cosineSquared(GetCosineSquared(coneAngle) * coneAxis.MagnitudeSquared())
+    {
+    }
+
+    /// @brief Detects if a vector is in the cone, or in the cone that points the opposite way:
+    ///        the angle between them and the axis is compared through its squared cosine.
+    constexpr bool Contains(Vector3Common vector) const
+    {
+        const float dist = Vector3Common::DotProduct(vector, axis);
+        return dist * dist > cosineSquared * vector.MagnitudeSquared();
+    }
+
+   private:
+    // Constexpr::Cos even at run time, so a cone made at run time is the same as one made at
+    // compile time with the same angle
+    static constexpr float GetCosineSquared(float angle)
+    {
+        const float cosine = static_cast<float>(Constexpr::Cos(angle));
+        return cosine * cosine;
+    }
+};
+
+/// @brief Detects if a vector is in a cone. This works the cone out on every call: make a Cone
+///        to test many vectors against one cone.
 /// @param coneAxis The axis of the cone (base to tip).
 /// @param coneAngle The angle between the cone's axis and its outer surface.
 /// @param vector The vector to test.
-bool IsVectorInCone(Math::Vector3Common coneAxis, float coneAngle, Math::Vector3Common vector);
+constexpr bool IsVectorInCone(Vector3Common coneAxis, float coneAngle, Vector3Common vector)
+{
+    return Cone(coneAxis, coneAngle).Contains(vector);
+}
 
 }  // namespace Math
\ No newline at end of file
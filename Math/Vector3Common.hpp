@@ -1,53 +1,154 @@
 #pragma once
 
 #include <LeapC.h>
-#include <raymath.h>
+#include <raylib.h>
 
+#include <cmath>
 #include <ostream>
+#include <type_traits>
+
+#include "ConstexprMath.hpp"
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define VECTOR3_COMMON_SSE
+#endif
 
 namespace Math
 {
 
+/// @brief A 3D vector that converts to and from raylib's and LeapC's. Everything is inline and,
+///        apart from the LeapC conversions, constexpr, so directions and cones can be worked out
+///        at compile time. The arithmetic is done in the same order as raymath's, so the results
+///        are the same to the bit.
 class Vector3Common
 {
    public:
-    Vector3Common();
-    Vector3Common(float x, float y, float z);
-    Vector3Common(Vector3 vec);
-    Vector3Common(LEAP_VECTOR vec);
+    constexpr Vector3Common() : m_vec(Vector3{0.0f, 0.0f, 0.0f}) {}
+    constexpr Vector3Common(float x, float y, float z) : m_vec(Vector3{x, y, z}) {}
+    constexpr Vector3Common(Vector3 vec) : m_vec(vec) {}
+    // LEAP_VECTOR is a union, so it can't be read or made at compile time
+    Vector3Common(LEAP_VECTOR vec) : m_vec(Vector3{vec.x, vec.y, vec.z}) {}
+
+    constexpr Vector3 AsRaylib() const { return m_vec; }
+    LEAP_VECTOR AsLeap() const { return LEAP_VECTOR{m_vec.x, m_vec.y, m_vec.z}; }
+
+    constexpr float X() const { return m_vec.x; }
+    constexpr float Y() const { return m_vec.y; }
+    constexpr float Z() const { return m_vec.z; }
+
+    constexpr float Magnitude() const { return Sqrt(MagnitudeSquared()); }
+    constexpr float MagnitudeSquared() const
+    {
+        return m_vec.x * m_vec.x + m_vec.y * m_vec.y + m_vec.z * m_vec.z;
+    }
+
+    static constexpr Vector3Common Add(Vector3Common a, Vector3Common b)
+    {
+        return Vector3Common(a.m_vec.x + b.m_vec.x, a.m_vec.y + b.m_vec.y, a.m_vec.z + b.m_vec.z);
+    }
+
+    static constexpr Vector3Common Subtract(Vector3Common a, Vector3Common b)
+    {
+        return Vector3Common(a.m_vec.x - b.m_vec.x, a.m_vec.y - b.m_vec.y, a.m_vec.z - b.m_vec.z);
+    }
+
+    static constexpr Vector3Common ScalarMultiply(Vector3Common a, float scalar)
+    {
+        return Vector3Common(a.m_vec.x * scalar, a.m_vec.y * scalar, a.m_vec.z * scalar);
+    }
+
+    static constexpr float DotProduct(Vector3Common a, Vector3Common b)
+    {
+        return a.m_vec.x * b.m_vec.x + a.m_vec.y * b.m_vec.y + a.m_vec.z * b.m_vec.z;
+    }
 
-    Vector3 AsRaylib() const;
-    LEAP_VECTOR AsLeap() const;
+    static constexpr Vector3Common CrossProduct(Vector3Common a, Vector3Common b)
+    {
+        return Vector3Common(a.m_vec.y * b.m_vec.z - a.m_vec.z * b.m_vec.y,
+                             a.m_vec.z * b.m_vec.x - a.m_vec.x * b.m_vec.z,
+                             a.m_vec.x * b.m_vec.y - a.m_vec.y * b.m_vec.x);
+    }
 
-    float X() const;
-    float Y() const;
-    float Z() const;
+    static constexpr float Angle(Vector3Common from, Vector3Common to)
+    {
+        const float crossMagnitude = CrossProduct(from, to).Magnitude();
+        const float dot = DotProduct(from, to);
+        if (std::is_constant_evaluated())
+            return static_cast<float>(Constexpr::Atan2(crossMagnitude, dot));
+        return std::atan2(crossMagnitude, dot);
+    }
 
-    float Magnitude() const;
-    float MagnitudeSquared() const;
+    static constexpr Vector3Common ProjectOntoPlane(Vector3Common vec, Vector3Common planeNormal)
+    {
+        float scaleFactor = DotProduct(vec, planeNormal);
+        scaleFactor /= planeNormal.MagnitudeSquared();
+        return Subtract(vec, ScalarMultiply(planeNormal, scaleFactor));
+    }
 
-    static Vector3Common Add(Vector3Common a, Vector3Common b);
-    static Vector3Common Subtract(Vector3Common a, Vector3Common b);
-    static Vector3Common ScalarMultiply(Vector3Common a, float scalar);
-    static float DotProduct(Vector3Common a, Vector3Common b);
-    static Vector3Common CrossProduct(Vector3Common a, Vector3Common b);
-    static float Angle(Vector3Common from, Vector3Common to);
+    static constexpr Vector3Common ProjectOntoXYPlane(Vector3Common vec)
+    {
+        return Vector3Common(vec.m_vec.x, vec.m_vec.y, 0.0f);
+    }
 
-    static Vector3Common ProjectOntoPlane(Vector3Common vec, Vector3Common planeNormal);
-    static Vector3Common ProjectOntoXYPlane(Vector3Common vec);
-    static Vector3Common ProjectOntoXZPlane(Vector3Common vec);
-    static Vector3Common ProjectOntoYZPlane(Vector3Common vec);
+    static constexpr Vector3Common ProjectOntoXZPlane(Vector3Common vec)
+    {
+        return Vector3Common(vec.m_vec.x, 0.0f, vec.m_vec.z);
+    }
 
-    static Vector3Common Normalize(Vector3Common vec);
-    static Vector3Common SetMagnitude(Vector3Common vec, float newMagnitude);
+    static constexpr Vector3Common ProjectOntoYZPlane(Vector3Common vec)
+    {
+        return Vector3Common(0.0f, vec.m_vec.y, vec.m_vec.z);
+    }
+
+    /// @brief The zero vector is returned as it is.
+    static constexpr Vector3Common Normalize(Vector3Common vec)
+    {
+        const float magnitude = vec.Magnitude();
+        if (magnitude == 0.0f)
+            return vec;
+        return ScalarMultiply(vec, 1.0f / magnitude);
+    }
+
+    static constexpr Vector3Common SetMagnitude(Vector3Common vec, float newMagnitude)
+    {
+        return ScalarMultiply(Normalize(vec), newMagnitude);
+    }
 
    private:
     // We use the raylib Vector3 type internally so it can be passed to raymath functions
     Vector3 m_vec;
+
+    /// @brief sqrtss where there's SSE: std::sqrt gives the same answer, but checks for negative
+    ///        numbers first to set errno.
+    static constexpr float Sqrt(float x)
+    {
+        if (std::is_constant_evaluated())
+            return static_cast<float>(Constexpr::Sqrt(x));
+#ifdef VECTOR3_COMMON_SSE
+        return _mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(x)));
+#else
+        return std::sqrt(x);
+#endif
+    }
 };
 
-std::ostream& operator<<(std::ostream& stream, const Vector3Common& vec);
-std::ostream& operator<<(std::ostream& stream, const Vector3& vec);
-std::ostream& operator<<(std::ostream& stream, const LEAP_VECTOR& vec);
+inline std::ostream& operator<<(std::ostream& stream, const Vector3Common& vec)
+{
+    stream << "(x=" << vec.X() << ", y=" << vec.Y() << ", z=" << vec.Z() << ")";
+    return stream;
+}
+
+inline std::ostream& operator<<(std::ostream& stream, const Vector3& vec)
+{
+    stream << Vector3Common(vec);
+    return stream;
+}
+
+inline std::ostream& operator<<(std::ostream& stream, const LEAP_VECTOR& vec)
+{
+    stream << Vector3Common(vec);
+    return stream;
+}
 
 }  // namespace Math
\ No newline at end of file
@@ -40,7 +40,7 @@ int main()
     {
         Visualization::UpdateCamera(camera);
 
-        LEAP_TRACKING_EVENT *leapFrame = connection.GetFrame();
+        const Input::Leap::TrackingFrame leapFrame = connection.GetFrame();
 
         BeginDrawing();
         std::stringstream ss;
@@ -54,28 +54,13 @@ int main()
 
         std::optional<Input::Leap::ProcessedHandState> currentState = std::nullopt;
 
-        for (int i = 0; i < leapFrame->nHands; i++)
+        for (uint32_t i = 0; i < leapFrame.nHands; i++)
         {
-            LEAP_HAND hand = leapFrame->pHands[i];
+            LEAP_HAND hand = leapFrame.hands[i];
             Visualization::DrawHand(hand);
 
             // load raw state
-            Input::Leap::UnprocessedHandState state{};
-
-            state.isTracking = true;
-            state.isLeft = hand.type == eLeapHandType_Left;
-            state.palmNormal = Vec3(hand.palm.normal);
-            state.handDirection = Vec3(hand.palm.direction);
-
-            for (int i = 1; i < 5; i++)
-            {
-                LEAP_DIGIT finger = hand.digits[i];
-                Vec3 distalTip(finger.distal.next_joint);
-                Vec3 distalBase(finger.distal.prev_joint);
-
-                // direction of the distal bone of the finger
-                state.fingerDirections[i - 1] = Vec3::Subtract(distalTip, distalBase);
-            }
+            Input::Leap::UnprocessedHandState state = Input::Leap::ToUnprocessedHandState(hand);
 
             Input::Leap::ProcessedHandState processed = Input::Leap::ProcessHandState(state);
             currentState = processed;
@@ -0,0 +1,129 @@
+#include <Helpers/Clock.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#endif
+
+// Per-call cost of Helpers::Clock against the clocks it is built on, single threaded and with
+// every hardware thread reading at once, plus a check that its timestamps never go backwards.
+
+constexpr int NUM_CALLS = 10'000'000;
+
+// keeps the compiler from dropping the calls being timed
+std::atomic<uint64_t> sink{0};
+
+template <typename Fn>
+void Run(const char* name, Fn&& read)
+{
+    uint64_t sum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_CALLS; i++)
+        sum += read();
+    auto end = std::chrono::steady_clock::now();
+    sink.fetch_add(sum, std::memory_order_relaxed);
+
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << name << ": " << static_cast<double>(nanos) / NUM_CALLS << " ns/call\n";
+}
+
+#ifdef _WIN32
+// What Logging::GetCurrentUnixTimeMillis used to do.
+uint64_t LegacyUnixTimeMillis()
+{
+    static constexpr uint64_t windowsEpochToUnixEpochMillis = 11644473600000;
+
+    FILETIME filetime;
+    GetSystemTimeAsFileTime(&filetime);
+
+    ULARGE_INTEGER qwFiletime;
+    qwFiletime.LowPart = filetime.dwLowDateTime;
+    qwFiletime.HighPart = filetime.dwHighDateTime;
+    return static_cast<uint64_t>(qwFiletime.QuadPart) / 10000 - windowsEpochToUnixEpochMillis;
+}
+#endif
+
+/// @brief Reads the clock NUM_CALLS times on each thread.
+/// @return The number of times a thread saw a timestamp smaller than its previous one.
+uint64_t RunThreaded(unsigned numThreads)
+{
+    std::atomic<uint64_t> numBackwards{0};
+    std::vector<std::thread> threads;
+
+    auto start = std::chrono::steady_clock::now();
+    for (unsigned t = 0; t < numThreads; t++)
+    {
+        threads.emplace_back(
+            [&numBackwards]
+            {
+                uint64_t previous = Helpers::Clock::NowUnixMicros();
+                uint64_t backwards = 0;
+                for (int i = 0; i < NUM_CALLS; i++)
+                {
+                    const uint64_t now = Helpers::Clock::NowUnixMicros();
+                    backwards += now < previous;
+                    previous = now;
+                }
+                numBackwards.fetch_add(backwards);
+            });
+    }
+    for (auto& thread : threads)
+        thread.join();
+    auto end = std::chrono::steady_clock::now();
+
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << "Clock::NowUnixMicros, " << numThreads
+              << " threads: " << static_cast<double>(nanos) / NUM_CALLS << " ns/call per thread\n";
+    return numBackwards.load();
+}
+
+int main()
+{
+    using namespace std::chrono;
+
+    Run("steady_clock::now", [] { return steady_clock::now().time_since_epoch().count(); });
+    Run("system_clock::now", [] { return system_clock::now().time_since_epoch().count(); });
+#ifdef _WIN32
+    Run("GetSystemTimeAsFileTime (old logger timestamps)", LegacyUnixTimeMillis);
+#endif
+    Run("Clock::NowUnixMicros", Helpers::Clock::NowUnixMicros);
+
+    // smallest step between two different timestamps
+    uint64_t resolution = UINT64_MAX;
+    uint64_t previous = Helpers::Clock::NowUnixMicros();
+    for (int i = 0; i < NUM_CALLS / 10; i++)
+    {
+        const uint64_t now = Helpers::Clock::NowUnixMicros();
+        if (now != previous && now - previous < resolution)
+            resolution = now - previous;
+        previous = now;
+    }
+    std::cout << "Clock::NowUnixMicros resolution: " << resolution << " us\n";
+
+    const unsigned numThreads = std::max(2u, std::thread::hardware_concurrency());
+    const uint64_t numBackwards = RunThreaded(numThreads);
+
+    const int64_t offsetMicros =
+        static_cast<int64_t>(Helpers::Clock::NowUnixMicros()) -
+        duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+    const Helpers::Clock::Stats stats = Helpers::Clock::GetStats();
+    std::cout << "Offset from system_clock: " << offsetMicros << " us\n"
+              << "Drift corrections: " << stats.numCorrections << ", largest "
+              << stats.maxAbsErrorMicros << " us, " << stats.numIgnoredSteps
+              << " wall clock steps not followed\n";
+
+    if (numBackwards != 0)
+    {
+        std::cout << "FAIL: timestamps went backwards " << numBackwards << " times\n";
+        return 1;
+    }
+    std::cout << "OK: timestamps were monotonic on every thread\n";
+    return 0;
+}
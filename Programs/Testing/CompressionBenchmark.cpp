@@ -0,0 +1,139 @@
+#include "../UserStudy/BinaryLog.hpp"
+#include "../UserStudy/LogArena.hpp"
+#include "../UserStudy/LogCompression.hpp"
+#include "../UserStudy/Logging.hpp"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Measures the log compressor on recorded logs (pass them as arguments),
+// or on a synthetic session that looks like one if no logs are given.
+// Logs are cut into blocks the size of a writer flush, like the logger does.
+
+constexpr int NUM_ROUNDS = 5;
+constexpr size_t BLOCK_SIZES[] = {16 * 1024, 32 * 1024, 128 * 1024};
+
+std::string ReadLog(const char* filename)
+{
+    std::ifstream file(filename, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!Logging::IsCompressedLog(contents))
+        return contents;
+
+    // benchmark on what the compressor would actually see
+    file.clear();
+    file.seekg(0);
+    Logging::DecompressingStreamBuf decompressor(file);
+    return std::string((std::istreambuf_iterator<char>(&decompressor)),
+                       std::istreambuf_iterator<char>());
+}
+
+// 60 Hz cursor samples with bursts of typing, the bulk of a real session
+std::string MakeSyntheticLog(Logging::LogFormat format)
+{
+    std::mt19937 rng(42);
+    Logging::LogArena arena;
+    Logging::BinaryBatchEncoder encoder;
+    if (format == Logging::LogFormat::Binary)
+        Logging::AppendBinaryLogHeader(arena);
+
+    uint64_t timestamp = 1700000000000;
+    int x = 960, y = 540;
+    for (int i = 0; i < 1'000'000; i++)
+    {
+        Logging::EventRecord record;
+        if (rng() % 10 == 0)
+        {
+            const std::string key(1, static_cast<char>('a' + rng() % 26));
+            record = Logging::ToRecord(Logging::Events::Keystroke{timestamp, key, rng() % 20 != 0});
+        }
+        else
+        {
+            x += static_cast<int>(rng() % 7) - 3;
+            y += static_cast<int>(rng() % 7) - 3;
+            record = Logging::ToRecord(Logging::Events::CursorPosition{timestamp, x, y});
+        }
+        timestamp += 16 + rng() % 2;
+
+        if (format == Logging::LogFormat::Binary)
+        {
+            encoder.Append(record);
+            if (encoder.EventCount() == Logging::FLUSH_EVENT_THRESHOLD)
+                encoder.EncodeAndClear(arena);
+        }
+        else
+        {
+            Logging::SerializeRecord(record, arena);
+            arena.Append(Logging::LINE_TERMINATOR);
+        }
+    }
+    encoder.EncodeAndClear(arena);
+    return std::string(arena.View());
+}
+
+void RunBenchmark(const std::string& name, const std::string& log)
+{
+    for (size_t blockSize : BLOCK_SIZES)
+    {
+        Logging::LogCompressor compressor;
+        Logging::LogArena compressed(log.size() + log.size() / 8 + 1024);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < NUM_ROUNDS; round++)
+        {
+            compressed.Clear();
+            Logging::AppendCompressedLogHeader(compressed);
+            for (size_t offset = 0; offset < log.size(); offset += blockSize)
+                compressor.CompressBlock(std::string_view(log).substr(offset, blockSize),
+                                         compressed);
+        }
+        auto compressTime = std::chrono::steady_clock::now() - start;
+
+        std::string roundTrip;
+        start = std::chrono::steady_clock::now();
+        for (int round = 0; round < NUM_ROUNDS; round++)
+        {
+            roundTrip.clear();
+            std::istringstream stream(std::string(compressed.View()));
+            Logging::CompressedLogReader reader(stream);
+            reader.ReadHeader();
+            std::string_view block;
+            while (reader.NextBlock(block))
+                roundTrip += block;
+        }
+        auto decompressTime = std::chrono::steady_clock::now() - start;
+
+        auto megabytesPerSecond = [&log](std::chrono::steady_clock::duration time)
+        {
+            const double seconds = std::chrono::duration<double>(time).count() / NUM_ROUNDS;
+            return static_cast<double>(log.size()) / (1024.0 * 1024.0) / seconds;
+        };
+
+        std::cout << name << ", " << blockSize / 1024 << " KiB blocks: ratio "
+                  << static_cast<double>(log.size()) / compressed.Size() << ", compress "
+                  << megabytesPerSecond(compressTime) << " MB/s, decompress "
+                  << megabytesPerSecond(decompressTime) << " MB/s"
+                  << (roundTrip == log ? "" : " [ROUND TRIP MISMATCH]") << "\n";
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 1)
+    {
+        for (int i = 1; i < argc; i++)
+            RunBenchmark(argv[i], ReadLog(argv[i]));
+        return 0;
+    }
+
+    std::cout << "No logs given, using a synthetic 1M event session.\n";
+    RunBenchmark("synthetic text", MakeSyntheticLog(Logging::LogFormat::Text));
+    RunBenchmark("synthetic binary", MakeSyntheticLog(Logging::LogFormat::Binary));
+    return 0;
+}
@@ -0,0 +1,223 @@
+#include "../UserStudy/BinaryLog.hpp"
+#include "../UserStudy/CursorStream.hpp"
+#include "../UserStudy/LogArena.hpp"
+#include "../UserStudy/Logging.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+// How much smaller a typing-dominant participant log gets when the cursor samples are logged as
+// a cursor stream (see CursorStream.hpp) instead of one CursorPosition per sample, in both log
+// formats and at the lowest and highest sampling rates. Then a check that expanding the stream
+// gives back every sample.
+
+// one task field: move the cursor over to it, click, type for a while
+constexpr int NUM_FIELDS = 60;
+constexpr uint64_t MOVE_MILLIS = 600;
+constexpr uint64_t TYPING_MILLIS = 10'000;
+constexpr uint64_t KEYSTROKE_INTERVAL_MILLIS = 250;
+
+constexpr uint64_t START_MILLIS = 1'700'000'000'000;
+
+struct Sample
+{
+    uint64_t timestampMillis;
+    int positionX;
+    int positionY;
+};
+
+struct Trace
+{
+    std::vector<Sample> samples;
+    std::vector<Logging::EventRecord> otherEvents;  // clicks, keystrokes, field completions
+};
+
+Trace MakeTrace(uint32_t rateHz)
+{
+    Trace trace;
+    const uint64_t fieldMillis = MOVE_MILLIS + TYPING_MILLIS;
+    const uint64_t numSamples = NUM_FIELDS * fieldMillis * rateHz / 1000;
+    int x = 400;
+    int y = 300;
+    for (uint64_t i = 0; i < numSamples; i++)
+    {
+        // sample times as the scheduler stamps them: whole milliseconds
+        const uint64_t sinceStart = i * 1000 / rateHz;
+        const uint64_t intoField = sinceStart % fieldMillis;
+        if (intoField < MOVE_MILLIS)
+        {
+            x += 3;
+            y -= (i % 3 == 0);
+        }
+        trace.samples.push_back({START_MILLIS + sinceStart, x, y});
+    }
+
+    for (int field = 0; field < NUM_FIELDS; field++)
+    {
+        const uint64_t fieldStart = START_MILLIS + field * fieldMillis;
+        trace.otherEvents.push_back(Logging::ToRecord(Logging::Events::Click{
+            .timestampMillis = fieldStart + MOVE_MILLIS,
+            .location = Logging::Events::ClickLocation::TextField,
+            .wasCorrect = true}));
+        for (uint64_t t = KEYSTROKE_INTERVAL_MILLIS; t < TYPING_MILLIS;
+             t += KEYSTROKE_INTERVAL_MILLIS)
+        {
+            trace.otherEvents.push_back(Logging::ToRecord(Logging::Events::Keystroke{
+                .timestampMillis = fieldStart + MOVE_MILLIS + t, .key = "e", .wasCorrect = true}));
+        }
+        trace.otherEvents.push_back(Logging::ToRecord(Logging::Events::FieldCompletion{
+            .timestampMillis = fieldStart + fieldMillis - 1, .fieldIndex = field}));
+    }
+    return trace;
+}
+
+/// @brief What the logger writes: everything merged by timestamp.
+std::vector<Logging::EventRecord> MergeByTimestamp(std::vector<Logging::EventRecord> cursor,
+                                                   const std::vector<Logging::EventRecord>& other)
+{
+    cursor.insert(cursor.end(), other.begin(), other.end());
+    std::stable_sort(cursor.begin(), cursor.end(),
+                     [](const Logging::EventRecord& a, const Logging::EventRecord& b)
+                     { return a.timestampMillis < b.timestampMillis; });
+    return cursor;
+}
+
+size_t TextSize(const std::vector<Logging::EventRecord>& log)
+{
+    Logging::LogArena arena;
+    for (const Logging::EventRecord& record : log)
+    {
+        Logging::SerializeRecord(record, arena);
+        arena.Append(Logging::LINE_TERMINATOR);
+    }
+    return arena.Size();
+}
+
+/// @brief One batch per FLUSH_INTERVAL of events, like the logger's writer thread.
+size_t BinarySize(const std::vector<Logging::EventRecord>& log)
+{
+    Logging::LogArena arena;
+    Logging::AppendBinaryLogHeader(arena);
+    Logging::BinaryBatchEncoder encoder;
+    uint64_t batchStart = log.empty() ? 0 : log.front().timestampMillis;
+    for (const Logging::EventRecord& record : log)
+    {
+        if (record.timestampMillis - batchStart >=
+            static_cast<uint64_t>(Logging::FLUSH_INTERVAL.count()))
+        {
+            encoder.EncodeAndClear(arena);
+            batchStart = record.timestampMillis;
+        }
+        encoder.Append(record);
+    }
+    encoder.EncodeAndClear(arena);
+    return arena.Size();
+}
+
+/// @return Whether the expanded log is the raw log, give or take a millisecond per sample.
+bool MatchesExpansion(const std::vector<Logging::EventRecord>& raw,
+                      const std::vector<Logging::EventRecord>& expanded)
+{
+    auto isCursor = [](const Logging::EventRecord& r)
+    { return r.type == Logging::EventType::CursorPosition; };
+
+    std::vector<Logging::EventRecord> rawCursor, rawOther, expandedCursor, expandedOther;
+    for (const auto& r : raw)
+        (isCursor(r) ? rawCursor : rawOther).push_back(r);
+    for (const auto& r : expanded)
+        (isCursor(r) ? expandedCursor : expandedOther).push_back(r);
+
+    if (rawCursor.size() != expandedCursor.size() || rawOther.size() != expandedOther.size())
+        return false;
+    for (size_t i = 0; i < rawCursor.size(); i++)
+    {
+        const auto& a = rawCursor[i];
+        const auto& b = expandedCursor[i];
+        const uint64_t error = a.timestampMillis > b.timestampMillis
+                                   ? a.timestampMillis - b.timestampMillis
+                                   : b.timestampMillis - a.timestampMillis;
+        if (a.valueA != b.valueA || a.valueB != b.valueB || error > 1)
+            return false;
+    }
+    for (size_t i = 0; i < rawOther.size(); i++)
+    {
+        if (rawOther[i].type != expandedOther[i].type ||
+            rawOther[i].timestampMillis != expandedOther[i].timestampMillis)
+            return false;
+    }
+    return std::is_sorted(expanded.begin(), expanded.end(),
+                          [](const Logging::EventRecord& a, const Logging::EventRecord& b)
+                          { return a.timestampMillis < b.timestampMillis; });
+}
+
+bool Run(uint32_t rateHz)
+{
+    const Trace trace = MakeTrace(rateHz);
+
+    std::vector<Logging::EventRecord> rawCursor;
+    for (const Sample& s : trace.samples)
+    {
+        rawCursor.push_back(Logging::ToRecord(Logging::Events::CursorPosition{
+            .timestampMillis = s.timestampMillis,
+            .positionX = s.positionX,
+            .positionY = s.positionY}));
+    }
+
+    std::vector<Logging::EventRecord> streamCursor;
+    Logging::CursorStreamEncoder encoder(rateHz);
+    auto log = [&streamCursor](const auto& event)
+    { streamCursor.push_back(Logging::ToRecord(event)); };
+    auto start = std::chrono::steady_clock::now();
+    for (const Sample& s : trace.samples)
+        encoder.AddSample(s.timestampMillis, s.positionX, s.positionY, log);
+    encoder.Flush(log);
+    auto end = std::chrono::steady_clock::now();
+
+    const auto raw = MergeByTimestamp(rawCursor, trace.otherEvents);
+    const auto stream = MergeByTimestamp(streamCursor, trace.otherEvents);
+
+    std::vector<Logging::EventRecord> expanded;
+    Logging::CursorStreamDecoder decoder;
+    auto collect = [&expanded](const Logging::EventRecord& r) { expanded.push_back(r); };
+    for (const Logging::EventRecord& record : stream)
+        decoder.Push(record, collect);
+    decoder.Finish(collect);
+
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << rateHz << "Hz, " << trace.samples.size() << " cursor samples ("
+              << static_cast<double>(nanos) / trace.samples.size() << " ns/sample to encode)\n";
+
+    auto report = [](const char* name, size_t before, size_t after)
+    {
+        std::cout << "    " << name << before << " -> " << after << " ("
+                  << static_cast<double>(before) / after << "x smaller)\n";
+    };
+    report("cursor events:      ", trace.samples.size(), streamCursor.size());
+    report("cursor text bytes:  ", TextSize(rawCursor),
+           TextSize(streamCursor));
+    report("log text bytes:     ", TextSize(raw), TextSize(stream));
+    report("log binary bytes:   ", BinarySize(raw), BinarySize(stream));
+
+    const bool isMatch = MatchesExpansion(raw, expanded);
+    std::cout << "    expanded back to " << expanded.size() << " events: "
+              << (isMatch ? "matches" : "DOES NOT MATCH") << " the per-sample log\n";
+    return isMatch;
+}
+
+int main()
+{
+    bool isOk = true;
+    for (uint32_t rateHz : {30u, 1000u})
+        isOk &= Run(rateHz);
+    if (!isOk)
+    {
+        std::cout << "FAIL: expanding the cursor stream did not give back every sample\n";
+        return 1;
+    }
+    std::cout << "OK: every sample was recovered\n";
+    return 0;
+}
@@ -0,0 +1,200 @@
+#include "../UserStudy/BinaryLog.hpp"
+#include "../UserStudy/Logging.hpp"
+
+#include <Helpers/Clock.hpp>
+#include <Helpers/FixedRateScheduler.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Whether logging the gesture driver's input events disturbs its 1ms loop: the same paced loop
+// with and without three TryLog calls a tick (a pose check, a move and the accumulator), comparing
+// wakeup jitter and the time spent logging. Then a check that every driver event comes back out
+// of the log, in both formats, and that a reader from before the driver events refuses a binary
+// log that can hold them.
+
+constexpr uint32_t DRIVER_RATE_HZ = 1000;
+constexpr int NUM_TICKS = 5000;
+constexpr const char* LOG_FILENAME = "driverLoggingBenchmark.log";
+
+struct LoopResult
+{
+    Helpers::FixedRateScheduler::Stats scheduling;
+    std::vector<uint64_t> logNanos;  // per tick, sorted
+    uint64_t numDropped;
+};
+
+LoopResult RunLoop(Logging::Logger* logger)
+{
+    using namespace Logging::Events;
+
+    if (logger)
+        logger->ReserveLane();
+
+    LoopResult result{};
+    Helpers::FixedRateScheduler scheduler(DRIVER_RATE_HZ);
+    for (int tick = 0; tick < NUM_TICKS; tick++)
+    {
+        const auto frameStart = scheduler.WaitForNextTick();
+        if (!logger)
+            continue;
+
+        const uint64_t frameMillis = Helpers::Clock::ToUnixMillis(frameStart);
+        const auto logStart = std::chrono::steady_clock::now();
+        bool isLogged = true;
+        if (tick % 500 == 0)
+            isLogged &= logger->TryLog(DriverPose{frameMillis, tick % 1000 ? HandPose::Move
+                                                                            : HandPose::Click});
+        isLogged &= logger->TryLog(DriverMove{frameMillis, 1, tick % 3 - 1});
+        isLogged &= logger->TryLog(DriverAccumulator{frameMillis, tick % 1000, -(tick % 700)});
+        const auto logEnd = std::chrono::steady_clock::now();
+
+        result.logNanos.push_back(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(logEnd - logStart).count());
+        result.numDropped += !isLogged;
+    }
+
+    result.scheduling = scheduler.GetStats();
+    std::sort(result.logNanos.begin(), result.logNanos.end());
+    return result;
+}
+
+void PrintResult(const char* name, const LoopResult& result)
+{
+    const auto& stats = result.scheduling;
+    const double meanJitterMicros =
+        static_cast<double>(stats.totalJitterNanos) / std::max<uint64_t>(stats.numTicks, 1) / 1000;
+    std::cout << name << ": jitter mean " << meanJitterMicros << " us, max "
+              << stats.maxJitterNanos / 1000.0 << " us, " << stats.numLateTicks << " late, "
+              << stats.numMissedTicks << " skipped\n";
+
+    const auto& nanos = result.logNanos;
+    if (!nanos.empty())
+    {
+        // the tail is mostly the thread being preempted, not the logging itself
+        std::cout << "    logging per tick: median " << nanos[nanos.size() / 2] << " ns, 99th "
+                  << nanos[nanos.size() * 99 / 100] << " ns, max " << nanos.back() << " ns, "
+                  << result.numDropped << " ticks dropped events\n";
+    }
+}
+
+/// @brief Counts the driver events in a text log, or a binary one converted back to records.
+std::vector<size_t> CountDriverEvents(const char* filename, Logging::LogFormat format)
+{
+    std::vector<size_t> counts(Logging::NUM_EVENT_TYPES, 0);
+    std::ifstream file(filename, std::ios::binary);
+    if (format == Logging::LogFormat::Text)
+    {
+        std::string line;
+        Logging::EventRecord record;
+        while (std::getline(file, line))
+        {
+            if (Logging::ParseRecord(line, record))
+                counts[static_cast<size_t>(record.type)]++;
+        }
+        return counts;
+    }
+
+    Logging::BinaryLogReader reader(file);
+    Logging::DecodedBatch batch;
+    if (!reader.ReadHeader())
+        return counts;
+    while (reader.NextBatch(batch))
+        batch.ForEachInOrder([&counts](const Logging::EventRecord& record)
+                             { counts[static_cast<size_t>(record.type)]++; });
+    return counts;
+}
+
+bool CheckRoundTrip(Logging::LogFormat format)
+{
+    using namespace Logging::Events;
+
+    Logging::LoggerConfig config{};
+    config.format = format;
+    {
+        Logging::Logger logger(LOG_FILENAME, config);
+        for (uint64_t t = 0; t < 100; t++)
+        {
+            logger.Log(DriverPose{1000 + t, t % 2 ? HandPose::Move : HandPose::NoHand});
+            logger.Log(DriverMove{1000 + t, static_cast<int>(t), -static_cast<int>(t)});
+            logger.Log(DriverClick{1000 + t});
+            logger.Log(DriverAccumulator{1000 + t, 999, -999});
+        }
+    }
+
+    const std::vector<size_t> counts = CountDriverEvents(LOG_FILENAME, format);
+    std::remove(LOG_FILENAME);
+    std::remove(Logging::GetManifestFilename(LOG_FILENAME).c_str());
+
+    for (Logging::EventType type :
+         {Logging::EventType::DriverMove, Logging::EventType::DriverClick,
+          Logging::EventType::DriverPose, Logging::EventType::DriverAccumulator})
+    {
+        if (counts[static_cast<size_t>(type)] != 100)
+            return false;
+    }
+    return true;
+}
+
+/// @brief Writes a binary log with a driver event in it, and reads its header back with a reader
+///        of this build and one that only knows up to version 2.
+/// @return Whether this build's reader accepted it and the version-2 reader refused it.
+bool CheckOlderReaderRefuses()
+{
+    Logging::LoggerConfig config{};
+    config.format = Logging::LogFormat::Binary;
+    {
+        Logging::Logger logger(LOG_FILENAME, config);
+        logger.Log(Logging::Events::DriverClick{1000});
+    }
+
+    bool isAccepted;
+    bool isRefused;
+    {
+        std::ifstream file(LOG_FILENAME, std::ios::binary);
+        Logging::BinaryLogReader reader(file);
+        isAccepted = reader.ReadHeader() && reader.Version() == Logging::BINARY_LOG_VERSION;
+    }
+    {
+        std::ifstream file(LOG_FILENAME, std::ios::binary);
+        Logging::BinaryLogReader reader(file, 2);
+        isRefused = !reader.ReadHeader() && reader.HasError();
+    }
+    std::remove(LOG_FILENAME);
+    std::remove(Logging::GetManifestFilename(LOG_FILENAME).c_str());
+    return isAccepted && isRefused;
+}
+
+int main()
+{
+    PrintResult("without input logging", RunLoop(nullptr));
+    {
+        Logging::Logger logger(LOG_FILENAME);
+        PrintResult("with input logging", RunLoop(&logger));
+    }
+    std::remove(LOG_FILENAME);
+    std::remove(Logging::GetManifestFilename(LOG_FILENAME).c_str());
+
+    const bool isTextOk = CheckRoundTrip(Logging::LogFormat::Text);
+    const bool isBinaryOk = CheckRoundTrip(Logging::LogFormat::Binary);
+    if (!isTextOk || !isBinaryOk)
+    {
+        std::cout << "FAIL: driver events were lost from the " << (isTextOk ? "binary" : "text")
+                  << " log\n";
+        return 1;
+    }
+    if (!CheckOlderReaderRefuses())
+    {
+        std::cout << "FAIL: a version-2 reader didn't refuse a version-"
+                  << Logging::BINARY_LOG_VERSION << " log\n";
+        return 1;
+    }
+    std::cout << "OK: every driver event was written to both log formats, and a version-2 "
+                 "reader refuses the binary log\n";
+    return 0;
+}
@@ -0,0 +1,144 @@
+#include <Input/FrameCapture.hpp>
+#include <Input/FrameRecorder.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+
+// How much recording the tracking stream costs the polling thread: records a stream of synthetic
+// LEAP_TRACKING_EVENTs into a capture sized for all but the last few of them, timing every Record
+// call, those that have to drop their frame included. The events come at FRAME_RATE_HZ, far
+// faster than LeapC tracks, but slow enough that the recorder's prefaulting thread has time to
+// run. Then reads the capture back, checking every frame and timing seeks.
+// Needs LeapC.h but neither the LeapC library nor the device.
+
+constexpr const char* CAPTURE_FILENAME = "frameRecorderBenchmark.frames";
+constexpr size_t NUM_FRAMES = 10'000;
+constexpr int FRAME_RATE_HZ = 2'000;
+constexpr std::chrono::nanoseconds FRAME_PERIOD{1'000'000'000 / FRAME_RATE_HZ};
+constexpr size_t NUM_OVERFLOW_FRAMES = 100;  // recorded once the capture is full
+constexpr int64_t MAX_P99_NANOS = 5'000;
+constexpr int64_t MAX_NANOS = 1'000'000;  // being preempted, but not a page fault or a remap
+constexpr size_t NUM_SEEKS = 100'000;
+
+void MakeEvent(size_t i, LEAP_TRACKING_EVENT& event, LEAP_HAND* hands)
+{
+    event.info.timestamp = 1'000'000 + static_cast<int64_t>(i) * 8'333;
+    event.tracking_frame_id = static_cast<int64_t>(i);
+    event.framerate = 120.0f;
+    event.nHands = i % 3;
+    for (uint32_t h = 0; h < event.nHands; h++)
+    {
+        hands[h].id = static_cast<uint32_t>(i * 2 + h);
+        hands[h].type = h == 0 ? eLeapHandType_Right : eLeapHandType_Left;
+        hands[h].palm.position.x = static_cast<float>(i);
+        hands[h].digits[1].distal.next_joint.y = -static_cast<float>(i);
+    }
+    event.pHands = hands;
+}
+
+bool IsSameFrame(const Input::Leap::TrackingFrame& frame, size_t i)
+{
+    LEAP_TRACKING_EVENT event{};
+    LEAP_HAND hands[Input::Leap::MAX_TRACKED_HANDS]{};
+    MakeEvent(i, event, hands);
+    if (frame.trackingFrameId != event.tracking_frame_id ||
+        frame.timestampMicros != event.info.timestamp || frame.nHands != event.nHands)
+        return false;
+    for (uint32_t h = 0; h < frame.nHands; h++)
+    {
+        if (frame.hands[h].id != hands[h].id ||
+            frame.hands[h].palm.position.x != hands[h].palm.position.x ||
+            frame.hands[h].digits[1].distal.next_joint.y != hands[h].digits[1].distal.next_joint.y)
+            return false;
+    }
+    return true;
+}
+
+int main()
+{
+    // events are made up front so only Record is timed
+    std::vector<LEAP_TRACKING_EVENT> events(NUM_FRAMES + NUM_OVERFLOW_FRAMES);
+    std::vector<LEAP_HAND> hands(events.size() * Input::Leap::MAX_TRACKED_HANDS);
+    for (size_t i = 0; i < events.size(); i++)
+        MakeEvent(i, events[i], &hands[i * Input::Leap::MAX_TRACKED_HANDS]);
+
+    Input::Leap::FrameRecorder recorder;
+    if (!recorder.Start(CAPTURE_FILENAME, NUM_FRAMES))
+    {
+        std::cout << "FAIL: unable to create " << CAPTURE_FILENAME << "\n";
+        return 1;
+    }
+
+    std::vector<int64_t> nanos;
+    nanos.reserve(events.size());
+    const auto firstFrameAt = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < events.size(); i++)
+    {
+        const LEAP_TRACKING_EVENT& event = events[i];
+        std::this_thread::sleep_until(firstFrameAt + i * FRAME_PERIOD);
+        const auto start = std::chrono::steady_clock::now();
+        recorder.Record(event);
+        const auto end = std::chrono::steady_clock::now();
+        nanos.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+    const Input::Leap::FrameRecorder::Stats stats = recorder.Stop();
+
+    std::sort(nanos.begin(), nanos.end());
+    const int64_t medianNanos = nanos[nanos.size() / 2];
+    const int64_t p99Nanos = nanos[nanos.size() * 99 / 100];
+    const int64_t maxNanos = nanos.back();
+    // the tail is the thread being preempted
+    std::cout << "recording " << events.size() << " frames (" << sizeof(Input::Leap::FrameRecord)
+              << " bytes each): median " << medianNanos << " ns, 99th " << p99Nanos
+              << " ns, max " << maxNanos << " ns, " << stats.numDropped << " dropped\n";
+
+    bool isEveryFrameSame = false;
+    double seekNanos = 0.0;
+    {
+        Input::Leap::FrameCaptureReader reader;
+        if (reader.Open(CAPTURE_FILENAME) && reader.GetNumFrames() == NUM_FRAMES)
+        {
+            isEveryFrameSame = true;
+            for (size_t i = 0; isEveryFrameSame && i < NUM_FRAMES; i++)
+                isEveryFrameSame = IsSameFrame(reader.GetFrame(i), i);
+
+            std::mt19937 rng(17);
+            std::uniform_int_distribution<size_t> index(0, NUM_FRAMES - 1);
+            int64_t checksum = 0;
+            const auto start = std::chrono::steady_clock::now();
+            for (size_t i = 0; i < NUM_SEEKS; i++)
+                checksum += reader.GetFrame(index(rng)).trackingFrameId;
+            const auto end = std::chrono::steady_clock::now();
+            seekNanos = std::chrono::duration<double, std::nano>(end - start).count() / NUM_SEEKS;
+            std::cout << "random seeks: " << seekNanos << " ns per frame (checksum " << checksum
+                      << ")\n";
+        }
+    }
+    std::remove(CAPTURE_FILENAME);
+
+    if (!isEveryFrameSame || stats.numFrames != NUM_FRAMES)
+    {
+        std::cout << "FAIL: the capture doesn't read back as the frames that were recorded\n";
+        return 1;
+    }
+    if (stats.numDropped != NUM_OVERFLOW_FRAMES)
+    {
+        std::cout << "FAIL: " << stats.numDropped << " frames were dropped, not the "
+                  << NUM_OVERFLOW_FRAMES << " past the capture's capacity\n";
+        return 1;
+    }
+    if (p99Nanos > MAX_P99_NANOS || maxNanos > MAX_NANOS)
+    {
+        std::cout << "FAIL: 1% of frames take over " << MAX_P99_NANOS
+                  << " ns to record, or one takes over " << MAX_NANOS << " ns\n";
+        return 1;
+    }
+    std::cout << "OK: every frame in capacity was recorded and reads back, the rest were "
+                 "dropped without stalling\n";
+    return 0;
+}
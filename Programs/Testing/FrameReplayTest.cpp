@@ -0,0 +1,181 @@
+#include "TestCheck.hpp"
+
+#include <Input/FrameCapture.hpp>
+#include <Input/ReplayFrameSource.hpp>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Checks that frame captures round trip, and that ReplayFrameSource hands their frames out the
+// way the gesture driver expects from the device: in order, numbered, and never blocking a waiter
+// that has been told to wake up. Needs LeapC.h but neither the LeapC library nor the device.
+
+namespace fs = std::filesystem;
+
+constexpr const char* CAPTURE_FILENAME = "frameReplayTest.frames";
+constexpr size_t NUM_FRAMES = 300;
+constexpr int64_t FRAME_INTERVAL_MICROS = 10'000;  // 100Hz
+
+using Input::Leap::TrackingFrame;
+
+std::vector<TrackingFrame> MakeFrames()
+{
+    std::vector<TrackingFrame> frames;
+    for (size_t i = 0; i < NUM_FRAMES; i++)
+    {
+        TrackingFrame frame{};
+        frame.trackingFrameId = 1000 + static_cast<int64_t>(i);
+        frame.timestampMicros = 5'000'000 + static_cast<int64_t>(i) * FRAME_INTERVAL_MICROS;
+        frame.framerate = 100.0f;
+        frame.nHands = i % 3;
+        for (uint32_t h = 0; h < frame.nHands; h++)
+        {
+            frame.hands[h].id = static_cast<uint32_t>(i * 2 + h);
+            frame.hands[h].type = h == 0 ? eLeapHandType_Right : eLeapHandType_Left;
+            frame.hands[h].palm.position.x = static_cast<float>(i);
+            frame.hands[h].digits[4].distal.next_joint.z = -static_cast<float>(i);
+        }
+        frames.push_back(frame);
+    }
+    return frames;
+}
+
+bool IsSameFrame(const TrackingFrame& a, const TrackingFrame& b)
+{
+    if (a.trackingFrameId != b.trackingFrameId || a.timestampMicros != b.timestampMicros ||
+        a.framerate != b.framerate || a.nHands != b.nHands)
+        return false;
+    for (uint32_t h = 0; h < a.nHands; h++)
+    {
+        if (a.hands[h].id != b.hands[h].id || a.hands[h].type != b.hands[h].type ||
+            a.hands[h].palm.position.x != b.hands[h].palm.position.x ||
+            a.hands[h].digits[4].distal.next_joint.z != b.hands[h].digits[4].distal.next_joint.z)
+            return false;
+    }
+    return true;
+}
+
+void TestCapture(const std::vector<TrackingFrame>& frames)
+{
+    {
+        Input::Leap::FrameCaptureReader reader;
+        Check(reader.Open(CAPTURE_FILENAME), "capture can be opened");
+        Check(reader.GetNumFrames() == frames.size(), "capture has every frame");
+        bool isEveryFrameSame = reader.GetNumFrames() == frames.size();
+        for (size_t i = 0; isEveryFrameSame && i < frames.size(); i++)
+            isEveryFrameSame = IsSameFrame(reader.GetFrame(i), frames[i]);
+        Check(isEveryFrameSame, "every frame reads back as it was written");
+    }
+
+    // a capture cut off halfway through a record has every record before it
+    const std::string truncated = std::string(CAPTURE_FILENAME) + ".truncated";
+    fs::copy_file(CAPTURE_FILENAME, truncated, fs::copy_options::overwrite_existing);
+    fs::resize_file(truncated, Input::Leap::FRAME_CAPTURE_HEADER_SIZE +
+                                   10 * sizeof(Input::Leap::FrameRecord) + 7);
+    {
+        Input::Leap::FrameCaptureReader reader;
+        Check(reader.Open(truncated) && reader.GetNumFrames() == 10,
+              "truncated capture keeps its whole records");
+    }
+    fs::remove(truncated);
+
+    const std::string notACapture = std::string(CAPTURE_FILENAME) + ".txt";
+    std::ofstream(notACapture) << "not a frame capture, but long enough to have a header\n";
+    {
+        Input::Leap::FrameCaptureReader reader;
+        Check(!reader.Open(notACapture) && !reader.Open("no such file"),
+              "files that aren't captures are rejected");
+    }
+    fs::remove(notACapture);
+}
+
+void TestUnthrottled(const std::vector<TrackingFrame>& frames)
+{
+    Input::Leap::ReplayFrameSource source(CAPTURE_FILENAME,
+                                          Input::Leap::ReplayFrameSource::UNTHROTTLED);
+    uint64_t sequence = source.GetFrameSequence();
+    size_t numSeen = 0;
+    bool isInOrder = true;
+    while (source.WaitForFrame(sequence) != sequence)
+    {
+        const TrackingFrame frame = source.GetFrame();
+        isInOrder &= frame.sequence == sequence + 1 && numSeen < frames.size() &&
+                     IsSameFrame(frame, frames[numSeen]);
+        sequence = frame.sequence;
+        numSeen++;
+    }
+    Check(isInOrder, "unthrottled replay hands out frames one at a time, in order");
+    Check(numSeen == frames.size(), "unthrottled replay hands out every frame");
+    Check(!source.IsConnected(), "unthrottled replay disconnects after the last frame");
+}
+
+void TestTimed(const std::vector<TrackingFrame>& frames)
+{
+    constexpr double SPEED = 20.0;
+    const auto start = std::chrono::steady_clock::now();
+    Input::Leap::ReplayFrameSource source(CAPTURE_FILENAME, SPEED);
+
+    uint64_t sequence = 0;
+    int64_t lastId = -1;
+    size_t numSeen = 0;
+    bool isInOrder = true;
+    while (source.IsConnected() || source.GetFrameSequence() != sequence)
+    {
+        sequence = source.WaitForFrame(sequence);
+        const TrackingFrame frame = source.GetFrame();
+        if (frame.sequence == 0)
+            continue;
+        isInOrder &= frame.trackingFrameId > lastId && frame.sequence <= frames.size() &&
+                     IsSameFrame(frame, frames[frame.sequence - 1]);
+        lastId = frame.trackingFrameId;
+        numSeen++;
+    }
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    const double recordedSeconds = (NUM_FRAMES - 1) * FRAME_INTERVAL_MICROS / 1e6;
+
+    std::cout << "timed replay at " << SPEED << "x: saw " << numSeen << " of " << frames.size()
+              << " frames in " << seconds << " s (" << recordedSeconds / SPEED << " s expected)"
+              << std::endl;
+    Check(isInOrder, "timed replay hands out numbered frames, in order");
+    Check(lastId == frames.back().trackingFrameId, "timed replay gets to the last frame");
+    Check(seconds >= recordedSeconds / SPEED, "timed replay doesn't run ahead of the recording");
+    Check(seconds < recordedSeconds / SPEED + 1.0, "timed replay keeps up with the recording");
+}
+
+void TestWake()
+{
+    // slow enough that the second frame never comes
+    Input::Leap::ReplayFrameSource source(CAPTURE_FILENAME, 1e-6, true);
+    while (source.GetFrameSequence() == 0)
+        std::this_thread::yield();
+
+    std::thread waker(
+        [&source]
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            source.WakeFrameWaiters();
+        });
+    const uint64_t latest = source.WaitForFrame(1);
+    waker.join();
+    Check(latest == 1 && source.IsConnected(), "WakeFrameWaiters cuts a wait short");
+}
+
+int main()
+{
+    const std::vector<TrackingFrame> frames = MakeFrames();
+    Check(Input::Leap::WriteFrameCapture(CAPTURE_FILENAME, frames), "capture can be written");
+
+    TestCapture(frames);
+    TestUnthrottled(frames);
+    TestTimed(frames);
+    TestWake();
+    fs::remove(CAPTURE_FILENAME);
+
+    return FinishChecks();
+}
@@ -0,0 +1,234 @@
+#include <Input/FrameCapture.hpp>
+#include <Input/GestureClassifier.hpp>
+#include <Input/LeapMotionGestureProvider.hpp>
+#include <Input/SyntheticHands.hpp>
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+// Every GestureClassifierType over the same hands, one entry each: how fast it classifies, and how
+// often it clicks and changes what the cursor does. The hands are noisy synthetic ones, or the
+// frame captures given on the command line, replayed the way the driver would see them.
+// The study classifier has to decide exactly what ProcessHandState and the driver's old click
+// latch did, on every frame. Needs LeapC.h and raymath.h but neither the LeapC library nor the
+// device.
+
+using namespace Input::Leap;
+
+constexpr size_t NUM_SYNTHETIC_FRAMES = 1'000'000;
+constexpr float SYNTHETIC_FRAME_SECONDS = 1.0f / 120.0f;
+constexpr float NOISE_RADIANS = 0.05f;
+constexpr float MAX_FRAME_SECONDS = 0.05f;  // as in DriverLoop
+constexpr int NUM_RUNS = 3;                 // the fastest is reported
+
+struct Frame
+{
+    bool hasHand;
+    UnprocessedHandState hand;
+    float seconds;  // since the previous frame
+};
+
+struct Results
+{
+    std::vector<GestureDecision> decisions;  // a decision with no pose for frames with no hand
+    double bestSeconds;
+
+    /// @brief 0 no pose, 1 click pose, 2 and up a cursor direction, as in HandFilterBenchmark.
+    static uint32_t GetKey(const ProcessedHandState& state)
+    {
+        if (state.isInClickPose)
+            return 1;
+        if (state.cursorDirectionX == 0.0f && state.cursorDirectionY == 0.0f)
+            return 0;
+        const float angle = std::atan2(state.cursorDirectionX, state.cursorDirectionY) + Math::_PI;
+        return 2 + static_cast<uint32_t>(std::lround(angle * 1000.0f));
+    }
+
+    uint64_t CountClicks() const
+    {
+        return std::count_if(decisions.begin(), decisions.end(),
+                             [](const GestureDecision& decision) { return decision.shouldClick; });
+    }
+
+    uint64_t CountChanges() const
+    {
+        uint64_t numChanges = 0;
+        for (size_t i = 1; i < decisions.size(); i++)
+            numChanges += GetKey(decisions[i].hand) != GetKey(decisions[i - 1].hand);
+        return numChanges;
+    }
+};
+
+bool IsSameDecision(const GestureDecision& a, const GestureDecision& b)
+{
+    auto bits = [](float value) { return std::bit_cast<uint32_t>(value); };
+    return a.shouldClick == b.shouldClick && a.hand.isInClickPose == b.hand.isInClickPose &&
+           bits(a.hand.cursorDirectionX) == bits(b.hand.cursorDirectionX) &&
+           bits(a.hand.cursorDirectionY) == bits(b.hand.cursorDirectionY) &&
+           bits(a.hand.averageFingerDirectionX) == bits(b.hand.averageFingerDirectionX) &&
+           bits(a.hand.averageFingerDirectionY) == bits(b.hand.averageFingerDirectionY);
+}
+
+std::vector<Frame> MakeSyntheticFrames()
+{
+    SyntheticHandConfig config{};
+    config.noiseRadians = NOISE_RADIANS;
+    SyntheticHandGenerator generator(config);
+
+    std::vector<Frame> frames(NUM_SYNTHETIC_FRAMES);
+    for (Frame& frame : frames)
+    {
+        frame.hasHand = true;
+        frame.hand = ToUnprocessedHandState(generator.NextHand());
+        frame.seconds = SYNTHETIC_FRAME_SECONDS;
+    }
+    return frames;
+}
+
+bool LoadCapture(const std::string& filename, std::vector<Frame>& frames)
+{
+    FrameCaptureReader reader;
+    if (!reader.Open(filename))
+        return false;
+
+    for (size_t i = 0; i < reader.GetNumFrames(); i++)
+    {
+        const TrackingFrame trackingFrame = reader.GetFrame(i);
+        Frame frame{};
+        if (i > 0)
+        {
+            const int64_t micros =
+                trackingFrame.timestampMicros - reader.GetFrame(i - 1).timestampMicros;
+            frame.seconds = std::clamp(static_cast<float>(micros) / 1e6f, 0.0f, MAX_FRAME_SECONDS);
+        }
+        // the driver only looks at the most recent hand
+        frame.hasHand = trackingFrame.nHands > 0;
+        if (frame.hasHand)
+            frame.hand = ToUnprocessedHandState(trackingFrame.hands[trackingFrame.nHands - 1]);
+        frames.push_back(frame);
+    }
+    return true;
+}
+
+/// @brief ProcessHandState and the click latch DriverLoop had before classifiers.
+Results RunReference(const std::vector<Frame>& frames)
+{
+    Results results{};
+    results.decisions.resize(frames.size());
+    results.bestSeconds = 1e300;
+    for (int run = 0; run < NUM_RUNS; run++)
+    {
+        bool isClickDisengaged = true;
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            if (!frames[i].hasHand)
+                continue;
+            UnprocessedHandState hand = frames[i].hand;
+            GestureDecision& decision = results.decisions[i];
+            decision.hand = ProcessHandState(hand);
+            decision.shouldClick = isClickDisengaged && decision.hand.isInClickPose;
+            isClickDisengaged = !decision.hand.isInClickPose;
+        }
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        results.bestSeconds = std::min(results.bestSeconds, seconds);
+    }
+    return results;
+}
+
+template <typename Classifier>
+Results Run(const std::vector<Frame>& frames)
+{
+    Results results{};
+    results.decisions.resize(frames.size());
+    results.bestSeconds = 1e300;
+    for (int run = 0; run < NUM_RUNS; run++)
+    {
+        Classifier classifier{};
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            if (frames[i].hasHand)
+                results.decisions[i] = classifier.Classify(frames[i].hand, frames[i].seconds);
+            else
+                classifier.Reset();
+        }
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        results.bestSeconds = std::min(results.bestSeconds, seconds);
+    }
+    return results;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<Frame> frames;
+    if (argc < 2)
+    {
+        frames = MakeSyntheticFrames();
+        std::cout << frames.size() << " synthetic frames, noise " << NOISE_RADIANS << " rad\n";
+    }
+    for (int i = 1; i < argc; i++)
+    {
+        if (!LoadCapture(argv[i], frames))
+        {
+            std::cout << "FAIL: " << argv[i] << " isn't a frame capture this build can read\n";
+            return 1;
+        }
+    }
+    if (argc >= 2)
+        std::cout << frames.size() << " frames from " << argc - 1 << " captures\n";
+
+    double minutes = 0.0;
+    for (const Frame& frame : frames)
+        minutes += frame.seconds / 60.0;
+    const size_t numHands = std::count_if(frames.begin(), frames.end(),
+                                          [](const Frame& frame) { return frame.hasHand; });
+
+    auto print = [&](const char* name, const Results& results)
+    {
+        std::cout << name << ": " << results.bestSeconds * 1e9 / std::max<size_t>(numHands, 1)
+                  << " ns per hand, " << results.CountClicks() / minutes << " clicks/min, "
+                  << results.CountChanges() / minutes << " changes/min\n";
+    };
+
+    const Results reference = RunReference(frames);
+    print("ProcessHandState", reference);
+    bool isStudyExact = true;
+    for (GestureClassifierType type :
+         {GestureClassifierType::Study, GestureClassifierType::DwellClick,
+          GestureClassifierType::Continuous, GestureClassifierType::SixteenWay})
+    {
+        const AnyGestureClassifier classifier = MakeGestureClassifier(type);
+        const Results results = std::visit(
+            [&frames](const auto& chosen)
+            { return Run<std::remove_cvref_t<decltype(chosen)>>(frames); },
+            classifier);
+        print(GetGestureClassifierName(type), results);
+
+        if (type != GestureClassifierType::Study)
+            continue;
+        size_t numDifferent = 0;
+        for (size_t i = 0; i < frames.size(); i++)
+            numDifferent += !IsSameDecision(results.decisions[i], reference.decisions[i]);
+        std::cout << "    " << numDifferent << " of " << frames.size()
+                  << " frames decided differently from ProcessHandState\n";
+        isStudyExact = numDifferent == 0;
+    }
+
+    if (!isStudyExact)
+    {
+        std::cout << "FAIL: the study classifier doesn't match ProcessHandState\n";
+        return 1;
+    }
+    std::cout << "OK: the study classifier matched ProcessHandState on every frame\n";
+    return 0;
+}
@@ -0,0 +1,194 @@
+#include <Input/HandStateBatch.hpp>
+#include <Input/LeapMotionGestureProvider.hpp>
+#include <Input/SyntheticHands.hpp>
+#include <Math/MathHelpers.hpp>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// How many frames a second the gesture pipeline (ToUnprocessedHandState and ProcessHandState, or
+// ProcessHandStates for a whole batch) gets through, fed from SyntheticHandGenerator instead of
+// the device. Then a fuzz of the
+// classification: noise-free synthetic hands sweep through every pose, and ProcessHandState must
+// agree with what each hand was built to be, everywhere but right on a cone or sector boundary.
+// Needs LeapC.h and raymath.h but neither the LeapC library nor the device.
+
+using namespace Input::Leap;
+
+constexpr size_t NUM_BENCHMARK_FRAMES = 2'000'000;
+constexpr size_t NUM_FUZZ_FRAMES = 2'000'000;
+constexpr float NOISE_RADIANS = 0.05f;
+
+// poses this close to a boundary could go either way, and aren't checked
+constexpr float BOUNDARY_MARGIN = 1e-3f;
+constexpr float DIRECTION_TOLERANCE = 1e-4f;
+
+double SecondsSince(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void PrintRate(const char* name, size_t numFrames, double seconds)
+{
+    std::cout << name << ": " << numFrames / seconds / 1e6 << " M frames/s ("
+              << seconds * 1e9 / numFrames << " ns per frame)\n";
+}
+
+bool IsMove(const ProcessedHandState& state)
+{
+    return state.cursorDirectionX != 0.0f || state.cursorDirectionY != 0.0f;
+}
+
+float GetAverageFingerAngle(const ProcessedHandState& state)
+{
+    return std::acos(std::clamp(state.averageFingerDirectionY, -1.0f, 1.0f));
+}
+
+/// @brief Runs the pipeline over a stream of noisy hands, timing each stage on its own.
+void Benchmark()
+{
+    SyntheticHandConfig config{};
+    config.noiseRadians = NOISE_RADIANS;
+    SyntheticHandGenerator generator(config);
+
+    std::vector<LEAP_HAND> hands(NUM_BENCHMARK_FRAMES);
+    auto start = std::chrono::steady_clock::now();
+    for (LEAP_HAND& hand : hands)
+        hand = generator.NextHand();
+    PrintRate("generating hands", hands.size(), SecondsSince(start));
+
+    std::vector<UnprocessedHandState> states(hands.size());
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < hands.size(); i++)
+        states[i] = ToUnprocessedHandState(hands[i]);
+    PrintRate("ToUnprocessedHandState", states.size(), SecondsSince(start));
+
+    // the sums keep the calls from being optimized out, and show the mix of poses
+    size_t numClicks = 0;
+    size_t numMoves = 0;
+    start = std::chrono::steady_clock::now();
+    for (UnprocessedHandState& state : states)
+    {
+        const ProcessedHandState processed = ProcessHandState(state);
+        numClicks += processed.isInClickPose;
+        numMoves += IsMove(processed);
+    }
+    const double scalarSeconds = SecondsSince(start);
+    PrintRate("ProcessHandState", states.size(), scalarSeconds);
+    std::cout << "    " << numClicks << " clicks, " << numMoves << " moves, "
+              << states.size() - numClicks - numMoves << " neither\n";
+
+    HandStateBatch batch;
+    batch.Reserve(states.size());
+    for (const UnprocessedHandState& state : states)
+        batch.Push(state);
+    ProcessedHandStateBatch processed;
+    processed.Resize(batch.Size());
+    start = std::chrono::steady_clock::now();
+    const size_t numScalar = ProcessHandStates(batch, processed);
+    const double batchSeconds = SecondsSince(start);
+    PrintRate("ProcessHandStates", batch.Size(), batchSeconds);
+    std::cout << "    " << scalarSeconds / batchSeconds << "x ProcessHandState, " << numScalar
+              << " hands too close to a boundary went through ProcessHandState\n";
+}
+
+bool IsNearBoundary(const SyntheticHandPose& pose)
+{
+    // the cones, seen from the palm normal (see GetExpectedHandState)
+    const float roll = pose.rollRadians;
+    const float tilt = pose.tiltRadians;
+    const float coneCosine = std::cos(TOLERANCE_CONE_ANGLE_RADIANS);
+    const float downCosine = std::abs(std::cos(roll) * std::cos(tilt));
+    const float sideCosine = std::abs(std::sin(roll) * std::cos(tilt));
+    if (std::abs(downCosine - coneCosine) < BOUNDARY_MARGIN ||
+        std::abs(sideCosine - coneCosine) < BOUNDARY_MARGIN)
+        return true;
+
+    // the sectors, seen from the average finger angle, which only matters when moving
+    const ProcessedHandState expected = GetExpectedHandState(pose);
+    if (!IsMove(expected))
+        return false;
+    const float sectors = GetAverageFingerAngle(expected) / (Math::_PI / 8.0f);
+    return std::abs(sectors - std::round(sectors)) < BOUNDARY_MARGIN;
+}
+
+bool IsSameState(const ProcessedHandState& a, const ProcessedHandState& b)
+{
+    return a.isInClickPose == b.isInClickPose &&
+           std::abs(a.cursorDirectionX - b.cursorDirectionX) < DIRECTION_TOLERANCE &&
+           std::abs(a.cursorDirectionY - b.cursorDirectionY) < DIRECTION_TOLERANCE;
+}
+
+/// @return false if ProcessHandState disagreed with a synthetic hand, or a sector was never hit.
+bool Fuzz()
+{
+    SyntheticHandGenerator generator;
+    size_t numChecked = 0;
+    size_t numSkipped = 0;
+    size_t numMismatched = 0;
+    std::array<std::array<size_t, 9>, 2> sectorHits{};  // [isLeft][sector], 8 when folded back
+
+    for (size_t i = 0; i < NUM_FUZZ_FRAMES; i++)
+    {
+        SyntheticHandPose pose;
+        const LEAP_HAND hand = generator.NextHand(&pose);
+        if (IsNearBoundary(pose))
+        {
+            numSkipped++;
+            continue;
+        }
+
+        UnprocessedHandState state = ToUnprocessedHandState(hand);
+        const ProcessedHandState actual = ProcessHandState(state);
+        const ProcessedHandState expected = GetExpectedHandState(pose);
+        numChecked++;
+        if (!IsSameState(actual, expected))
+        {
+            if (numMismatched++ < 10)
+            {
+                std::cout << "    mismatch: " << (pose.isLeft ? "left" : "right")
+                          << " roll=" << pose.rollRadians * Math::RAD_TO_DEG
+                          << " tilt=" << pose.tiltRadians * Math::RAD_TO_DEG
+                          << " curl=" << pose.curlRadians * Math::RAD_TO_DEG << " got ("
+                          << actual.cursorDirectionX << ", " << actual.cursorDirectionY
+                          << ") expected (" << expected.cursorDirectionX << ", "
+                          << expected.cursorDirectionY << ")\n";
+            }
+            continue;
+        }
+
+        if (IsMove(expected))
+        {
+            const float sector = GetAverageFingerAngle(expected) / (Math::_PI / 8.0f);
+            sectorHits[pose.isLeft][static_cast<size_t>(sector)]++;
+        }
+    }
+
+    size_t numSectorsHit = 0;
+    for (const auto& hand : sectorHits)
+    {
+        for (size_t sector = 0; sector < 8; sector++)
+            numSectorsHit += hand[sector] > 0;
+    }
+
+    std::cout << "fuzz: " << numChecked << " hands checked, " << numSkipped
+              << " on a boundary skipped, " << numMismatched << " misclassified, "
+              << numSectorsHit << " of 16 sectors hit\n";
+    return numMismatched == 0 && numSectorsHit == 16;
+}
+
+int main()
+{
+    Benchmark();
+    if (!Fuzz())
+    {
+        std::cout << "FAIL: the gesture pipeline doesn't agree with the synthetic hands\n";
+        return 1;
+    }
+    std::cout << "OK: every synthetic hand was classified as it was built\n";
+    return 0;
+}
@@ -0,0 +1,139 @@
+#include <Input/HandStateFilter.hpp>
+#include <Input/LeapMotionGestureProvider.hpp>
+#include <Input/SyntheticHands.hpp>
+#include <Math/MathHelpers.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+
+// Smoothness against responsiveness for every HandFilterType. Noisy synthetic hands go through a
+// HandFilterStage and ProcessHandState, and the result is compared with what the noise-free hands
+// were built to be: how often the pose or cursor direction changes (flicker), how many clicks
+// the driver would have made, how many frames were judged differently, and the lag the stage
+// measured. Every filter has to flicker and click less than no filter, within the lag budget.
+// Needs LeapC.h and raymath.h but neither the LeapC library nor the device.
+
+using namespace Input::Leap;
+
+constexpr size_t NUM_FRAMES = 600'000;
+constexpr float FRAME_SECONDS = 1.0f / 120.0f;
+constexpr float NOISE_RADIANS = 0.05f;
+
+/// @brief What the driver would do with a hand: 0 nothing, 1 click, 2 and up a cursor direction.
+struct Decisions
+{
+    std::vector<uint8_t> keys;
+
+    uint64_t CountChanges() const
+    {
+        uint64_t numChanges = 0;
+        for (size_t i = 1; i < keys.size(); i++)
+            numChanges += keys[i] != keys[i - 1];
+        return numChanges;
+    }
+
+    /// @brief Clicks the driver would make: once per click pose, however long it is held.
+    uint64_t CountClicks() const
+    {
+        uint64_t numClicks = 0;
+        for (size_t i = 0; i < keys.size(); i++)
+            numClicks += keys[i] == 1 && (i == 0 || keys[i - 1] != 1);
+        return numClicks;
+    }
+};
+
+uint8_t GetKey(const ProcessedHandState& state)
+{
+    if (state.isInClickPose)
+        return 1;
+    if (state.cursorDirectionX == 0.0f && state.cursorDirectionY == 0.0f)
+        return 0;
+    const float angle = std::atan2(state.cursorDirectionX, state.cursorDirectionY) + Math::_PI;
+    return static_cast<uint8_t>(2 + std::lround(angle / (Math::_PI / NUM_CURSOR_DIRECTIONS)));
+}
+
+double ToMinutes(size_t numFrames) { return numFrames * FRAME_SECONDS / 60.0; }
+
+int main()
+{
+    SyntheticHandConfig config{};
+    config.noiseRadians = NOISE_RADIANS;
+    SyntheticHandGenerator generator(config);
+
+    std::vector<UnprocessedHandState> hands(NUM_FRAMES);
+    Decisions expected;
+    expected.keys.reserve(NUM_FRAMES);
+    for (UnprocessedHandState& hand : hands)
+    {
+        SyntheticHandPose pose;
+        hand = ToUnprocessedHandState(generator.NextHand(&pose));
+        expected.keys.push_back(GetKey(GetExpectedHandState(pose)));
+    }
+
+    const double minutes = ToMinutes(NUM_FRAMES);
+    const uint64_t expectedChanges = expected.CountChanges();
+    const uint64_t expectedClicks = expected.CountClicks();
+    std::cout << "noise-free hands: " << expectedChanges / minutes << " changes/min, "
+              << expectedClicks / minutes << " clicks/min\n";
+
+    bool isOk = true;
+    uint64_t unfilteredChanges = 0;
+    uint64_t unfilteredClicks = 0;
+    for (HandFilterType type : {HandFilterType::None, HandFilterType::OneEuro,
+                                HandFilterType::Kalman})
+    {
+        HandFilterConfig filterConfig{};
+        filterConfig.type = type;
+        HandFilterStage stage(filterConfig);
+
+        Decisions actual;
+        actual.keys.reserve(NUM_FRAMES);
+        const auto start = std::chrono::steady_clock::now();
+        for (UnprocessedHandState hand : hands)
+        {
+            stage.Process(hand, FRAME_SECONDS);
+            actual.keys.push_back(GetKey(ProcessHandState(hand)));
+        }
+        const double seconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        size_t numMisjudged = 0;
+        for (size_t i = 0; i < NUM_FRAMES; i++)
+            numMisjudged += actual.keys[i] != expected.keys[i];
+        const uint64_t numChanges = actual.CountChanges();
+        const uint64_t numClicks = actual.CountClicks();
+
+        std::cout << GetHandFilterName(type) << ": " << numChanges / minutes << " changes/min, "
+                  << numClicks / minutes << " clicks/min, "
+                  << 100.0 * numMisjudged / NUM_FRAMES << "% of frames misjudged, "
+                  << seconds * 1e9 / NUM_FRAMES << " ns per frame\n";
+        if (!stage.IsEnabled())
+        {
+            unfilteredChanges = numChanges;
+            unfilteredClicks = numClicks;
+            continue;
+        }
+
+        const HandFilterStats& stats = stage.GetStats();
+        std::cout << "    lag mean " << stats.GetMeanLagSeconds() * 1e3 << "ms, max "
+                  << stats.maxLagSeconds * 1e3 << "ms, "
+                  << 100.0 * stats.numFramesOverBudget / std::max<uint64_t>(stats.numLagFrames, 1)
+                  << "% of " << stats.numLagFrames << " turning frames over the "
+                  << filterConfig.lagBudgetSeconds * 1e3 << "ms budget; palm normal path "
+                  << 100.0 * stats.filteredPathLength / stats.rawPathLength << "% of raw\n";
+
+        isOk &= numChanges < unfilteredChanges && numClicks < unfilteredClicks &&
+                stats.GetMeanLagSeconds() <= filterConfig.lagBudgetSeconds;
+    }
+
+    if (!isOk)
+    {
+        std::cout << "FAIL: a filter flickered as much as no filter, or went over its lag budget\n";
+        return 1;
+    }
+    std::cout << "OK: every filter flickered less than no filter, within its lag budget\n";
+    return 0;
+}
@@ -0,0 +1,180 @@
+#include "TestCheck.hpp"
+
+#include <Input/HandStateBatch.hpp>
+#include <Input/LeapMotionGestureProvider.hpp>
+#include <Input/SyntheticHands.hpp>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Differential test of ProcessHandStates against ProcessHandState: every hand in a batch must get
+// the same click and movement decisions and bit for bit the same cursor direction as it gets on
+// its own. Hands come from SyntheticHandGenerator, with and without noise, plus hands built to
+// sit on the boundaries and degenerate ones. Needs LeapC.h and raymath.h but neither the LeapC
+// library nor the device.
+
+using namespace Input::Leap;
+
+constexpr size_t NUM_HANDS = 1'000'003;  // not a multiple of 4, for the tail
+constexpr float ANGLE_TOLERANCE = 1e-5f;
+
+/// @brief Degenerate hands have NaN finger directions either way.
+bool IsClose(float a, float b)
+{
+    return (std::isnan(a) && std::isnan(b)) || std::abs(a - b) < ANGLE_TOLERANCE;
+}
+
+/// @return How many hands the batch disagreed on.
+size_t CountMismatches(const std::vector<UnprocessedHandState>& states, size_t& numScalar)
+{
+    HandStateBatch batch;
+    batch.Reserve(states.size());
+    for (const UnprocessedHandState& state : states)
+        batch.Push(state);
+
+    ProcessedHandStateBatch processed;
+    numScalar = ProcessHandStates(batch, processed);
+
+    size_t numMismatched = 0;
+    for (size_t i = 0; i < states.size(); i++)
+    {
+        UnprocessedHandState state = states[i];
+        const ProcessedHandState expected = ProcessHandState(state);
+
+        bool isSame =
+            static_cast<bool>(processed.isInClickPose[i]) == expected.isInClickPose &&
+            std::bit_cast<uint32_t>(processed.cursorDirectionX[i]) ==
+                std::bit_cast<uint32_t>(expected.cursorDirectionX) &&
+            std::bit_cast<uint32_t>(processed.cursorDirectionY[i]) ==
+                std::bit_cast<uint32_t>(expected.cursorDirectionY);
+
+        if (expected.cursorDirectionX != 0.0f || expected.cursorDirectionY != 0.0f)
+        {
+            const float angle = processed.averageFingerAngle[i];
+            const float referenceX = state.isLeft ? 1.0f : -1.0f;
+            isSame &= IsClose(std::sin(angle) * referenceX, expected.averageFingerDirectionX) &&
+                      IsClose(std::cos(angle), expected.averageFingerDirectionY);
+        }
+
+        if (!isSame && numMismatched++ < 5)
+        {
+            std::cout << "    hand " << i << ": click " << +processed.isInClickPose[i] << " vs "
+                      << expected.isInClickPose << ", direction (" << processed.cursorDirectionX[i]
+                      << ", " << processed.cursorDirectionY[i] << ") vs ("
+                      << expected.cursorDirectionX << ", " << expected.cursorDirectionY << ")"
+                      << std::endl;
+        }
+    }
+    return numMismatched;
+}
+
+void TestGenerated(float noiseRadians)
+{
+    SyntheticHandConfig config{};
+    config.noiseRadians = noiseRadians;
+    config.seed = 19;
+    SyntheticHandGenerator generator(config);
+
+    std::vector<UnprocessedHandState> states;
+    states.reserve(NUM_HANDS);
+    for (size_t i = 0; i < NUM_HANDS; i++)
+        states.push_back(ToUnprocessedHandState(generator.NextHand()));
+
+    size_t numScalar = 0;
+    const size_t numMismatched = CountMismatches(states, numScalar);
+    std::cout << "    " << numScalar << " of " << states.size()
+              << " hands went through ProcessHandState" << std::endl;
+    Check(numMismatched == 0,
+          "batch agrees with ProcessHandState on synthetic hands, noise " +
+              std::to_string(noiseRadians) + " rad");
+}
+
+void TestBoundaries()
+{
+    // poses right on the cone surfaces and sector boundaries, and a little either side of them
+    std::vector<UnprocessedHandState> states;
+    uint64_t random = 0;
+    for (int isLeft = 0; isLeft < 2; isLeft++)
+    {
+        for (int nudge = -2; nudge <= 2; nudge++)
+        {
+            const float epsilon = nudge * 1e-6f;
+            for (float cone : {TOLERANCE_CONE_ANGLE_RADIANS, Math::_PI / 2.0f -
+                                                                 TOLERANCE_CONE_ANGLE_RADIANS})
+            {
+                for (float roll : {cone, -cone})
+                {
+                    for (int sector = 0; sector <= 8; sector++)
+                    {
+                        SyntheticHandPose pose{};
+                        pose.isLeft = isLeft;
+                        pose.rollRadians = roll + epsilon;
+                        pose.curlRadians = sector * Math::_PI / 8.0f + epsilon;
+                        states.push_back(
+                            ToUnprocessedHandState(MakeSyntheticHand(pose, 0.0f, random)));
+                        pose.rollRadians = isLeft ? Math::_PI / 2.0f : -Math::_PI / 2.0f;
+                        states.push_back(
+                            ToUnprocessedHandState(MakeSyntheticHand(pose, 0.0f, random)));
+                    }
+                }
+            }
+        }
+    }
+
+    size_t numScalar = 0;
+    Check(CountMismatches(states, numScalar) == 0,
+          "batch agrees with ProcessHandState on cone and sector boundaries");
+}
+
+void TestDegenerate()
+{
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    std::vector<UnprocessedHandState> states;
+
+    UnprocessedHandState zero{};
+    states.push_back(zero);
+
+    // palm normal along the hand direction: no finger bend plane
+    UnprocessedHandState parallel{};
+    parallel.isLeft = true;
+    parallel.palmNormal = Math::Vector3Common(1.0f, 0.0f, 0.0f);
+    parallel.handDirection = Math::Vector3Common(1.0f, 0.0f, 0.0f);
+    parallel.fingerDirections.fill(Math::Vector3Common(0.0f, 0.0f, -1.0f));
+    states.push_back(parallel);
+
+    UnprocessedHandState notANumber = parallel;
+    notANumber.handDirection = Math::Vector3Common(0.0f, 0.0f, -1.0f);
+    notANumber.fingerDirections[2] = Math::Vector3Common(nan, 0.0f, 0.0f);
+    states.push_back(notANumber);
+    notANumber.palmNormal = Math::Vector3Common(nan, nan, nan);
+    states.push_back(notANumber);
+
+    // fingers bent straight back, and exactly sideways
+    UnprocessedHandState bentBack = notANumber;
+    bentBack.palmNormal = Math::Vector3Common(1.0f, 0.0f, 0.0f);
+    bentBack.fingerDirections.fill(Math::Vector3Common(-1.0f, 0.0f, 0.0f));
+    states.push_back(bentBack);
+    bentBack.fingerDirections.fill(Math::Vector3Common(-1.0f, 0.0f, 1.0f));
+    states.push_back(bentBack);
+    bentBack.fingerDirections.fill(Math::Vector3Common(0.0f, 0.0f, 1.0f));
+    states.push_back(bentBack);
+
+    size_t numScalar = 0;
+    Check(CountMismatches(states, numScalar) == 0,
+          "batch agrees with ProcessHandState on degenerate hands");
+}
+
+int main()
+{
+    TestGenerated(0.0f);
+    TestGenerated(0.02f);
+    TestGenerated(0.3f);
+    TestBoundaries();
+    TestDegenerate();
+
+    return FinishChecks();
+}
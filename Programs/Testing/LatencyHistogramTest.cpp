@@ -0,0 +1,168 @@
+#include "TestCheck.hpp"
+
+#include <Helpers/LatencyHistogram.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Checks LatencyHistogram's buckets and percentiles against exact answers, then records from
+// several threads at once while another takes snapshots, the way the gesture driver records
+// while the HTTP thread dumps. No count may be lost, and no snapshot may go backwards.
+
+using Helpers::LatencyHistogram;
+
+constexpr double MAX_RELATIVE_ERROR = 1.0 / LatencyHistogram::NUM_SUB_BUCKETS;
+constexpr size_t NUM_SAMPLES = 200'000;
+constexpr uint64_t NUM_RECORDS_PER_THREAD = 1'000'000;
+
+void TestBuckets()
+{
+    bool isInRange = true;
+    bool isMonotonic = true;
+    bool isPrecise = true;
+    size_t lastBucket = 0;
+    for (uint64_t nanos = 0; nanos <= LatencyHistogram::MAX_NANOS;
+         nanos = nanos < 4096 ? nanos + 1 : nanos + nanos / 97)
+    {
+        const size_t bucket = LatencyHistogram::GetBucket(nanos);
+        const uint64_t end = LatencyHistogram::GetBucketEnd(bucket);
+        isInRange &= bucket < LatencyHistogram::NUM_BUCKETS;
+        isMonotonic &= bucket >= lastBucket;
+        isPrecise &= end >= nanos && end - nanos <= nanos * MAX_RELATIVE_ERROR;
+        lastBucket = bucket;
+    }
+
+    // the first value of every bucket lands in it, and the value before it in the one before
+    bool isContiguous = true;
+    for (size_t bucket = 1; bucket < LatencyHistogram::NUM_BUCKETS; bucket++)
+    {
+        const uint64_t start = LatencyHistogram::GetBucketEnd(bucket - 1) + 1;
+        isContiguous &= LatencyHistogram::GetBucket(start) == bucket &&
+                        LatencyHistogram::GetBucket(start - 1) == bucket - 1;
+    }
+
+    Check(isInRange, "every duration up to the max has a bucket");
+    Check(isMonotonic, "longer durations never go in earlier buckets");
+    Check(isPrecise, "a bucket's end is within 1/32 above every duration in it");
+    Check(isContiguous, "buckets cover every duration without gaps or overlaps");
+    Check(LatencyHistogram::GetBucketEnd(LatencyHistogram::NUM_BUCKETS - 1) ==
+              LatencyHistogram::MAX_NANOS,
+          "the last bucket ends at the max");
+}
+
+void TestPercentiles()
+{
+    // log-normal around 200us, like frame latencies with the odd stall
+    std::mt19937_64 random(22);
+    std::lognormal_distribution<double> distribution(std::log(200'000.0), 1.0);
+    std::vector<uint64_t> samples(NUM_SAMPLES);
+    LatencyHistogram histogram;
+    uint64_t total = 0;
+    for (uint64_t& sample : samples)
+    {
+        sample = static_cast<uint64_t>(distribution(random));
+        histogram.Record(std::chrono::nanoseconds(sample));
+        total += sample;
+    }
+    std::sort(samples.begin(), samples.end());
+
+    const LatencyHistogram::Snapshot snapshot = histogram.GetSnapshot();
+    bool isClose = true;
+    for (double percent : {0.0, 1.0, 50.0, 90.0, 99.0, 99.9, 99.99, 100.0})
+    {
+        const size_t rank = std::max<size_t>(
+            1, static_cast<size_t>(std::ceil(percent / 100.0 * samples.size())));
+        const uint64_t exact = samples[rank - 1];
+        const uint64_t reported = snapshot.GetPercentileNanos(percent);
+        if (reported < exact || reported - exact > exact * MAX_RELATIVE_ERROR)
+        {
+            std::cout << "    p" << percent << ": " << reported << "ns, exactly " << exact
+                      << "ns\n";
+            isClose = false;
+        }
+    }
+
+    Check(snapshot.count == NUM_SAMPLES && snapshot.totalNanos == total &&
+              snapshot.maxNanos == samples.back(),
+          "count, total and max are exact");
+    Check(isClose, "percentiles are within 1/32 above the exact ones");
+
+    LatencyHistogram edges;
+    edges.Record(std::chrono::nanoseconds(-5));
+    edges.Record(std::chrono::hours(1));
+    const LatencyHistogram::Snapshot edgeSnapshot = edges.GetSnapshot();
+    Check(edgeSnapshot.GetPercentileNanos(50.0) == 0 &&
+              edgeSnapshot.GetPercentileNanos(100.0) == LatencyHistogram::MAX_NANOS,
+          "negative durations count as 0 and overlong ones as the max");
+    Check(LatencyHistogram().GetSnapshot().GetPercentileNanos(99.0) == 0,
+          "an empty histogram reports 0");
+}
+
+void TestConcurrency()
+{
+    const unsigned numWriters = std::max(2u, std::thread::hardware_concurrency());
+    LatencyHistogram histogram;
+    std::atomic<bool> isWriting = true;
+
+    // snapshots taken while the writers run must only ever grow
+    bool isMonotonic = true;
+    uint64_t numSnapshots = 0;
+    std::thread reader(
+        [&]
+        {
+            uint64_t lastCount = 0;
+            while (isWriting.load(std::memory_order_relaxed))
+            {
+                const uint64_t count = histogram.GetSnapshot().count;
+                isMonotonic &= count >= lastCount;
+                lastCount = count;
+                numSnapshots++;
+            }
+        });
+
+    std::vector<std::thread> writers;
+    for (unsigned i = 0; i < numWriters; i++)
+    {
+        writers.emplace_back(
+            [&histogram, i]
+            {
+                for (uint64_t j = 0; j < NUM_RECORDS_PER_THREAD; j++)
+                    histogram.Record(std::chrono::nanoseconds((j * 7919 + i) % 1'000'000));
+            });
+    }
+    for (std::thread& writer : writers)
+        writer.join();
+    isWriting.store(false);
+    reader.join();
+
+    uint64_t expectedTotal = 0;
+    for (unsigned i = 0; i < numWriters; i++)
+    {
+        for (uint64_t j = 0; j < NUM_RECORDS_PER_THREAD; j++)
+            expectedTotal += (j * 7919 + i) % 1'000'000;
+    }
+
+    const LatencyHistogram::Snapshot snapshot = histogram.GetSnapshot();
+    std::cout << "    " << numWriters << " writers, " << numSnapshots
+              << " snapshots taken meanwhile\n";
+    Check(snapshot.count == numWriters * NUM_RECORDS_PER_THREAD &&
+              snapshot.totalNanos == expectedTotal && snapshot.maxNanos == 999'999,
+          "no record is lost to concurrent writers");
+    Check(isMonotonic, "snapshots taken during recording never go backwards");
+}
+
+int main()
+{
+    TestBuckets();
+    TestPercentiles();
+    TestConcurrency();
+
+    return FinishChecks();
+}
@@ -0,0 +1,212 @@
+#include "../UserStudy/Logging.hpp"
+#include "MPSCQueue.hpp"
+
+#include <Helpers/Clock.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Cost of Logger::Log on each producer thread when several threads log at once, compared to the
+// shared queue every producer used to push into. Then a check that the merged log comes out in
+// timestamp order when events reach Log() late and out of order, like browser events do.
+
+constexpr int EVENTS_PER_THREAD = 200'000;
+constexpr const char* LOG_FILENAME = "loggerContentionBenchmark.log";
+
+// the ordering check: each producer logs at 1kHz, stamping events up to 200ms before logging them
+constexpr int ORDERING_THREADS = 4;
+constexpr int ORDERING_EVENTS_PER_THREAD = 2000;
+constexpr int MAX_STAMP_DELAY_MILLIS = 200;
+
+size_t NextPowerOfTwo(size_t n)
+{
+    size_t power = 1;
+    while (power < n)
+        power <<= 1;
+    return power;
+}
+
+Logging::EventRecord MakeCursorRecord(int i)
+{
+    return Logging::ToRecord(Logging::Events::CursorPosition{
+        .timestampMillis = Helpers::Clock::NowUnixMillis(), .positionX = i, .positionY = -i});
+}
+
+/// @brief Starts numThreads producers at once and returns the mean time each spent per event.
+template <typename Fn>
+double TimeProducers(int numThreads, Fn&& produce)
+{
+    std::atomic<bool> isGo{false};
+    std::atomic<int64_t> totalNanos{0};
+    std::vector<std::thread> producers;
+    for (int t = 0; t < numThreads; t++)
+    {
+        producers.emplace_back(
+            [&]
+            {
+                while (!isGo.load())
+                    ;
+                auto start = std::chrono::steady_clock::now();
+                for (int i = 0; i < EVENTS_PER_THREAD; i++)
+                    produce(i);
+                auto end = std::chrono::steady_clock::now();
+                totalNanos.fetch_add(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            });
+    }
+    isGo.store(true);
+    for (auto& producer : producers)
+        producer.join();
+
+    return static_cast<double>(totalNanos.load()) / numThreads / EVENTS_PER_THREAD;
+}
+
+// What Logger::Enqueue used to do: every producer claims slots in one shared ring
+// and bumps the same counters.
+double RunShared(int numThreads)
+{
+    MPSCQueue<Logging::EventRecord> queue(NextPowerOfTwo(numThreads * EVENTS_PER_THREAD));
+    std::atomic<uint64_t> eventsLogged{0};
+    std::atomic<size_t> highWaterMark{0};
+
+    std::atomic<bool> isDone{false};
+    std::thread consumer(
+        [&]
+        {
+            Logging::EventRecord record;
+            while (!isDone.load())
+                while (queue.TryPop(record))
+                    ;
+        });
+
+    const double nanos = TimeProducers(
+        numThreads,
+        [&](int i)
+        {
+            queue.TryPush(MakeCursorRecord(i));
+            eventsLogged.fetch_add(1, std::memory_order_relaxed);
+            size_t depth = queue.Size();
+            size_t currentMax = highWaterMark.load(std::memory_order_relaxed);
+            while (depth > currentMax &&
+                   !highWaterMark.compare_exchange_weak(currentMax, depth,
+                                                        std::memory_order_relaxed))
+                ;
+        });
+
+    isDone.store(true);
+    consumer.join();
+    return nanos;
+}
+
+double RunLanes(int numThreads)
+{
+    Logging::LoggerConfig config{};
+    config.queueCapacity = NextPowerOfTwo(EVENTS_PER_THREAD);
+    config.overflowPolicy = Logging::OverflowPolicy::Drop;
+
+    Logging::Logger logger(LOG_FILENAME, config);
+    const double nanos = TimeProducers(
+        numThreads,
+        [&logger](int i)
+        {
+            logger.Log(Logging::Events::CursorPosition{
+                .timestampMillis = Helpers::Clock::NowUnixMillis(),
+                .positionX = i,
+                .positionY = -i});
+        });
+    return nanos;
+}
+
+void RunDelayedProducers()
+{
+    Logging::Logger logger(LOG_FILENAME);
+
+    std::vector<std::thread> producers;
+    for (int t = 0; t < ORDERING_THREADS; t++)
+    {
+        producers.emplace_back(
+            [&logger, t]
+            {
+                std::vector<Logging::Events::Keystroke> stamped;
+                uint32_t random = 12345u + t;
+                auto next = std::chrono::steady_clock::now();
+                for (int i = 0; i < ORDERING_EVENTS_PER_THREAD; i++)
+                {
+                    stamped.push_back({.timestampMillis = Helpers::Clock::NowUnixMillis(),
+                                       .key = std::to_string(t),
+                                       .wasCorrect = true});
+
+                    // sometimes hold on to events for a while and then log them all at once
+                    random = random * 1664525u + 1013904223u;
+                    const uint64_t age =
+                        Helpers::Clock::NowUnixMillis() - stamped.front().timestampMillis;
+                    if ((random >> 24) < 16 || age >= MAX_STAMP_DELAY_MILLIS)
+                    {
+                        for (auto it = stamped.rbegin(); it != stamped.rend(); ++it)
+                            logger.Log(*it);
+                        stamped.clear();
+                    }
+
+                    next += std::chrono::milliseconds(1);
+                    std::this_thread::sleep_until(next);
+                }
+                for (const auto& event : stamped)
+                    logger.Log(event);
+            });
+    }
+    for (auto& producer : producers)
+        producer.join();
+}
+
+/// @return The number of lines whose timestamp is older than the line before.
+size_t CountOutOfOrder(const char* filename, size_t& numLines)
+{
+    std::ifstream file(filename);
+    std::string line;
+    Logging::EventRecord record;
+    uint64_t previous = 0;
+    size_t outOfOrder = 0;
+    numLines = 0;
+    while (std::getline(file, line))
+    {
+        if (!Logging::ParseRecord(line, record))
+            continue;
+        outOfOrder += record.timestampMillis < previous;
+        previous = record.timestampMillis;
+        numLines++;
+    }
+    return outOfOrder;
+}
+
+int main()
+{
+    for (int numThreads : {1, 2, 4, 8})
+    {
+        const double sharedNanos = RunShared(numThreads);
+        const double laneNanos = RunLanes(numThreads);
+        std::cout << numThreads << " producer(s): [shared queue] " << sharedNanos
+                  << " ns/event, [lanes] " << laneNanos << " ns/event\n";
+    }
+
+    RunDelayedProducers();
+    size_t numLines = 0;
+    const size_t outOfOrder = CountOutOfOrder(LOG_FILENAME, numLines);
+    std::cout << ORDERING_THREADS << " producers logging late: " << numLines << " lines written, "
+              << outOfOrder << " out of order\n";
+
+    std::remove(LOG_FILENAME);
+    std::remove(Logging::GetManifestFilename(LOG_FILENAME).c_str());
+
+    if (outOfOrder != 0 || numLines != ORDERING_THREADS * ORDERING_EVENTS_PER_THREAD)
+    {
+        std::cout << "FAIL: the log was not complete and in timestamp order\n";
+        return 1;
+    }
+    std::cout << "OK: the log was in timestamp order\n";
+    return 0;
+}
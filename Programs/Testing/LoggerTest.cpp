@@ -2,6 +2,16 @@
 
 #include <thread>
 #include <iostream>
+#include <vector>
+
+void PrintStats(const Logging::Logger& logger)
+{
+    Logging::LoggerStats stats = logger.GetStats();
+    std::cout << "Deepest lane: " << stats.queueDepth << "/" << stats.capacity
+              << ", high-water mark: " << stats.highWaterMark
+              << ", logged: " << stats.eventsLogged << ", dropped: " << stats.eventsDropped
+              << ", blocked: " << stats.eventsBlocked << std::endl;
+}
 
 int main()
 {
@@ -9,16 +19,32 @@ int main()
 
     for (int i = 0; i < 300; i++)
         logger.Log(Logging::Events::CursorPosition{});
-    
-    std::cout << "File should be umodified or nonexistant. Sleeping for 10s..." << std::endl;
+
+    std::cout << "Writer thread flushes on an interval. Sleeping for 10s..." << std::endl;
     std::this_thread::sleep_for(std::chrono::seconds(10));
+    std::cout << "File should contain 300 lines." << std::endl;
 
     for (int i = 0; i < 1000; i++)
         logger.Log(Logging::Events::Keystroke{});
 
-    std::cout << "File should contain 1000 lines. Sleeping for 10s..." << std::endl;
+    std::cout << "Sleeping for 10s..." << std::endl;
     std::this_thread::sleep_for(std::chrono::seconds(10));
+    std::cout << "File should contain 1300 lines." << std::endl;
+    PrintStats(logger);
+
+    // several producers at once, like the HTTP workers and the cursor logger
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; t++)
+        producers.emplace_back(
+            [&logger]
+            {
+                for (int i = 0; i < 10000; i++)
+                    logger.Log(Logging::Events::CursorPosition{});
+            });
+    for (auto& producer : producers)
+        producer.join();
 
-    std::cout << "File should contain 1300 lines. Done." << std::endl;
+    PrintStats(logger);
+    std::cout << "File should contain 41300 lines once the logger is destroyed. Done." << std::endl;
     return 0;
-}
\ No newline at end of file
+}
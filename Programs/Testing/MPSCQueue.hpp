@@ -0,0 +1,132 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+/// @brief Bounded multi-producer/single-consumer ring buffer of fixed-size items.
+///        This is Dmitry Vyukov's bounded MPMC queue with the consumer side simplified,
+///        since only one thread is ever allowed to pop.
+///        Producers never block or take a lock: TryPush either claims a slot
+///        (one CAS in the uncontended case) or fails immediately because the ring is full.
+///        The queue every producer shared before the logger gave each thread its own lane,
+///        kept for LoggerContentionBenchmark to compare against.
+/// @remark https://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+class MPSCQueue
+{
+   public:
+    /// @param capacity Number of slots in the ring. Must be a power of two.
+    explicit MPSCQueue(size_t capacity);
+
+    MPSCQueue(const MPSCQueue&) = delete;
+    MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+    /// @brief Safe to call from any number of threads.
+    /// @return false if the ring was full and the item was not enqueued.
+    bool TryPush(const T& item);
+
+    /// @brief Must only ever be called from the single consumer thread.
+    /// @return false if the ring was empty.
+    bool TryPop(T& item);
+
+    /// @brief Approximate number of items in the ring. Exact only when producers are quiet.
+    size_t Size() const;
+
+    size_t Capacity() const { return m_mask + 1; }
+
+   private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    // keeps the producer and consumer cursors from sharing a cache line
+    static constexpr size_t CACHE_LINE_SIZE = 64;
+
+    const size_t m_mask;
+    std::unique_ptr<Slot[]> m_slots;
+
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_tail;  // next slot a producer will claim
+    alignas(CACHE_LINE_SIZE) std::atomic<size_t> m_head;  // next slot the consumer will read
+};
+
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+MPSCQueue<T>::MPSCQueue(size_t capacity)
+    : m_mask(capacity - 1), m_slots(std::make_unique<Slot[]>(capacity)), m_tail(0), m_head(0)
+{
+    if (capacity < 2 || (capacity & (capacity - 1)) != 0)
+        throw std::invalid_argument("MPSCQueue capacity must be a power of two.");
+
+    // a slot is writable for ticket i when its sequence is i,
+    // and readable for ticket i when its sequence is i + 1
+    for (size_t i = 0; i < capacity; i++)
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+bool MPSCQueue<T>::TryPush(const T& item)
+{
+    size_t pos = m_tail.load(std::memory_order_relaxed);
+    Slot* slot;
+    while (true)
+    {
+        slot = &m_slots[pos & m_mask];
+        const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+        const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+
+        if (diff == 0)
+        {
+            // slot is free for this ticket, try to claim it
+            if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+            // CAS failure reloads pos, just retry
+        }
+        else if (diff < 0)
+        {
+            // the consumer has not released this slot yet, i.e. the ring is full
+            return false;
+        }
+        else
+        {
+            // another producer claimed this ticket first
+            pos = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->data = item;
+    slot->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+bool MPSCQueue<T>::TryPop(T& item)
+{
+    const size_t pos = m_head.load(std::memory_order_relaxed);
+    Slot& slot = m_slots[pos & m_mask];
+    if (slot.sequence.load(std::memory_order_acquire) != pos + 1)
+        return false;
+
+    item = slot.data;
+    // hand the slot back to the producers for the next lap around the ring
+    slot.sequence.store(pos + m_mask + 1, std::memory_order_release);
+    m_head.store(pos + 1, std::memory_order_relaxed);
+    return true;
+}
+
+template <typename T>
+requires std::is_trivially_copyable_v<T> && std::is_default_constructible_v<T>
+size_t MPSCQueue<T>::Size() const
+{
+    const size_t head = m_head.load(std::memory_order_relaxed);
+    const size_t tail = m_tail.load(std::memory_order_relaxed);
+    return tail > head ? tail - head : 0;
+}
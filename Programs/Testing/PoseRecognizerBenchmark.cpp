@@ -0,0 +1,178 @@
+#include <Helpers/LatencyHistogram.hpp>
+#include <Input/LeapMotionGestureProvider.hpp>
+#include <Input/PoseRecognizer.hpp>
+#include <Input/SyntheticHands.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+// Builds pose libraries of growing size from noisy synthetic hands, labelled with the pose
+// ProcessHandState gives the hand without noise, and for each one reports how long the KD-tree
+// takes to build, and how long a PoseRecognizer takes to recognize a hand the library has never
+// seen, from LEAP_HAND to label, next to a brute-force search of the same library.
+// The KD-tree has to find the same neighbours as the brute-force search, and the slowest 1% of
+// its queries have to fit in 20us, a fiftieth of a frame at 1kHz, at every size.
+// Needs LeapC.h and raymath.h but neither the LeapC library nor the device.
+
+using namespace Input::Leap;
+
+constexpr size_t LIBRARY_SIZES[] = {1'000, 4'000, 16'000, 64'000, 256'000};
+constexpr size_t NUM_QUERIES = 20'000;
+constexpr size_t NUM_BRUTE_FORCE_QUERIES = 2'000;
+constexpr float NOISE_RADIANS = 0.05f;
+constexpr uint64_t MAX_P99_NANOS = 20'000;
+constexpr float MAX_RELATIVE_ERROR = 1e-4f;  // the KD-tree works on the principal axes
+constexpr int NUM_RUNS = 3;  // the run with the fastest 1% is reported
+
+struct Query
+{
+    LEAP_HAND hand;
+    PoseLabel expected;
+};
+
+PoseLabel GetExpectedLabel(const SyntheticHandPose& pose)
+{
+    const ProcessedHandState state = GetExpectedHandState(pose);
+    if (state.isInClickPose)
+        return PoseLabel::Click;
+    if (state.cursorDirectionX != 0.0f || state.cursorDirectionY != 0.0f)
+        return PoseLabel::Move;
+    return PoseLabel::Neutral;
+}
+
+std::vector<PoseExemplar> MakeLibrary(size_t size)
+{
+    SyntheticHandConfig config{};
+    config.noiseRadians = NOISE_RADIANS;
+    SyntheticHandGenerator generator(config);
+
+    std::vector<PoseExemplar> library(size);
+    for (PoseExemplar& exemplar : library)
+    {
+        SyntheticHandPose pose;
+        exemplar.features = ExtractPoseFeatures(generator.NextHand(&pose));
+        exemplar.label = GetExpectedLabel(pose);
+    }
+    return library;
+}
+
+/// @brief Hands from another trajectory and other noise, so none of them are in a library.
+std::vector<Query> MakeQueries()
+{
+    SyntheticHandConfig config{};
+    config.seed = 2;
+    config.noiseRadians = NOISE_RADIANS;
+    config.rollPeriodFrames = 997;
+    config.tiltPeriodFrames = 1499;
+    config.curlPeriodFrames = 263;
+    config.handPeriodFrames = 4999;
+    SyntheticHandGenerator generator(config);
+
+    std::vector<Query> queries(NUM_QUERIES);
+    for (Query& query : queries)
+    {
+        SyntheticHandPose pose;
+        query.hand = generator.NextHand(&pose);
+        query.expected = GetExpectedLabel(pose);
+    }
+    return queries;
+}
+
+void PrintLatency(const char* name, const Helpers::LatencyHistogram& histogram)
+{
+    const Helpers::LatencyHistogram::Snapshot snapshot = histogram.GetSnapshot();
+    std::cout << "    " << name << ": p50 " << snapshot.GetPercentileNanos(50.0) / 1e3
+              << "us, p99 " << snapshot.GetPercentileNanos(99.0) / 1e3 << "us, max "
+              << snapshot.maxNanos / 1e3 << "us\n";
+}
+
+int main()
+{
+    const std::vector<Query> queries = MakeQueries();
+    PoseRecognizerConfig config{};
+    std::cout << queries.size() << " queries, k " << config.k << ", noise " << NOISE_RADIANS
+              << " rad\n";
+
+    bool isFastEnough = true;
+    size_t numMismatches = 0;
+    for (size_t size : LIBRARY_SIZES)
+    {
+        const std::vector<PoseExemplar> library = MakeLibrary(size);
+
+        const auto start = std::chrono::steady_clock::now();
+        const PoseRecognizer recognizer(library, config);
+        const double buildSeconds =
+            std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const PoseBruteForce bruteForce(library);
+        std::cout << size << " exemplars: built in " << buildSeconds * 1e3 << "ms\n";
+
+        // the histograms are too big for the stack
+        std::unique_ptr<Helpers::LatencyHistogram> kdTreeLatency;
+        auto bruteForceLatency = std::make_unique<Helpers::LatencyHistogram>();
+        size_t numCorrect = 0;
+        size_t numRecognized = 0;
+        for (int run = 0; run < NUM_RUNS; run++)
+        {
+            auto latency = std::make_unique<Helpers::LatencyHistogram>();
+            numCorrect = 0;
+            numRecognized = 0;
+            for (const Query& query : queries)
+            {
+                const auto queryStart = std::chrono::steady_clock::now();
+                const PoseRecognition recognition = recognizer.Recognize(query.hand);
+                latency->Record(std::chrono::steady_clock::now() - queryStart);
+                numCorrect += recognition.label == query.expected;
+                numRecognized += recognition.isRecognized;
+            }
+            if (!kdTreeLatency || latency->GetSnapshot().GetPercentileNanos(99.0) <
+                                      kdTreeLatency->GetSnapshot().GetPercentileNanos(99.0))
+                kdTreeLatency = std::move(latency);
+        }
+
+        for (size_t i = 0; i < NUM_BRUTE_FORCE_QUERIES; i++)
+        {
+            PoseNeighbor expected[MAX_POSE_NEIGHBORS];
+            PoseNeighbor found[MAX_POSE_NEIGHBORS];
+            const auto queryStart = std::chrono::steady_clock::now();
+            const PoseFeatures features = ExtractPoseFeatures(queries[i].hand);
+            const size_t numExpected = bruteForce.FindNearest(features, config.k, expected);
+            bruteForceLatency->Record(std::chrono::steady_clock::now() - queryStart);
+
+            const size_t numFound = recognizer.GetIndex().FindNearest(features, config.k, found);
+            bool isSame = numFound == numExpected;
+            for (size_t j = 0; isSame && j < numFound; j++)
+            {
+                const float expectedSquared = expected[j].distanceSquared;
+                const float error = std::abs(found[j].distanceSquared - expectedSquared);
+                isSame = error <= MAX_RELATIVE_ERROR * std::max(expectedSquared, 1e-6f);
+            }
+            numMismatches += !isSame;
+        }
+
+        PrintLatency("KD-tree    ", *kdTreeLatency);
+        PrintLatency("brute force", *bruteForceLatency);
+        std::cout << "    " << 100.0 * numCorrect / queries.size() << "% labelled right, "
+                  << 100.0 * numRecognized / queries.size() << "% recognized\n";
+        isFastEnough &= kdTreeLatency->GetSnapshot().GetPercentileNanos(99.0) <= MAX_P99_NANOS;
+    }
+
+    if (numMismatches > 0)
+    {
+        std::cout << "FAIL: the KD-tree and brute force found different neighbours for "
+                  << numMismatches << " queries\n";
+        return 1;
+    }
+    if (!isFastEnough)
+    {
+        std::cout << "FAIL: the slowest 1% of recognitions took over " << MAX_P99_NANOS / 1e3
+                  << "us\n";
+        return 1;
+    }
+    std::cout << "OK: the KD-tree matched brute force, and recognized 99% of hands within "
+              << MAX_P99_NANOS / 1e3 << "us\n";
+    return 0;
+}
@@ -0,0 +1,133 @@
+#include <Helpers/SeqLock.hpp>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// Hammers a SeqLock with one writer storing as fast as it can and several readers loading as
+// fast as they can, the way the Leap Motion polling thread and the gesture driver share frames.
+// Every word of a payload is derived from the same store number, so a read that mixes two stores
+// is caught. Fails on any torn or out-of-order read, or if the readers manage less than
+// MIN_READ_RATE_HZ between them.
+
+constexpr std::chrono::seconds DURATION{3};
+constexpr double MIN_READ_RATE_HZ = 1'000'000;
+
+// about the size of a Leap::TrackingFrame with two hands
+constexpr size_t NUM_PAYLOAD_WORDS = 150;
+
+struct Payload
+{
+    uint64_t storeNumber;
+    std::array<uint64_t, NUM_PAYLOAD_WORDS> words;
+};
+
+uint64_t ExpectedWord(uint64_t storeNumber, size_t index)
+{
+    return storeNumber * 0x9E3779B97F4A7C15ull + index;
+}
+
+struct ReaderResult
+{
+    uint64_t numReads;
+    uint64_t numTornReads;
+    uint64_t numBackwardReads;  // older than a store this reader already saw
+};
+
+int main()
+{
+    const unsigned numReaders = std::max(2u, std::thread::hardware_concurrency() - 1);
+
+    Helpers::SeqLock<Payload> slot;
+    std::atomic<bool> isRunning = true;
+
+    uint64_t numStores = 0;
+    std::thread writer(
+        [&]
+        {
+            Payload payload{};
+            while (isRunning.load(std::memory_order_relaxed))
+            {
+                payload.storeNumber = ++numStores;
+                for (size_t i = 0; i < NUM_PAYLOAD_WORDS; i++)
+                    payload.words[i] = ExpectedWord(payload.storeNumber, i);
+                slot.Store(payload);
+            }
+        });
+
+    std::vector<ReaderResult> results(numReaders);
+    std::vector<std::thread> readers;
+    for (unsigned r = 0; r < numReaders; r++)
+    {
+        readers.emplace_back(
+            [&, r]
+            {
+                ReaderResult result{};
+                uint64_t lastStoreNumber = 0;
+                while (isRunning.load(std::memory_order_relaxed))
+                {
+                    const Payload payload = slot.Load();
+                    result.numReads++;
+                    // the value before the first store is all zeroes, which isn't a store's
+                    if (payload.storeNumber == 0)
+                    {
+                        result.numTornReads += payload.words != decltype(payload.words){};
+                        continue;
+                    }
+                    for (size_t i = 0; i < NUM_PAYLOAD_WORDS; i++)
+                    {
+                        if (payload.words[i] != ExpectedWord(payload.storeNumber, i))
+                        {
+                            result.numTornReads++;
+                            break;
+                        }
+                    }
+                    result.numBackwardReads += payload.storeNumber < lastStoreNumber;
+                    lastStoreNumber = std::max(lastStoreNumber, payload.storeNumber);
+                }
+                results[r] = result;
+            });
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(DURATION);
+    isRunning = false;
+    writer.join();
+    for (std::thread& reader : readers)
+        reader.join();
+    const auto end = std::chrono::steady_clock::now();
+
+    ReaderResult total{};
+    for (const ReaderResult& result : results)
+    {
+        total.numReads += result.numReads;
+        total.numTornReads += result.numTornReads;
+        total.numBackwardReads += result.numBackwardReads;
+    }
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    const double readRateHz = total.numReads / seconds;
+
+    std::cout << numReaders << " readers, " << sizeof(Payload) << " byte payload, " << seconds
+              << " s\n";
+    std::cout << "    stores: " << numStores << " (" << numStores / seconds / 1e6 << " MHz)\n";
+    std::cout << "    reads:  " << total.numReads << " (" << readRateHz / 1e6 << " MHz)\n";
+    std::cout << "    torn reads: " << total.numTornReads
+              << ", out-of-order reads: " << total.numBackwardReads << "\n";
+
+    if (total.numTornReads != 0 || total.numBackwardReads != 0)
+    {
+        std::cout << "FAIL: a reader saw a payload that no single store wrote\n";
+        return 1;
+    }
+    if (readRateHz < MIN_READ_RATE_HZ)
+    {
+        std::cout << "FAIL: the readers managed less than " << MIN_READ_RATE_HZ / 1e6 << " MHz\n";
+        return 1;
+    }
+    std::cout << "OK: every read was a whole store\n";
+    return 0;
+}
@@ -0,0 +1,104 @@
+#include "../UserStudy/LogArena.hpp"
+#include "../UserStudy/Logging.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Counts every heap allocation made by the process, so the benchmark can report
+// allocations per event for the serialization path.
+std::atomic<uint64_t> allocationCount{0};
+
+void* operator new(size_t size)
+{
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept { std::free(ptr); }
+void operator delete(void* ptr, size_t) noexcept { std::free(ptr); }
+
+constexpr int NUM_EVENTS = 1'000'000;
+
+// What the logger used to do per event: a stringstream, its result string,
+// and a copy of that string into a buffer slot.
+template <typename T, typename Fn>
+void RunLegacy(const char* name, const T& event, Fn&& writeFields)
+{
+    std::vector<std::string> slots(1000);
+
+    uint64_t allocationsBefore = allocationCount.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_EVENTS; i++)
+    {
+        std::stringstream ss;
+        ss << std::boolalpha;
+        writeFields(ss, event);
+        std::string line = ss.str();
+        slots[i % slots.size()] = line;
+    }
+    auto end = std::chrono::steady_clock::now();
+    uint64_t allocations = allocationCount.load() - allocationsBefore;
+
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << "[legacy] " << name << ": " << static_cast<double>(allocations) / NUM_EVENTS
+              << " allocations/event, " << static_cast<double>(nanos) / NUM_EVENTS
+              << " ns/event\n";
+}
+
+// The current path: build the fixed-size record, serialize it into the arena,
+// and clear the arena whenever the writer thread would flush.
+template <Logging::Loggable T>
+void RunArena(const char* name, const T& event)
+{
+    Logging::LogArena arena;
+
+    uint64_t allocationsBefore = allocationCount.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < NUM_EVENTS; i++)
+    {
+        Logging::EventRecord record = Logging::ToRecord(event);
+        Logging::SerializeRecord(record, arena);
+        arena.Append('\n');
+        if (arena.Remaining() < Logging::MAX_SERIALIZED_EVENT_SIZE)
+            arena.Clear();
+    }
+    auto end = std::chrono::steady_clock::now();
+    uint64_t allocations = allocationCount.load() - allocationsBefore;
+
+    auto nanos = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    std::cout << "[arena]  " << name << ": " << static_cast<double>(allocations) / NUM_EVENTS
+              << " allocations/event, " << static_cast<double>(nanos) / NUM_EVENTS
+              << " ns/event\n";
+}
+
+int main()
+{
+    const Logging::Events::CursorPosition cursor{1700000000000, 1234, 567};
+    const Logging::Events::Keystroke keystroke{1700000000000, "Backspace", true};
+
+    RunLegacy("CursorPosition", cursor,
+              [](std::stringstream& ss, const Logging::Events::CursorPosition& e)
+              {
+                  ss << "CursorPosition" << Logging::DELIMITER << e.timestampMillis
+                     << Logging::DELIMITER << e.positionX << Logging::DELIMITER << e.positionY;
+              });
+    RunArena("CursorPosition", cursor);
+
+    RunLegacy("Keystroke", keystroke,
+              [](std::stringstream& ss, const Logging::Events::Keystroke& e)
+              {
+                  ss << "Keystroke" << Logging::DELIMITER << e.timestampMillis
+                     << Logging::DELIMITER << e.key << Logging::DELIMITER << e.wasCorrect;
+              });
+    RunArena("Keystroke", keystroke);
+
+    return 0;
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <iostream>
+#include <string>
+
+// The pass/fail checks the standalone tests share: every check prints a line, and main returns
+// FinishChecks() so the test fails if any of them did.
+
+inline int failures = 0;
+
+inline void Check(bool condition, const std::string& description)
+{
+    std::cout << (condition ? "[PASS] " : "[FAIL] ") << description << std::endl;
+    if (!condition)
+        failures++;
+}
+
+/// @brief Prints whether every check passed.
+/// @return The exit code for main.
+inline int FinishChecks()
+{
+    std::cout << (failures == 0 ? "All checks passed." : "Some checks failed.") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
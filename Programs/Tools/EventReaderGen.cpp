@@ -0,0 +1,240 @@
+#include <Programs/UserStudy/EventSchema.hpp>
+#include <Programs/UserStudy/Logging.hpp>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+// Generates log_events.py, the Python reader for text participant logs, from the event schema
+// in EventSchema.hpp. Offline analysis scripts (process.py) import it instead of keeping their
+// own copy of the log format, so they can't drift from what the logger actually writes.
+
+/// @brief timestampMillis -> timestamp_millis
+std::string ToSnakeCase(std::string_view name)
+{
+    std::string snake;
+    for (char c : name)
+    {
+        if (std::isupper(static_cast<unsigned char>(c)))
+        {
+            if (!snake.empty())
+                snake += '_';
+            snake += static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+        }
+        else
+        {
+            snake += c;
+        }
+    }
+    return snake;
+}
+
+std::string ToUpperSnakeCase(std::string_view name)
+{
+    std::string snake = ToSnakeCase(name);
+    for (char& c : snake)
+        c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    return snake;
+}
+
+template <typename Type>
+std::string PythonType()
+{
+    if constexpr (std::is_same_v<Type, bool>)
+        return "bool";
+    else if constexpr (std::is_same_v<Type, std::string> || std::is_enum_v<Type>)
+        return "str";
+    else
+        return "int";
+}
+
+/// @brief Python expression that converts token to the field's type.
+template <typename Type>
+std::string PythonConversion(const std::string& token)
+{
+    if constexpr (std::is_same_v<Type, bool>)
+        return "_parse_bool(" + token + ")";
+    else if constexpr (std::is_same_v<Type, std::string>)
+        return token;
+    else if constexpr (std::is_enum_v<Type>)
+        return "_parse_enum(" + token + ", " +
+               ToUpperSnakeCase(Logging::EnumSchema<Type>::NAME) + ")";
+    else
+        return "int(" + token + ")";
+}
+
+template <typename E>
+void WriteEnum(std::ostream& out)
+{
+    const auto& values = Logging::EnumSchema<E>::VALUES;
+    out << ToUpperSnakeCase(Logging::EnumSchema<E>::NAME) << " = (";
+    for (size_t i = 0; i < values.size(); i++)
+        out << (i == 0 ? "\"" : ", \"") << values[i] << "\"";
+    out << ")\n";
+}
+
+template <Logging::Loggable T>
+void WriteEvent(std::ostream& out)
+{
+    const std::string_view name = Logging::EventSchema<T>::NAME;
+    out << "\n\n@dataclass\nclass " << name << ":\n";
+    Logging::ForEachField<T>(
+        [&](const auto& field)
+        {
+            using Type = typename Logging::FieldOf<decltype(field)>::Type;
+            out << "    " << ToSnakeCase(field.name) << ": " << PythonType<Type>() << "\n";
+        });
+    out << "    event_type: str = \"" << name << "\"\n";
+
+    const size_t textIndex = Logging::TextFieldIndex<T>();
+    const bool hasText = textIndex < Logging::NUM_FIELDS<T>;
+    const size_t fieldsBefore = hasText ? textIndex : Logging::NUM_FIELDS<T>;
+    const size_t fieldsAfter = hasText ? Logging::NUM_FIELDS<T> - textIndex - 1 : 0;
+
+    out << "\n\ndef _parse_" << ToSnakeCase(name) << "(fields: str) -> " << name << ":\n"
+        << "    t = _split(fields, " << fieldsBefore << ", " << fieldsAfter << ", "
+        << (hasText ? "True" : "False") << ")\n"
+        << "    return " << name << "(";
+    size_t index = 0;
+    Logging::ForEachField<T>(
+        [&](const auto& field)
+        {
+            using Type = typename Logging::FieldOf<decltype(field)>::Type;
+            out << (index == 0 ? "" : ", ")
+                << PythonConversion<Type>("t[" + std::to_string(index) + "]");
+            index++;
+        });
+    out << ")\n";
+}
+
+void WriteReader(std::ostream& out)
+{
+    out << "# Generated by eventReaderGen from Programs/UserStudy/EventSchema.hpp. Do not edit.\n"
+        << "# Regenerate with: cmake --build <build directory> --target pythonEventReader\n"
+        << "from dataclasses import dataclass\n"
+        << "from typing import Iterator, Optional\n"
+        << "\nDELIMITER = \"" << Logging::DELIMITER << "\"\n\n";
+
+    // every enum any event uses, once
+    std::set<std::string_view> enumsWritten;
+    Logging::ForEachEventType(
+        [&](auto event)
+        {
+            Logging::ForEachField<typename decltype(event)::type>(
+                [&](const auto& field)
+                {
+                    using Type = typename Logging::FieldOf<decltype(field)>::Type;
+                    if constexpr (std::is_enum_v<Type>)
+                    {
+                        if (enumsWritten.insert(Logging::EnumSchema<Type>::NAME).second)
+                            WriteEnum<Type>(out);
+                    }
+                });
+        });
+
+    out << R"(
+
+def _parse_bool(token: str) -> bool:
+    if token not in ("true", "false"):
+        raise ValueError(f"not a bool: {token!r}")
+    return token == "true"
+
+
+def _parse_enum(token: str, values: tuple) -> str:
+    if token not in values:
+        raise ValueError(f"not one of {values}: {token!r}")
+    return token
+
+
+def _split(fields: str, before: int, after: int, has_text: bool) -> list:
+    """Splits the fields after the event name.
+    A string field may contain the delimiter itself, so the fields after it are split off the end
+    and the string is whatever is left in between."""
+    if not has_text:
+        tokens = fields.split(DELIMITER)
+        if len(tokens) != before:
+            raise ValueError(f"expected {before} fields: {fields!r}")
+        return tokens
+
+    head = fields.split(DELIMITER, before)
+    if len(head) != before + 1:
+        raise ValueError(f"expected at least {before + after + 1} fields: {fields!r}")
+    tail = head.pop().rsplit(DELIMITER, after)
+    if len(tail) != after + 1:
+        raise ValueError(f"expected at least {before + after + 1} fields: {fields!r}")
+    return head + tail
+)";
+
+    Logging::ForEachEventType([&out](auto event)
+                              { WriteEvent<typename decltype(event)::type>(out); });
+
+    out << "\n\n_PARSERS = {\n";
+    Logging::ForEachEventType(
+        [&out](auto event)
+        {
+            using T = typename decltype(event)::type;
+            const std::string_view name = Logging::EventSchema<T>::NAME;
+            out << "    \"" << name << "\": _parse_" << ToSnakeCase(name) << ",\n";
+        });
+    out << "}\n";
+
+    out << R"(
+
+def parse_line(line: str) -> Optional[object]:
+    """Parses one line of a text log. Returns None for blank lines, raises ValueError if the line
+    is not a well-formed event."""
+    if line.endswith("\n"):
+        line = line[:-1]
+    if line.endswith("\r"):
+        line = line[:-1]
+    if line == "":
+        return None
+
+    name, delimiter, fields = line.partition(DELIMITER)
+    if name not in _PARSERS or delimiter == "":
+        raise ValueError(f"unknown event: {line!r}")
+    return _PARSERS[name](fields)
+
+
+def read_log(filename: str) -> Iterator[object]:
+    """Yields every event of a text log, in the order they were logged.
+    Use log2text to convert binary or compressed logs first."""
+    with open(filename, "r", encoding="utf-8", newline="") as logfile:
+        for line in logfile:
+            event = parse_line(line)
+            if event is not None:
+                yield event
+)";
+}
+
+int main(int argc, char** argv)
+{
+    if (argc > 2)
+    {
+        std::cout << "Usage: eventReaderGen [output file]\n"
+                  << "    Writes log_events.py to stdout if no output file is given.\n";
+        return 1;
+    }
+
+    std::ostringstream reader;
+    WriteReader(reader);
+
+    if (argc == 1)
+    {
+        std::cout << reader.str();
+        return 0;
+    }
+
+    // binary mode, so the generated file has the same line endings everywhere
+    std::ofstream outFile(argv[1], std::ios::trunc | std::ios::binary);
+    if (!outFile || !(outFile << reader.str()))
+    {
+        std::cerr << "[eventReaderGen] Unable to write " << argv[1] << "\n";
+        return 1;
+    }
+    std::cout << "[eventReaderGen] Wrote " << argv[1] << "\n";
+    return 0;
+}
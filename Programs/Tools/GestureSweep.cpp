@@ -0,0 +1,502 @@
+#include <Helpers/ThreadPool.hpp>
+#include <Input/FrameCapture.hpp>
+#include <Input/LeapMotionGestureProvider.hpp>
+#include <Input/SyntheticHands.hpp>
+#include <Math/ConstexprMath.hpp>
+#include <Math/MathHelpers.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Replays frame captures (see --replay) through the gesture pipeline once for every combination
+// of gesture parameters in a grid, simulating what the driver would have done with each:
+//   coneDegrees    TOLERANCE_CONE_ANGLE_DEGREES, the click and movement cones
+//   speed          the driver's cursor speed, in pixels per second
+//   directions     NUM_CURSOR_DIRECTIONS
+// and writes one row of metrics per combination.
+//
+// The parameters only change how a frame is judged, not what is measured off the hand, so every
+// frame is reduced once to what ProcessHandState compares (the palm normal's components along and
+// across each cone's axis, and the average finger angle). Each combination is then a few
+// multiplications, comparisons and a table lookup per frame, which come out exactly as
+// ProcessHandState's would. Combinations are spread over a thread pool.
+
+namespace fs = std::filesystem;
+using namespace Input::Leap;
+
+// the driver's, see LeapDriver.cpp
+constexpr float MAX_FRAME_SECONDS = 0.05f;
+
+// A click pose held for less than this is taken to be the hand passing through the click cone on
+// its way to another pose, rather than a click the participant meant.
+constexpr double SHORT_CLICK_SECONDS = 0.15;
+
+constexpr double SYNTHETIC_FRAMERATE = 120.0;
+constexpr double SYNTHETIC_SESSION_MINUTES = 10.0;
+
+/// @brief One session's frames, reduced to what the gesture parameters act on.
+struct Session
+{
+    std::string name;
+    std::string error;
+    std::vector<float> frameSeconds;  // since the previous frame, clamped like the driver does
+    std::vector<uint8_t> hand;        // NO_HAND, LEFT_HAND or RIGHT_HAND
+
+    // The palm normal's component along each cone's axis, and its squared length, which is what
+    // Math::Cone::Contains compares against the cone's squared cosine.
+    std::vector<float> clickDist;
+    std::vector<float> moveDist;  // the axis is [1, 0, 0] for a left hand, [-1, 0, 0] for a right
+    std::vector<float> magnitudeSquared;
+    std::vector<float> averageFingerAngle;
+
+    double GetSeconds() const;
+};
+
+constexpr uint8_t NO_HAND = 0;
+constexpr uint8_t LEFT_HAND = 1;
+constexpr uint8_t RIGHT_HAND = 2;
+
+struct SweepConfig
+{
+    float coneDegrees;
+    float speed;
+    int numCursorDirections;
+};
+
+struct SweepResult
+{
+    uint64_t numFrames = 0;
+    double seconds = 0.0;
+    double handSeconds = 0.0;  // with a hand in view
+    double clickPoseSeconds = 0.0;
+    double movePoseSeconds = 0.0;
+    uint64_t clicks = 0;
+    uint64_t shortClicks = 0;
+    double pathLengthPixels = 0.0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+int PrintUsage();
+bool ParseGrid(const char* text, std::vector<float>& values);
+std::vector<std::string> FindCaptures(const std::vector<std::string>& paths);
+
+Session LoadCapture(const std::string& filename);
+Session MakeSyntheticSession(size_t index, size_t numFrames);
+void AddFrame(Session& session, const TrackingFrame& frame, float frameSeconds);
+
+void Simulate(const Session& session, const SweepConfig& config, SweepResult& result);
+bool WriteResults(const fs::path& filename, const std::vector<SweepConfig>& configs,
+                  const std::vector<SweepResult>& results);
+
+///////////////////////////////////////////////////////////////////////////////
+// Main
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+    size_t numThreads = 0;
+    fs::path outputFilename = "gestureSweep.csv";
+    double syntheticMinutes = 0.0;
+    std::vector<float> cones = {15.0f, 20.0f, 25.0f, 30.0f, 35.0f};
+    std::vector<float> speeds = {200.0f, 300.0f, 400.0f, 500.0f, 600.0f};
+    std::vector<float> directions = {4.0f, 8.0f, 12.0f, 16.0f};
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const bool hasValue = i + 1 < argc;
+        bool isValid = true;
+        if ((!std::strcmp(argv[i], "--threads") || !std::strcmp(argv[i], "-j")) && hasValue)
+            numThreads = std::stoul(argv[++i]);
+        else if ((!std::strcmp(argv[i], "--output") || !std::strcmp(argv[i], "-o")) && hasValue)
+            outputFilename = argv[++i];
+        else if (!std::strcmp(argv[i], "--cones") && hasValue)
+            isValid = ParseGrid(argv[++i], cones);
+        else if (!std::strcmp(argv[i], "--speeds") && hasValue)
+            isValid = ParseGrid(argv[++i], speeds);
+        else if (!std::strcmp(argv[i], "--directions") && hasValue)
+            isValid = ParseGrid(argv[++i], directions);
+        else if (!std::strcmp(argv[i], "--synthetic") && hasValue)
+            syntheticMinutes = std::stod(argv[++i]);
+        else if (!std::strcmp(argv[i], "--help") || !std::strcmp(argv[i], "-h"))
+            return PrintUsage();
+        else
+            paths.push_back(argv[i]);
+
+        if (!isValid)
+        {
+            std::cerr << "[gestureSweep] Invalid grid: " << argv[i] << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<SweepConfig> configs;
+    for (float cone : cones)
+    {
+        for (float speed : speeds)
+        {
+            for (float numDirections : directions)
+                configs.push_back({cone, speed, std::max(1, static_cast<int>(numDirections))});
+        }
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    Helpers::ThreadPool pool(numThreads);
+
+    // every job writes only its own slot, so neither sessions nor results need locking
+    std::vector<Session> sessions;
+    if (syntheticMinutes > 0.0)
+    {
+        const size_t numFrames = static_cast<size_t>(syntheticMinutes * 60.0 * SYNTHETIC_FRAMERATE);
+        const size_t framesPerSession =
+            static_cast<size_t>(SYNTHETIC_SESSION_MINUTES * 60.0 * SYNTHETIC_FRAMERATE);
+        sessions.resize((numFrames + framesPerSession - 1) / framesPerSession);
+        for (size_t i = 0; i < sessions.size(); i++)
+        {
+            const size_t sessionFrames =
+                std::min(framesPerSession, numFrames - i * framesPerSession);
+            pool.Submit([&sessions, i, sessionFrames]
+                        { sessions[i] = MakeSyntheticSession(i, sessionFrames); });
+        }
+    }
+    else
+    {
+        if (paths.empty())
+            paths.push_back("Logs");
+        const std::vector<std::string> captures = FindCaptures(paths);
+        sessions.resize(captures.size());
+        for (size_t i = 0; i < captures.size(); i++)
+            pool.Submit([&sessions, &captures, i] { sessions[i] = LoadCapture(captures[i]); });
+    }
+    pool.Wait();
+
+    uint64_t totalFrames = 0;
+    double totalSeconds = 0.0;
+    for (const Session& session : sessions)
+    {
+        if (!session.error.empty())
+            std::cerr << "[gestureSweep] " << session.name << ": " << session.error << "\n";
+        totalFrames += session.frameSeconds.size();
+        totalSeconds += session.GetSeconds();
+    }
+    if (totalFrames == 0)
+    {
+        std::cerr << "[gestureSweep] No frames to sweep over.\n";
+        return 1;
+    }
+    const double loadSeconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // a job per combination: thousands of jobs, each a pass over every frame
+    std::vector<SweepResult> results(configs.size());
+    for (size_t i = 0; i < configs.size(); i++)
+    {
+        pool.Submit(
+            [&sessions, &configs, &results, i]
+            {
+                for (const Session& session : sessions)
+                    Simulate(session, configs[i], results[i]);
+            });
+    }
+    pool.Wait();
+
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (!WriteResults(outputFilename, configs, results))
+    {
+        std::cerr << "[gestureSweep] Unable to write results to " << outputFilename << "\n";
+        return 1;
+    }
+
+    std::cout << "[gestureSweep] Swept " << configs.size() << " parameter sets over "
+              << totalFrames << " frames (" << totalSeconds / 60.0 << " min of tracking) from "
+              << sessions.size() << " sessions on " << pool.NumThreads() << " threads in "
+              << seconds << " s (" << loadSeconds << " s loading, "
+              << configs.size() * totalFrames / std::max(seconds - loadSeconds, 1e-9) / 1e6
+              << " M frames/s simulated).\n";
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+double Session::GetSeconds() const
+{
+    double seconds = 0.0;
+    for (float frame : frameSeconds)
+        seconds += frame;
+    return seconds;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+int PrintUsage()
+{
+    std::cout
+        << "Usage: gestureSweep [options] [captures/directories...]\n"
+        << "    Directories are searched for *.frames. Defaults to Logs/.\n"
+        << "    --cones <grid>        cone angles in degrees (default 15,20,25,30,35)\n"
+        << "    --speeds <grid>       cursor speeds in pixels per second (default 200:600:100)\n"
+        << "    --directions <grid>   numbers of cursor directions (default 4,8,12,16)\n"
+        << "    --synthetic <minutes> sweep over synthetic hands instead of captures\n"
+        << "    --threads N           default: one per hardware thread\n"
+        << "    --output <file>       default: gestureSweep.csv\n"
+        << "    A grid is a list (1,2,5) or an inclusive range with a step (10:40:2.5).\n"
+        << "    Every combination of the three grids is simulated.\n";
+    return 0;
+}
+
+bool ParseGrid(const char* text, std::vector<float>& values)
+{
+    values.clear();
+    const std::string grid = text;
+    try
+    {
+        const size_t firstColon = grid.find(':');
+        if (firstColon != std::string::npos)
+        {
+            const size_t secondColon = grid.find(':', firstColon + 1);
+            if (secondColon == std::string::npos)
+                return false;
+            const double first = std::stod(grid.substr(0, firstColon));
+            const double last =
+                std::stod(grid.substr(firstColon + 1, secondColon - firstColon - 1));
+            const double step = std::stod(grid.substr(secondColon + 1));
+            if (step <= 0.0 || last < first)
+                return false;
+            // the small allowance keeps a last value that the steps land on in the grid
+            for (size_t i = 0; first + i * step <= last + step * 1e-6; i++)
+                values.push_back(static_cast<float>(first + i * step));
+            return true;
+        }
+
+        size_t begin = 0;
+        while (begin <= grid.size())
+        {
+            const size_t comma = std::min(grid.find(',', begin), grid.size());
+            values.push_back(std::stof(grid.substr(begin, comma - begin)));
+            begin = comma + 1;
+        }
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    return !values.empty();
+}
+
+std::vector<std::string> FindCaptures(const std::vector<std::string>& paths)
+{
+    std::vector<std::string> captures;
+    for (const auto& path : paths)
+    {
+        std::error_code error;
+        if (!fs::is_directory(path, error))
+        {
+            captures.push_back(path);
+            continue;
+        }
+
+        for (const auto& entry : fs::directory_iterator(path, error))
+        {
+            if (entry.is_regular_file() && entry.path().extension() == ".frames")
+                captures.push_back(entry.path().string());
+        }
+    }
+
+    std::sort(captures.begin(), captures.end());
+    return captures;
+}
+
+Session LoadCapture(const std::string& filename)
+{
+    Session session;
+    session.name = fs::path(filename).filename().string();
+
+    FrameCaptureReader reader;
+    if (!reader.Open(filename))
+    {
+        session.error = "unable to open the capture, or it was recorded by a different build";
+        return session;
+    }
+
+    session.frameSeconds.reserve(reader.GetNumFrames());
+    int64_t lastMicros = 0;
+    for (size_t i = 0; i < reader.GetNumFrames(); i++)
+    {
+        const TrackingFrame frame = reader.GetFrame(i);
+        float frameSeconds = 0.0f;
+        if (i > 0)
+        {
+            frameSeconds = static_cast<float>(frame.timestampMicros - lastMicros) / 1e6f;
+            frameSeconds = std::clamp(frameSeconds, 0.0f, MAX_FRAME_SECONDS);
+        }
+        lastMicros = frame.timestampMicros;
+        AddFrame(session, frame, frameSeconds);
+    }
+    return session;
+}
+
+Session MakeSyntheticSession(size_t index, size_t numFrames)
+{
+    Session session;
+    session.name = "synthetic" + std::to_string(index);
+
+    SyntheticHandConfig config{};
+    config.seed = index + 1;
+    config.noiseRadians = 0.05f;
+    SyntheticHandGenerator generator(config);
+
+    TrackingFrame frame{};
+    frame.nHands = 1;
+    for (size_t i = 0; i < numFrames; i++)
+    {
+        frame.hands[0] = generator.NextHand();
+        AddFrame(session, frame, i > 0 ? static_cast<float>(1.0 / SYNTHETIC_FRAMERATE) : 0.0f);
+    }
+    return session;
+}
+
+void AddFrame(Session& session, const TrackingFrame& frame, float frameSeconds)
+{
+    session.frameSeconds.push_back(frameSeconds);
+    if (frame.nHands == 0)
+    {
+        session.hand.push_back(NO_HAND);
+        session.clickDist.push_back(0.0f);
+        session.moveDist.push_back(0.0f);
+        session.magnitudeSquared.push_back(0.0f);
+        session.averageFingerAngle.push_back(0.0f);
+        return;
+    }
+
+    // the driver only looks at the most recent hand
+    using Vec3 = Math::Vector3Common;
+    const UnprocessedHandState state = ToUnprocessedHandState(frame.hands[frame.nHands - 1]);
+    session.hand.push_back(state.isLeft ? LEFT_HAND : RIGHT_HAND);
+
+    // the same steps as Math::Cone::Contains
+    session.clickDist.push_back(Vec3::DotProduct(state.palmNormal, CLICK_CONE.axis));
+    session.moveDist.push_back(Vec3::DotProduct(
+        state.palmNormal, state.isLeft ? LEFT_MOVE_CONE.axis : RIGHT_MOVE_CONE.axis));
+    session.magnitudeSquared.push_back(state.palmNormal.MagnitudeSquared());
+    session.averageFingerAngle.push_back(GetAverageFingerAngle(state));
+}
+
+void Simulate(const Session& session, const SweepConfig& config, SweepResult& result)
+{
+    // as in Math::Cone::Contains, for an axis of length 1
+    const Math::Cone cone(CLICK_CONE.axis, config.coneDegrees * Math::DEG_TO_RAD);
+    auto isInCone = [&cone](float dist, float magnitudeSquared)
+    { return dist * dist > cone.cosineSquared * magnitudeSquared; };
+
+    // cursor directions by sector, as MakeCursorDirections works them out, for a right hand
+    const int numSectors = 2 * config.numCursorDirections;
+    const float sectorArcLength = Math::_PI / config.numCursorDirections;
+    std::vector<float> directionX(numSectors + 1);
+    std::vector<float> directionY(numSectors + 1);
+    for (int sector = 0; sector <= numSectors; sector++)
+    {
+        const int scaleFactor = ((sector + 1) / 2) * 2;
+        const float angle = scaleFactor * sectorArcLength;
+        directionX[sector] = -static_cast<float>(Math::Constexpr::Sin(angle));
+        directionY[sector] = static_cast<float>(Math::Constexpr::Cos(angle));
+    }
+
+    // the driver's state, see LeapDriver.cpp
+    bool isClickDisengaged = true;
+    float dxAccumulator = 0.0f;
+    float dyAccumulator = 0.0f;
+    double clickRunSeconds = 0.0;
+    bool isInClickRun = false;  // a click was made, and the pose hasn't been left since
+    auto endClickRun = [&]()
+    {
+        if (isInClickRun && clickRunSeconds < SHORT_CLICK_SECONDS)
+            result.shortClicks++;
+        isInClickRun = false;
+    };
+
+    const size_t numFrames = session.frameSeconds.size();
+    for (size_t i = 0; i < numFrames; i++)
+    {
+        const float frameSeconds = session.frameSeconds[i];
+        result.seconds += frameSeconds;
+        if (session.hand[i] == NO_HAND)
+        {
+            endClickRun();
+            continue;
+        }
+        result.handSeconds += frameSeconds;
+
+        if (isInCone(session.clickDist[i], session.magnitudeSquared[i]))
+        {
+            result.clickPoseSeconds += frameSeconds;
+            clickRunSeconds += frameSeconds;
+            if (isClickDisengaged)
+            {
+                result.clicks++;
+                isClickDisengaged = false;
+                isInClickRun = true;
+                clickRunSeconds = 0.0;
+            }
+            continue;
+        }
+
+        endClickRun();
+        isClickDisengaged = true;
+        if (!isInCone(session.moveDist[i], session.magnitudeSquared[i]))
+            continue;
+
+        result.movePoseSeconds += frameSeconds;
+        const int sector = std::clamp(
+            static_cast<int>(session.averageFingerAngle[i] / sectorArcLength), 0, numSectors);
+        const float handSign = session.hand[i] == LEFT_HAND ? -1.0f : 1.0f;
+        dxAccumulator += directionX[sector] * handSign * config.speed * frameSeconds;
+        dyAccumulator += directionY[sector] * config.speed * frameSeconds * -1.0f;
+
+        const int dx = static_cast<int>(dxAccumulator);
+        const int dy = static_cast<int>(dyAccumulator);
+        dxAccumulator -= static_cast<float>(dx);
+        dyAccumulator -= static_cast<float>(dy);
+        result.pathLengthPixels += std::sqrt(static_cast<double>(dx * dx + dy * dy));
+    }
+    endClickRun();
+    result.numFrames += numFrames;
+}
+
+bool WriteResults(const fs::path& filename, const std::vector<SweepConfig>& configs,
+                  const std::vector<SweepResult>& results)
+{
+    std::ofstream file(filename);
+    if (!file)
+        return false;
+
+    file << "coneDegrees,speed,directions,frames,seconds,handSeconds,clicks,clicksPerMinute,"
+            "shortClicks,clickFalsePositiveRate,clickPoseFraction,movePoseFraction,"
+            "pathLengthPixels,pixelsPerMovingSecond\n";
+    for (size_t i = 0; i < configs.size(); i++)
+    {
+        const SweepConfig& config = configs[i];
+        const SweepResult& result = results[i];
+        const double handSeconds = std::max(result.handSeconds, 1e-9);
+        file << config.coneDegrees << ',' << config.speed << ',' << config.numCursorDirections
+             << ',' << result.numFrames << ',' << result.seconds << ',' << result.handSeconds
+             << ',' << result.clicks << ',' << result.clicks / std::max(result.seconds, 1e-9) * 60.0
+             << ',' << result.shortClicks << ','
+             << static_cast<double>(result.shortClicks) / std::max<uint64_t>(result.clicks, 1)
+             << ',' << result.clickPoseSeconds / handSeconds << ','
+             << result.movePoseSeconds / handSeconds << ',' << result.pathLengthPixels << ','
+             << result.pathLengthPixels / std::max(result.movePoseSeconds, 1e-9) << '\n';
+    }
+    return static_cast<bool>(file);
+}
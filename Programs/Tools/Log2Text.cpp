@@ -0,0 +1,191 @@
+#include <Programs/UserStudy/BinaryLog.hpp>
+#include <Programs/UserStudy/CursorStream.hpp>
+#include <Programs/UserStudy/LogArena.hpp>
+#include <Programs/UserStudy/LogCompression.hpp>
+#include <Programs/UserStudy/Logging.hpp>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+// Converts a binary participant log back into the semicolon-delimited text format,
+// byte-for-byte identical to what the logger writes in LogFormat::Text.
+// Compressed logs (text or binary) are decompressed on the fly.
+// Works one batch at a time, so arbitrarily large logs can be converted.
+// With --expand-cursor, every CursorHold is expanded back into the fixed-rate CursorPosition
+// samples it stands for (see CursorStream.hpp). Text logs can be expanded too.
+
+int main(int argc, char** argv)
+{
+    const bool isExpanding = argc > 1 && std::string_view(argv[1]) == "--expand-cursor";
+    if (isExpanding)
+    {
+        argc--;
+        argv++;
+    }
+
+    if (argc != 2 && argc != 3)
+    {
+        std::cout << "Usage: log2text [--expand-cursor] <binary or compressed log> [output file]\n"
+                  << "    Writes to stdout if no output file is given.\n"
+                  << "    --expand-cursor writes held cursor samples out one by one,\n"
+                  << "    and also accepts text logs.\n";
+        return 1;
+    }
+
+    std::ifstream inFile(argv[1], std::ios::binary);
+    if (!inFile)
+    {
+        std::cerr << "[log2text] Unable to open " << argv[1] << "\n";
+        return 1;
+    }
+
+    // binary mode: line terminators are already what the logger's text mode writes
+    std::ofstream outFile;
+    if (argc == 3)
+    {
+        outFile.open(argv[2], std::ios::trunc | std::ios::binary);
+        if (!outFile)
+        {
+            std::cerr << "[log2text] Unable to open " << argv[2] << "\n";
+            return 1;
+        }
+    }
+#ifdef _WIN32
+    else
+    {
+        _setmode(_fileno(stdout), _O_BINARY);
+    }
+#endif
+    std::ostream& out = argc == 3 ? outFile : std::cout;
+
+    char magic[Logging::BINARY_LOG_MAGIC.size()] = {};
+    inFile.read(magic, sizeof(magic));
+    inFile.clear();
+    inFile.seekg(0);
+
+    std::istream* in = &inFile;
+    std::optional<Logging::DecompressingStreamBuf> decompressor;
+    std::istream decompressed(nullptr);
+    const bool isCompressed = Logging::IsCompressedLog(std::string_view(magic, sizeof(magic)));
+    if (isCompressed)
+    {
+        decompressor.emplace(inFile);
+        if (!decompressor->IsValid())
+        {
+            std::cerr << "[log2text] " << argv[1] << " has an unsupported compressed log header.\n";
+            return 1;
+        }
+        decompressed.rdbuf(&*decompressor);
+        in = &decompressed;
+
+        // peek at what was compressed; the first block always holds more than the magic
+        in->read(magic, sizeof(magic));
+        const std::streamsize peeked = in->gcount();
+        for (std::streamsize i = 0; i < peeked; i++)
+            in->unget();
+    }
+
+    Logging::CursorStreamDecoder cursorDecoder;
+    Logging::LogArena arena;
+    auto writeRecord = [&arena](const Logging::EventRecord& record)
+    {
+        Logging::SerializeRecord(record, arena);
+        arena.Append(Logging::LINE_TERMINATOR);
+    };
+
+    if (!Logging::IsBinaryLog(std::string_view(magic, sizeof(magic))) && isExpanding)
+    {
+        std::string line;
+        Logging::EventRecord record;
+        uint64_t numEvents = 0;
+        uint64_t numSkipped = 0;
+        while (std::getline(*in, line))
+        {
+            if (!Logging::ParseRecord(line, record))
+            {
+                numSkipped++;
+                continue;
+            }
+            cursorDecoder.Push(record, writeRecord);
+            out.write(arena.Data(), arena.Size());
+            arena.Clear();
+            numEvents++;
+        }
+        cursorDecoder.Finish(writeRecord);
+        out.write(arena.Data(), arena.Size());
+
+        if (isCompressed && !decompressor->IsValid())
+        {
+            std::cerr << "[log2text] Stopped at a truncated or corrupt block.\n";
+            return 2;
+        }
+        std::cerr << "[log2text] Expanded " << numEvents << " events, skipped " << numSkipped
+                  << " unreadable lines.\n";
+        return 0;
+    }
+
+    if (!Logging::IsBinaryLog(std::string_view(magic, sizeof(magic))))
+    {
+        if (!isCompressed)
+        {
+            std::cerr << "[log2text] " << argv[1] << " is not a binary or compressed log.\n";
+            return 1;
+        }
+
+        // a compressed text log only needs decompressing
+        out << in->rdbuf();
+        if (!decompressor->IsValid())
+        {
+            std::cerr << "[log2text] Stopped at a truncated or corrupt block.\n";
+            return 2;
+        }
+        std::cerr << "[log2text] Decompressed " << argv[1] << ".\n";
+        return 0;
+    }
+
+    Logging::BinaryLogReader reader(*in);
+    if (!reader.ReadHeader())
+    {
+        std::cerr << "[log2text] " << argv[1] << " is not a binary log (up to version "
+                  << Logging::BINARY_LOG_VERSION << ").\n";
+        return 1;
+    }
+
+    Logging::DecodedBatch batch;
+    uint64_t numEvents = 0;
+    while (reader.NextBatch(batch))
+    {
+        if (isExpanding)
+        {
+            batch.ForEachInOrder([&](const Logging::EventRecord& record)
+                                 { cursorDecoder.Push(record, writeRecord); });
+        }
+        else
+        {
+            batch.ForEachInOrder(writeRecord);
+        }
+        out.write(arena.Data(), arena.Size());
+        arena.Clear();
+        numEvents += batch.order.size();
+    }
+    cursorDecoder.Finish(writeRecord);
+    out.write(arena.Data(), arena.Size());
+
+    if (reader.HasError() || (isCompressed && !decompressor->IsValid()))
+    {
+        std::cerr << "[log2text] Stopped at a truncated or corrupt batch after " << numEvents
+                  << " events.\n";
+        return 2;
+    }
+
+    std::cerr << "[log2text] Converted " << numEvents << " events.\n";
+    return 0;
+}
@@ -0,0 +1,453 @@
+#include <Helpers/MappedFile.hpp>
+#include <Helpers/ThreadPool.hpp>
+#include <Programs/UserStudy/BinaryLog.hpp>
+#include <Programs/UserStudy/LogCompression.hpp>
+#include <Programs/UserStudy/Logging.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Computes per-participant study metrics from participant logs, many logs at a time:
+//   homing.csv        time from each FieldCompletion to the first cursor movement after it
+//   tasks.csv         duration, click and keystroke counts of every completed task
+//   deviceChanges.csv time from each DeviceChanged to the first click with the new device
+// Text logs are memory-mapped and tokenized in place; binary and compressed logs are streamed.
+
+namespace fs = std::filesystem;
+using Logging::EventRecord;
+using Logging::EventType;
+
+constexpr std::string_view UNKNOWN_DEVICE = "<unknown>";
+
+struct HomingTime
+{
+    int task;
+    int fieldIndex;
+    std::string device;
+    uint64_t millis;
+};
+
+struct TaskSummary
+{
+    int task;
+    std::string device;
+    uint64_t durationMillis;
+    uint64_t clicks;
+    uint64_t incorrectClicks;
+    uint64_t keystrokes;
+    uint64_t incorrectKeystrokes;
+};
+
+struct DeviceChange
+{
+    int task;
+    std::string fromDevice;
+    std::string toDevice;
+    uint64_t timestampMillis;
+    std::optional<uint64_t> millisToFirstClick;
+};
+
+struct ParticipantResults
+{
+    std::string participant;
+    uint64_t bytes = 0;
+    uint64_t events = 0;
+    uint64_t malformedLines = 0;
+    std::vector<HomingTime> homingTimes;
+    std::vector<TaskSummary> tasks;
+    std::vector<DeviceChange> deviceChanges;
+    std::string error;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+int PrintUsage();
+std::vector<std::string> FindLogs(const std::vector<std::string>& paths);
+
+ParticipantResults AnalyzeLog(const std::string& filename);
+bool ReadTextLog(std::string_view text, std::vector<EventRecord>& events,
+                 uint64_t& malformedLines);
+bool ReadLogStream(std::istream& stream, std::vector<EventRecord>& events,
+                   uint64_t& malformedLines);
+void ComputeMetrics(std::vector<EventRecord>& events, ParticipantResults& results);
+
+bool WriteCsvFiles(const fs::path& outputDirectory, const std::vector<ParticipantResults>& results);
+std::string CsvField(std::string_view field);
+
+///////////////////////////////////////////////////////////////////////////////
+// Main
+///////////////////////////////////////////////////////////////////////////////
+int main(int argc, char** argv)
+{
+    size_t numThreads = 0;
+    fs::path outputDirectory = ".";
+    std::vector<std::string> paths;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if ((!std::strcmp(argv[i], "--threads") || !std::strcmp(argv[i], "-j")) && i + 1 < argc)
+            numThreads = std::stoul(argv[++i]);
+        else if ((!std::strcmp(argv[i], "--output") || !std::strcmp(argv[i], "-o")) && i + 1 < argc)
+            outputDirectory = argv[++i];
+        else if (!std::strcmp(argv[i], "--help") || !std::strcmp(argv[i], "-h"))
+            return PrintUsage();
+        else
+            paths.push_back(argv[i]);
+    }
+
+    if (paths.empty())
+        paths.push_back("Logs");
+
+    const std::vector<std::string> logs = FindLogs(paths);
+    if (logs.empty())
+    {
+        std::cerr << "[logAnalyzer] No logs found.\n";
+        return 1;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+
+    // every job writes only its own slot, so results need no locking
+    std::vector<ParticipantResults> results(logs.size());
+    {
+        Helpers::ThreadPool pool(numThreads);
+        for (size_t i = 0; i < logs.size(); i++)
+            pool.Submit([&results, &logs, i] { results[i] = AnalyzeLog(logs[i]); });
+        pool.Wait();
+        numThreads = pool.NumThreads();
+    }
+
+    const double seconds =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint64_t totalEvents = 0;
+    uint64_t totalBytes = 0;
+    for (const auto& result : results)
+    {
+        totalEvents += result.events;
+        totalBytes += result.bytes;
+        if (!result.error.empty())
+            std::cerr << "[logAnalyzer] " << result.participant << ": " << result.error << "\n";
+        else if (result.malformedLines > 0)
+            std::cerr << "[logAnalyzer] " << result.participant << ": skipped "
+                      << result.malformedLines << " malformed lines\n";
+    }
+
+    if (!WriteCsvFiles(outputDirectory, results))
+    {
+        std::cerr << "[logAnalyzer] Unable to write results to " << outputDirectory << "\n";
+        return 1;
+    }
+
+    std::cout << "[logAnalyzer] Analyzed " << totalEvents << " events from " << logs.size()
+              << " logs on " << numThreads << " threads in " << seconds << " s ("
+              << static_cast<uint64_t>(totalEvents / std::max(seconds, 1e-9)) << " events/s, "
+              << totalBytes / (1024.0 * 1024.0) / std::max(seconds, 1e-9) << " MB/s).\n";
+    return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+int PrintUsage()
+{
+    std::cout << "Usage: logAnalyzer [--threads N] [--output <directory>] [logs/directories...]\n"
+              << "    Directories are searched for user*.log. Defaults to Logs/.\n"
+              << "    Writes homing.csv, tasks.csv and deviceChanges.csv to the output directory\n"
+              << "    (default: the current directory).\n";
+    return 0;
+}
+
+std::vector<std::string> FindLogs(const std::vector<std::string>& paths)
+{
+    std::vector<std::string> logs;
+    for (const auto& path : paths)
+    {
+        std::error_code error;
+        if (!fs::is_directory(path, error))
+        {
+            logs.push_back(path);
+            continue;
+        }
+
+        for (const auto& entry : fs::directory_iterator(path, error))
+        {
+            const std::string name = entry.path().filename().string();
+            if (entry.is_regular_file() && name.starts_with("user") &&
+                entry.path().extension() == ".log")
+                logs.push_back(entry.path().string());
+        }
+    }
+
+    // a stable order for the CSV files, whatever order the file system lists things in
+    std::sort(logs.begin(), logs.end());
+    return logs;
+}
+
+ParticipantResults AnalyzeLog(const std::string& filename)
+{
+    ParticipantResults results;
+    results.participant = fs::path(filename).stem().string();
+
+    Helpers::MappedFile file;
+    if (!file.Open(filename))
+    {
+        results.error = "unable to open the log";
+        return results;
+    }
+    results.bytes = file.View().size();
+
+    std::vector<EventRecord> events;
+    bool isIntact;
+    if (Logging::IsCompressedLog(file.View()) || Logging::IsBinaryLog(file.View()))
+    {
+        file.Close();
+        std::ifstream stream(filename, std::ios::binary);
+        isIntact = ReadLogStream(stream, events, results.malformedLines);
+    }
+    else
+    {
+        // most lines are cursor positions, about 30 bytes each
+        events.reserve(file.View().size() / 30);
+        isIntact = ReadTextLog(file.View(), events, results.malformedLines);
+    }
+
+    if (!isIntact)
+        results.error = "the log is truncated or corrupt, only the intact part was analyzed";
+
+    results.events = events.size();
+    ComputeMetrics(events, results);
+    return results;
+}
+
+bool ReadTextLog(std::string_view text, std::vector<EventRecord>& events,
+                 uint64_t& malformedLines)
+{
+    EventRecord record;
+    while (!text.empty())
+    {
+        const size_t lineEnd = text.find('\n');
+        const std::string_view line = text.substr(0, lineEnd);
+        text.remove_prefix(lineEnd == std::string_view::npos ? text.size() : lineEnd + 1);
+
+        if (line.empty() || line == "\r")
+            continue;
+
+        if (Logging::ParseRecord(line, record))
+            events.push_back(record);
+        else
+            malformedLines++;
+    }
+    return true;
+}
+
+bool ReadLogStream(std::istream& stream, std::vector<EventRecord>& events,
+                   uint64_t& malformedLines)
+{
+    char magic[Logging::COMPRESSED_LOG_MAGIC.size()] = {};
+    stream.read(magic, sizeof(magic));
+    stream.clear();
+    stream.seekg(0);
+
+    if (!Logging::IsCompressedLog(std::string_view(magic, sizeof(magic))))
+    {
+        Logging::BinaryLogReader reader(stream);
+        if (!reader.ReadHeader())
+            return false;
+
+        Logging::DecodedBatch batch;
+        while (reader.NextBatch(batch))
+            batch.ForEachInOrder([&events](const EventRecord& r) { events.push_back(r); });
+        return !reader.HasError();
+    }
+
+    // every block is one writer flush, so blocks always end on an event boundary
+    Logging::CompressedLogReader reader(stream);
+    if (!reader.ReadHeader())
+        return false;
+
+    std::string_view block;
+    if (!reader.NextBlock(block))
+        return !reader.HasError();
+
+    if (!Logging::IsBinaryLog(block))
+    {
+        do
+            ReadTextLog(block, events, malformedLines);
+        while (reader.NextBlock(block));
+        return !reader.HasError();
+    }
+
+    // a compressed binary log: feed the decompressed bytes back into the binary reader
+    stream.clear();
+    stream.seekg(0);
+    Logging::DecompressingStreamBuf decompressor(stream);
+    std::istream decompressed(&decompressor);
+    Logging::BinaryLogReader binaryReader(decompressed);
+    if (!binaryReader.ReadHeader())
+        return false;
+
+    Logging::DecodedBatch batch;
+    while (binaryReader.NextBatch(batch))
+        batch.ForEachInOrder([&events](const EventRecord& r) { events.push_back(r); });
+    return !binaryReader.HasError() && decompressor.IsValid();
+}
+
+void ComputeMetrics(std::vector<EventRecord>& events, ParticipantResults& results)
+{
+    // The logger writes events in timestamp order. Only older logs, and events that reached
+    // the logger after its reorder window, need a sort.
+    auto byTimestamp = [](const EventRecord& a, const EventRecord& b)
+    { return a.timestampMillis < b.timestampMillis; };
+    if (!std::is_sorted(events.begin(), events.end(), byTimestamp))
+        std::stable_sort(events.begin(), events.end(), byTimestamp);
+
+    if (events.empty())
+        return;
+
+    int currentTask = 0;
+    std::string device(UNKNOWN_DEVICE);
+    TaskSummary task{0, device, 0, 0, 0, 0, 0};
+    uint64_t taskStart = events.front().timestampMillis;
+
+    // events doesn't change size from here on, so these can point into it
+    const EventRecord* lastFieldCompletion = nullptr;
+    const EventRecord* lastCursor = nullptr;
+    std::optional<size_t> pendingDeviceChange;
+
+    for (const EventRecord& event : events)
+    {
+        switch (event.type)
+        {
+            case EventType::CursorPosition:
+            {
+                const bool hasMoved = lastCursor && (event.valueA != lastCursor->valueA ||
+                                                     event.valueB != lastCursor->valueB);
+                if (hasMoved && lastFieldCompletion)
+                {
+                    results.homingTimes.push_back(
+                        {currentTask, lastFieldCompletion->valueA, device,
+                         event.timestampMillis - lastFieldCompletion->timestampMillis});
+                    lastFieldCompletion = nullptr;
+                }
+                lastCursor = &event;
+                break;
+            }
+            case EventType::CursorHold:
+                // the cursor stayed at lastCursor, which doesn't end a homing time
+                break;
+            case EventType::Click:
+                task.clicks++;
+                task.incorrectClicks += !event.flag;
+                if (pendingDeviceChange)
+                {
+                    DeviceChange& change = results.deviceChanges[*pendingDeviceChange];
+                    change.millisToFirstClick = event.timestampMillis - change.timestampMillis;
+                    pendingDeviceChange.reset();
+                }
+                break;
+            case EventType::Keystroke:
+                task.keystrokes++;
+                task.incorrectKeystrokes += !event.flag;
+                break;
+            case EventType::FieldCompletion:
+                lastFieldCompletion = &event;
+                break;
+            case EventType::TaskCompletion:
+                task.task = currentTask;
+                task.device = device;
+                task.durationMillis = event.timestampMillis - taskStart;
+                results.tasks.push_back(task);
+
+                currentTask++;
+                task = TaskSummary{currentTask, device, 0, 0, 0, 0, 0};
+                taskStart = event.timestampMillis;
+                lastFieldCompletion = nullptr;
+                break;
+            case EventType::DeviceChanged:
+            {
+                std::string newDevice(event.text.data(), event.textLength);
+                results.deviceChanges.push_back(
+                    {currentTask, device, newDevice, event.timestampMillis, std::nullopt});
+                pendingDeviceChange = results.deviceChanges.size() - 1;
+                device = std::move(newDevice);
+                break;
+            }
+            case EventType::DriverMove:
+            case EventType::DriverClick:
+            case EventType::DriverPose:
+            case EventType::DriverAccumulator:
+                // what the gesture driver fed the OS; the metrics go by what the browser saw
+                break;
+        }
+    }
+    // events after the last TaskCompletion belong to a task that was never finished
+}
+
+bool WriteCsvFiles(const fs::path& outputDirectory, const std::vector<ParticipantResults>& results)
+{
+    std::error_code error;
+    fs::create_directories(outputDirectory, error);
+
+    std::ofstream homing(outputDirectory / "homing.csv");
+    std::ofstream tasks(outputDirectory / "tasks.csv");
+    std::ofstream deviceChanges(outputDirectory / "deviceChanges.csv");
+    if (!homing || !tasks || !deviceChanges)
+        return false;
+
+    homing << "participant,task,device,fieldIndex,homingMillis\n";
+    tasks << "participant,task,device,durationMillis,clicks,incorrectClicks,keystrokes,"
+             "incorrectKeystrokes\n";
+    deviceChanges << "participant,task,fromDevice,toDevice,timestampMillis,millisToFirstClick\n";
+
+    for (const auto& result : results)
+    {
+        const std::string participant = CsvField(result.participant);
+
+        for (const auto& time : result.homingTimes)
+            homing << participant << ',' << time.task << ',' << CsvField(time.device) << ','
+                   << time.fieldIndex << ',' << time.millis << '\n';
+
+        for (const auto& task : result.tasks)
+            tasks << participant << ',' << task.task << ',' << CsvField(task.device) << ','
+                  << task.durationMillis << ',' << task.clicks << ',' << task.incorrectClicks
+                  << ',' << task.keystrokes << ',' << task.incorrectKeystrokes << '\n';
+
+        for (const auto& change : result.deviceChanges)
+        {
+            deviceChanges << participant << ',' << change.task << ','
+                          << CsvField(change.fromDevice) << ',' << CsvField(change.toDevice)
+                          << ',' << change.timestampMillis << ',';
+            if (change.millisToFirstClick)
+                deviceChanges << *change.millisToFirstClick;
+            deviceChanges << '\n';
+        }
+    }
+
+    return static_cast<bool>(homing && tasks && deviceChanges);
+}
+
+std::string CsvField(std::string_view field)
+{
+    if (field.find_first_of(",\"\r\n") == std::string_view::npos)
+        return std::string(field);
+
+    std::string quoted = "\"";
+    for (char c : field)
+    {
+        if (c == '"')
+            quoted += '"';
+        quoted += c;
+    }
+    quoted += '"';
+    return quoted;
+}
@@ -0,0 +1,370 @@
+#include "BinaryLog.hpp"
+
+#include <Helpers/Varint.hpp>
+#include <algorithm>
+#include <cstring>
+
+namespace Logging
+{
+
+using Helpers::AppendSignedVarint;
+using Helpers::AppendVarint;
+using Helpers::ByteReader;
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+void AppendU32(LogArena& out, uint32_t value);
+void PatchU32(LogArena& out, size_t offset, uint32_t value);
+uint32_t ReadU32(const char* data);
+
+void EncodeColumns(LogArena& out, EventType type, const std::vector<EventRecord>& records);
+bool DecodeColumns(ByteReader& reader, EventType type, uint64_t maxCount,
+                   std::vector<EventRecord>& records);
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+void AppendBinaryLogHeader(LogArena& out)
+{
+    out.append(BINARY_LOG_MAGIC.data(), BINARY_LOG_MAGIC.size());
+    AppendU32(out, BINARY_LOG_VERSION);
+}
+
+bool IsBinaryLog(std::string_view data)
+{
+    return data.size() >= BINARY_LOG_MAGIC.size() &&
+           std::equal(BINARY_LOG_MAGIC.begin(), BINARY_LOG_MAGIC.end(), data.begin());
+}
+
+void BinaryBatchEncoder::Append(const EventRecord& record)
+{
+    order.push_back(record.type);
+    columns[static_cast<size_t>(record.type)].push_back(record);
+}
+
+void BinaryBatchEncoder::EncodeAndClear(LogArena& out)
+{
+    if (order.empty())
+        return;
+
+    // the payload is encoded in place, the length prefix is filled in at the end
+    const size_t lengthOffset = out.Size();
+    AppendU32(out, 0);
+    const size_t payloadOffset = out.Size();
+
+    AppendVarint(out, order.size());
+
+    // type order column, run-length encoded since events of one type tend to come in bursts
+    runs.clear();
+    for (EventType type : order)
+    {
+        if (!runs.empty() && runs.back().first == type)
+            runs.back().second++;
+        else
+            runs.emplace_back(type, 1);
+    }
+    AppendVarint(out, runs.size());
+    for (const auto& [type, length] : runs)
+    {
+        out += static_cast<char>(type);
+        AppendVarint(out, length);
+    }
+
+    for (size_t typeIndex = 0; typeIndex < NUM_EVENT_TYPES; typeIndex++)
+    {
+        const auto& records = columns[typeIndex];
+        if (records.empty())
+            continue;
+
+        out += static_cast<char>(typeIndex);
+        AppendVarint(out, records.size());
+        EncodeColumns(out, static_cast<EventType>(typeIndex), records);
+    }
+
+    PatchU32(out, lengthOffset, static_cast<uint32_t>(out.Size() - payloadOffset));
+
+    order.clear();
+    for (auto& column : columns)
+        column.clear();
+}
+
+BinaryLogReader::BinaryLogReader(std::istream& stream, uint32_t maxVersion)
+    : stream(stream), version(0), maxVersion(maxVersion), hasError(false)
+{
+}
+
+bool BinaryLogReader::ReadHeader()
+{
+    char header[BINARY_LOG_HEADER_SIZE];
+    if (!stream.read(header, sizeof(header)) ||
+        !IsBinaryLog(std::string_view(header, sizeof(header))))
+    {
+        hasError = true;
+        return false;
+    }
+
+    version = ReadU32(header + BINARY_LOG_MAGIC.size());
+    // event types are only ever appended, so older logs decode unchanged
+    if (version == 0 || version > maxVersion)
+    {
+        hasError = true;
+        return false;
+    }
+    return true;
+}
+
+bool BinaryLogReader::NextBatch(DecodedBatch& batch)
+{
+    batch.order.clear();
+    for (auto& column : batch.columns)
+        column.clear();
+
+    char lengthBytes[4];
+    stream.read(lengthBytes, sizeof(lengthBytes));
+    if (stream.gcount() == 0)
+        return false;  // clean end of file
+    if (stream.gcount() != sizeof(lengthBytes))
+    {
+        hasError = true;
+        return false;
+    }
+
+    const uint32_t payloadSize = ReadU32(lengthBytes);
+    if (payloadSize > MAX_BATCH_PAYLOAD_SIZE)
+    {
+        hasError = true;
+        return false;
+    }
+
+    payload.resize(payloadSize);
+    if (!stream.read(payload.data(), payload.size()))
+    {
+        hasError = true;
+        return false;
+    }
+
+    ByteReader reader(payload);
+    const uint64_t eventCount = reader.ReadVarint();
+
+    const uint64_t runCount = reader.ReadVarint();
+    for (uint64_t i = 0; i < runCount && !reader.HasError(); i++)
+    {
+        const uint8_t type = reader.ReadByte();
+        const uint64_t length = reader.ReadVarint();
+        if (type >= NUM_EVENT_TYPES || batch.order.size() + length > eventCount)
+        {
+            hasError = true;
+            return false;
+        }
+        batch.order.insert(batch.order.end(), length, static_cast<EventType>(type));
+    }
+
+    while (!reader.HasError() && !reader.IsAtEnd())
+    {
+        const uint8_t type = reader.ReadByte();
+        if (type >= NUM_EVENT_TYPES ||
+            !DecodeColumns(reader, static_cast<EventType>(type), eventCount, batch.columns[type]))
+        {
+            hasError = true;
+            return false;
+        }
+    }
+
+    // every entry in the order column must have a record to point at
+    std::array<size_t, NUM_EVENT_TYPES> expected{};
+    for (EventType type : batch.order)
+        expected[static_cast<size_t>(type)]++;
+    for (size_t i = 0; i < NUM_EVENT_TYPES; i++)
+    {
+        if (expected[i] != batch.columns[i].size())
+            hasError = true;
+    }
+
+    if (reader.HasError() || batch.order.size() != eventCount)
+        hasError = true;
+
+    return !hasError;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+void AppendU32(LogArena& out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+void PatchU32(LogArena& out, size_t offset, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out.Data()[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+uint32_t ReadU32(const char* data)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    return value;
+}
+
+template <RecordSlot Slot>
+void AppendDeltaColumn(LogArena& out, const std::vector<EventRecord>& records)
+{
+    int64_t previous = 0;
+    for (const auto& record : records)
+    {
+        const int64_t value = LoadSlot<Slot, int64_t>(record);
+        AppendSignedVarint(out, value - previous);
+        previous = value;
+    }
+}
+
+void AppendBitColumn(LogArena& out, const std::vector<EventRecord>& records)
+{
+    for (size_t i = 0; i < records.size(); i += 8)
+    {
+        uint8_t packed = 0;
+        for (size_t bit = 0; bit < 8 && i + bit < records.size(); bit++)
+            packed |= static_cast<uint8_t>(records[i + bit].flag) << bit;
+        out += static_cast<char>(packed);
+    }
+}
+
+void AppendStringColumn(LogArena& out, const std::vector<EventRecord>& records)
+{
+    for (const auto& record : records)
+        AppendVarint(out, record.textLength);
+    for (const auto& record : records)
+        out.append(record.text.data(), record.textLength);
+}
+
+template <Loggable T>
+void EncodeEventColumns(LogArena& out, const std::vector<EventRecord>& records)
+{
+    ForEachField<T>(
+        [&](const auto& field)
+        {
+            using F = FieldOf<decltype(field)>;
+            if constexpr (F::COLUMN == ColumnEncoding::Delta)
+            {
+                AppendDeltaColumn<F::SLOT>(out, records);
+            }
+            else if constexpr (F::COLUMN == ColumnEncoding::Varint)
+            {
+                for (const auto& record : records)
+                    AppendSignedVarint(out, LoadSlot<F::SLOT, int64_t>(record));
+            }
+            else if constexpr (F::COLUMN == ColumnEncoding::Byte)
+            {
+                for (const auto& record : records)
+                    out += static_cast<char>(LoadSlot<F::SLOT, int32_t>(record));
+            }
+            else if constexpr (F::COLUMN == ColumnEncoding::Bits)
+            {
+                AppendBitColumn(out, records);
+            }
+            else
+            {
+                AppendStringColumn(out, records);
+            }
+        });
+}
+
+void EncodeColumns(LogArena& out, EventType type, const std::vector<EventRecord>& records)
+{
+    VisitEventType(type,
+                   [&](auto event)
+                   {
+                       using T = typename decltype(event)::type;
+                       EncodeEventColumns<T>(out, records);
+                   });
+}
+
+template <RecordSlot Slot>
+void ReadDeltaColumn(ByteReader& reader, std::vector<EventRecord>& records)
+{
+    int64_t previous = 0;
+    for (auto& record : records)
+    {
+        previous += reader.ReadSignedVarint();
+        StoreSlot<Slot>(record, previous);
+    }
+}
+
+void ReadBitColumn(ByteReader& reader, std::vector<EventRecord>& records)
+{
+    for (size_t i = 0; i < records.size(); i += 8)
+    {
+        const uint8_t packed = reader.ReadByte();
+        for (size_t bit = 0; bit < 8 && i + bit < records.size(); bit++)
+            records[i + bit].flag = (packed >> bit) & 1;
+    }
+}
+
+void ReadStringColumn(ByteReader& reader, std::vector<EventRecord>& records)
+{
+    std::vector<uint64_t> lengths(records.size());
+    for (auto& length : lengths)
+        length = reader.ReadVarint();
+
+    // the encoder never writes more than a record can hold, but CopyRecordText doesn't trust it
+    for (size_t i = 0; i < records.size(); i++)
+        CopyRecordText(records[i], reader.ReadBytes(lengths[i]));
+}
+
+template <Loggable T>
+void DecodeEventColumns(ByteReader& reader, std::vector<EventRecord>& records)
+{
+    ForEachField<T>(
+        [&](const auto& field)
+        {
+            using F = FieldOf<decltype(field)>;
+            if constexpr (F::COLUMN == ColumnEncoding::Delta)
+            {
+                ReadDeltaColumn<F::SLOT>(reader, records);
+            }
+            else if constexpr (F::COLUMN == ColumnEncoding::Varint)
+            {
+                for (auto& record : records)
+                    StoreSlot<F::SLOT>(record, reader.ReadSignedVarint());
+            }
+            else if constexpr (F::COLUMN == ColumnEncoding::Byte)
+            {
+                for (auto& record : records)
+                    StoreSlot<F::SLOT>(record, reader.ReadByte());
+            }
+            else if constexpr (F::COLUMN == ColumnEncoding::Bits)
+            {
+                ReadBitColumn(reader, records);
+            }
+            else
+            {
+                ReadStringColumn(reader, records);
+            }
+        });
+}
+
+bool DecodeColumns(ByteReader& reader, EventType type, uint64_t maxCount,
+                   std::vector<EventRecord>& records)
+{
+    const uint64_t count = reader.ReadVarint();
+    if (reader.HasError() || count > maxCount || !records.empty())
+        return false;  // each type gets exactly one block per batch
+
+    EventRecord blank{};
+    blank.type = type;
+    records.assign(count, blank);
+
+    const bool isKnownType = VisitEventType(type,
+                                            [&](auto event)
+                                            {
+                                                using T = typename decltype(event)::type;
+                                                DecodeEventColumns<T>(reader, records);
+                                            });
+    return isKnownType && !reader.HasError();
+}
+
+}  // namespace Logging
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LogArena.hpp"
+#include "Logging.hpp"
+
+namespace Logging
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Binary log format
+///////////////////////////////////////////////////////////////////////////////
+//
+// File:  magic "HGLB" | u32 version (little endian) | batch...
+// Batch: u32 payload length (little endian) | payload
+//
+// Payload (one per writer flush):
+//   varint event count
+//   type order column: varint run count, then (u8 event type, varint run length) per run
+//   one block per event type present, in EventType order:
+//     u8 event type | varint event count | columns...
+//
+// Columns per block: one per field of the event type, in the order its EventSchema lists them
+// (see EventSchema.hpp), each holding one value per event of that type. By ColumnEncoding:
+//   Delta:  zigzag varint delta from the previous event of the type (timestamps, cursor positions)
+//   Varint: zigzag varint (field and task indices)
+//   Byte:   u8 enum code (click locations)
+//   Bits:   packed bits, least significant bit first (wasCorrect)
+//   String: string column (keys, device names)
+// String columns are every length as a varint followed by every string's bytes.
+// Deltas restart at zero at the start of every batch so batches decode independently.
+//
+// The type order column is what lets a reader interleave the blocks back into
+// the exact order the events were logged in.
+//
+// Versions: 1 is the original set of events, 2 added CursorHold, 3 added DriverMove,
+// DriverClick, DriverPose and DriverAccumulator.
+// Readers accept every version up to their own.
+
+constexpr std::array<char, 4> BINARY_LOG_MAGIC = {'H', 'G', 'L', 'B'};
+constexpr uint32_t BINARY_LOG_VERSION = 3;
+constexpr size_t BINARY_LOG_HEADER_SIZE = 8;
+
+/// @brief Sanity limit for readers. A writer flush is nowhere near this big.
+constexpr uint32_t MAX_BATCH_PAYLOAD_SIZE = 64 * 1024 * 1024;
+
+/// @brief Appends the file header that starts every binary log.
+void AppendBinaryLogHeader(LogArena& out);
+
+/// @brief Does this data start with a binary log header?
+bool IsBinaryLog(std::string_view data);
+
+/// @brief Collects the records for one flush and encodes them as a single batch.
+class BinaryBatchEncoder
+{
+   public:
+    void Append(const EventRecord& record);
+
+    /// @brief Appends the encoded batch (length prefix included) to out and clears the encoder.
+    void EncodeAndClear(LogArena& out);
+
+    size_t EventCount() const { return order.size(); }
+
+   private:
+    std::vector<EventType> order;
+    std::array<std::vector<EventRecord>, NUM_EVENT_TYPES> columns;
+    std::vector<std::pair<EventType, uint64_t>> runs;  // kept around to reuse its capacity
+};
+
+/// @brief One decoded batch. The per-type columns can be used directly,
+///        or walked in logging order with ForEachInOrder.
+struct DecodedBatch
+{
+    std::vector<EventType> order;
+    std::array<std::vector<EventRecord>, NUM_EVENT_TYPES> columns;
+
+    template <typename Fn>
+    void ForEachInOrder(Fn&& fn) const;
+};
+
+/// @brief Streams a binary log one batch at a time, so whole files never have to fit in memory.
+class BinaryLogReader
+{
+   public:
+    /// @param maxVersion The newest version to accept. Only tests should need an older one, to
+    ///                   stand in for a reader from an older build.
+    BinaryLogReader(std::istream& stream, uint32_t maxVersion = BINARY_LOG_VERSION);
+
+    /// @brief Reads and validates the file header. Must be called before NextBatch.
+    bool ReadHeader();
+
+    /// @brief Decodes the next batch.
+    /// @return false at the end of the stream, or if the batch was truncated or malformed
+    ///         (check HasError() to tell the two apart).
+    bool NextBatch(DecodedBatch& batch);
+
+    bool HasError() const { return hasError; }
+    uint32_t Version() const { return version; }
+
+   private:
+    std::istream& stream;
+    std::string payload;
+    uint32_t version;
+    uint32_t maxVersion;
+    bool hasError;
+};
+
+template <typename Fn>
+void DecodedBatch::ForEachInOrder(Fn&& fn) const
+{
+    std::array<size_t, NUM_EVENT_TYPES> cursors{};
+    for (EventType type : order)
+    {
+        const size_t typeIndex = static_cast<size_t>(type);
+        fn(columns[typeIndex][cursors[typeIndex]++]);
+    }
+}
+
+}  // namespace Logging
@@ -1,52 +1,71 @@
 #include "CursorLogger.hpp"
 
+#include <Helpers/Clock.hpp>
+#include <Helpers/FixedRateScheduler.hpp>
 #include <Input/SimulatedMouse.hpp>
+#include <algorithm>
 #include <chrono>
 #include <cstdint>
-#include <ctime>
-#include <condition_variable>
+#include <format>
 #include <iostream>
-#include <mutex>
-#include <thread>
 
+#include "CursorStream.hpp"
 #include "Logging.hpp"
 
 namespace Logging
 {
 
-void CursorLoggerLoop(SyncState& syncState)
+void CursorLoggerLoop(SyncState& syncState, uint32_t sampleRateHz)
 {
     std::cout << "[main] Starting cursor position logging thread...\n";
 
-    using Clock = std::chrono::high_resolution_clock;
-    using Time = std::chrono::high_resolution_clock::time_point;
-    using Nanos = std::chrono::nanoseconds;
-    using Millis = std::chrono::milliseconds;
+    sampleRateHz = std::clamp(sampleRateHz, MIN_CURSOR_RATE_HZ, MAX_CURSOR_RATE_HZ);
+    Helpers::FixedRateScheduler scheduler(sampleRateHz);
+    bool isScheduled = false;
 
-    constexpr Nanos loopTime = Nanos(33'333'333);  // 33.33ms aka 30Hz
+    CursorStreamEncoder encoder(sampleRateHz);
+    auto log = [&syncState](const auto& event) { syncState.logger.Log(event); };
 
-    while (syncState.isRunning.load())
+    while (true)
     {
-        // TODO: don't spinlock lol
-        while (!syncState.isLogging.load())
-            ;
+        if (!syncState.isLogging.load())
+        {
+            encoder.Flush(log);
+            encoder.Restart();
+            syncState.WaitForState(
+                [&syncState]
+                { return syncState.isLogging.load() || !syncState.isRunning.load(); });
+            isScheduled = false;
+        }
+        if (!syncState.isRunning.load())
+            break;
 
-        Time loopStart = Clock::now();
-        uint64_t timestamp = GetCurrentUnixTimeMillis();
+        // the first sample is taken as soon as logging starts
+        if (!isScheduled)
+        {
+            scheduler.Restart();
+            isScheduled = true;
+        }
 
+        const uint64_t numMissedBefore = scheduler.GetStats().numMissedTicks;
+        const auto sampleTime = scheduler.WaitForNextTick();
+        // a hold only describes evenly spaced samples, so skipped ticks end it
+        if (scheduler.GetStats().numMissedTicks != numMissedBefore)
+            encoder.Flush(log);
         auto posResult = Input::Mouse::QueryMousePosition();
-        Logging::Events::CursorPosition pos{};
-        pos.timestampMillis = timestamp;
-        pos.positionX = posResult.first;
-        pos.positionY = posResult.second;
-        syncState.logger.Log(pos);
-
-        Time loopEnd = Clock::now();
-        Nanos processingTime = loopEnd - loopStart;
-        if (processingTime.count() > 0)
-            std::this_thread::sleep_for(loopTime - processingTime);
+        encoder.AddSample(Helpers::Clock::ToUnixMillis(sampleTime), posResult.first,
+                          posResult.second, log);
     }
+    encoder.Flush(log);
 
+    const Helpers::FixedRateScheduler::Stats& stats = scheduler.GetStats();
+    std::cout << std::format(
+        "[main] Cursor samples: {} at {}Hz, scheduling jitter mean {}us, max {}us, "
+        "{} late, {} skipped\n",
+        stats.numTicks, sampleRateHz,
+        stats.numTicks > 0 ? stats.totalJitterNanos / static_cast<int64_t>(stats.numTicks) / 1000
+                           : 0,
+        stats.maxJitterNanos / 1000, stats.numLateTicks, stats.numMissedTicks);
     std::cout << "[main] Shutting down cursor position logging thread...\n";
 }
 
@@ -1,10 +1,21 @@
 #pragma once
 
+#include <cstdint>
+
 #include "SyncState.hpp"
 
 namespace Logging
 {
 
-void CursorLoggerLoop(SyncState& syncState);
+/// @brief Rates the cursor position can be sampled at.
+constexpr uint32_t MIN_CURSOR_RATE_HZ = 30;
+constexpr uint32_t MAX_CURSOR_RATE_HZ = 1000;
+constexpr uint32_t DEFAULT_CURSOR_RATE_HZ = 30;
+
+/// @brief Samples the cursor position sampleRateHz times a second while syncState.isLogging is set
+///        and logs the samples as a cursor stream (see CursorStream.hpp).
+///        Parks on the sync state (no CPU use) until logging starts, and returns once
+///        syncState.isRunning is cleared.
+void CursorLoggerLoop(SyncState& syncState, uint32_t sampleRateHz);
 
 }
\ No newline at end of file
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "EventSchema.hpp"
+
+namespace Logging
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Cursor stream encoding
+///////////////////////////////////////////////////////////////////////////////
+//
+// The cursor is sampled at a fixed rate, but while the participant types it sits still and
+// almost every sample repeats the one before. So only changes are logged:
+//   - a sample where the cursor moved is logged as a CursorPosition,
+//   - a run of samples where it didn't is logged as one CursorHold once the run ends, stamped
+//     with the time of its last sample and carrying how many samples it covers and how far
+//     apart they were.
+// Positions stay absolute so every CursorPosition can be read on its own. Binary logs already
+// store them as deltas from the previous one, so they cost a few bits there either way.
+//
+// Runs are cut at MAX_CURSOR_HOLD_SPAN. That bounds how many samples a crash can lose and how
+// long a reader has to hold on to the events logged during a run to interleave them with it.
+
+constexpr std::chrono::milliseconds MAX_CURSOR_HOLD_SPAN{5000};
+
+/// @brief Turns fixed-rate cursor samples into the events that get logged.
+///        Events are handed to a sink, any callable taking a const Events::CursorPosition&
+///        and a const Events::CursorHold& (a generic lambda around Logger::Log, usually).
+class CursorStreamEncoder
+{
+   public:
+    explicit CursorStreamEncoder(uint32_t sampleRateHz);
+
+    /// @brief Logs a sample, or adds it to the current hold if the cursor didn't move.
+    template <typename Sink>
+    void AddSample(uint64_t timestampMillis, int positionX, int positionY, Sink&& sink);
+
+    /// @brief Logs the current hold, if there is one. Call whenever the next sample won't be
+    ///        one interval after the last one, and before the log is closed.
+    template <typename Sink>
+    void Flush(Sink&& sink);
+
+    /// @brief Forgets the last position, so the next sample is logged as a CursorPosition
+    ///        whether it moved or not. For after a gap in sampling; Flush first.
+    void Restart() { hasPosition = false; }
+
+   private:
+    const int intervalMicros;
+    const int maxHoldSamples;
+
+    bool hasPosition;
+    int lastX;
+    int lastY;
+
+    uint64_t holdEndMillis;
+    int holdSamples;
+};
+
+/// @brief Expands a logged cursor stream back into fixed-rate samples.
+///        Records are pushed in log order. Every CursorHold comes out as sampleCount
+///        CursorPosition records at the last logged position, interleaved by timestamp with the
+///        records logged during the hold; everything else comes out unchanged.
+///        Expanded sample times count back from the hold's last sample in whole intervals,
+///        so they can differ from when the samples were actually taken by about a millisecond.
+class CursorStreamDecoder
+{
+   public:
+    /// @param sink Called with every record of the expanded stream, as a const EventRecord&.
+    template <typename Sink>
+    void Push(const EventRecord& record, Sink&& sink);
+
+    /// @brief Passes on the records still waiting for a hold. Call at the end of the log.
+    template <typename Sink>
+    void Finish(Sink&& sink);
+
+   private:
+    bool hasPosition = false;
+    int lastX = 0;
+    int lastY = 0;
+    uint64_t lastCursorMillis = 0;  // when the last CursorPosition or CursorHold ended
+
+    // records logged since then, which a hold logged later may have to be interleaved with
+    std::vector<EventRecord> waiting;
+
+    template <typename Sink>
+    void ExpandHold(const EventRecord& hold, Sink&& sink);
+
+    template <typename Sink>
+    void ReleaseWaiting(Sink&& sink);
+};
+
+inline CursorStreamEncoder::CursorStreamEncoder(uint32_t sampleRateHz)
+    : intervalMicros(static_cast<int>(1'000'000 / std::max<uint32_t>(sampleRateHz, 1))),
+      maxHoldSamples(std::max<int>(
+          static_cast<int>(MAX_CURSOR_HOLD_SPAN.count() * 1000 / intervalMicros), 1)),
+      hasPosition(false),
+      lastX(0),
+      lastY(0),
+      holdEndMillis(0),
+      holdSamples(0)
+{
+}
+
+template <typename Sink>
+void CursorStreamEncoder::AddSample(uint64_t timestampMillis, int positionX, int positionY,
+                                    Sink&& sink)
+{
+    if (hasPosition && positionX == lastX && positionY == lastY)
+    {
+        holdEndMillis = timestampMillis;
+        if (++holdSamples == maxHoldSamples)
+            Flush(sink);
+        return;
+    }
+
+    Flush(sink);
+    sink(Events::CursorPosition{
+        .timestampMillis = timestampMillis, .positionX = positionX, .positionY = positionY});
+    hasPosition = true;
+    lastX = positionX;
+    lastY = positionY;
+}
+
+template <typename Sink>
+void CursorStreamEncoder::Flush(Sink&& sink)
+{
+    if (holdSamples == 0)
+        return;
+
+    sink(Events::CursorHold{.timestampMillis = holdEndMillis,
+                            .sampleCount = holdSamples,
+                            .intervalMicros = intervalMicros});
+    holdSamples = 0;
+}
+
+template <typename Sink>
+void CursorStreamDecoder::Push(const EventRecord& record, Sink&& sink)
+{
+    switch (record.type)
+    {
+        case EventType::CursorHold:
+            ExpandHold(record, sink);
+            lastCursorMillis = record.timestampMillis;
+            break;
+        case EventType::CursorPosition:
+            ReleaseWaiting(sink);
+            sink(record);
+            hasPosition = true;
+            lastX = record.valueA;
+            lastY = record.valueB;
+            lastCursorMillis = record.timestampMillis;
+            break;
+        default:
+            // a hold ends at most MAX_CURSOR_HOLD_SPAN after the last cursor event,
+            // so anything later than that can't be part of one
+            if (!hasPosition ||
+                record.timestampMillis >
+                    lastCursorMillis + static_cast<uint64_t>(MAX_CURSOR_HOLD_SPAN.count()))
+            {
+                ReleaseWaiting(sink);
+                sink(record);
+            }
+            else
+            {
+                waiting.push_back(record);
+            }
+            break;
+    }
+}
+
+template <typename Sink>
+void CursorStreamDecoder::Finish(Sink&& sink)
+{
+    ReleaseWaiting(sink);
+}
+
+template <typename Sink>
+void CursorStreamDecoder::ExpandHold(const EventRecord& hold, Sink&& sink)
+{
+    const int64_t count = hold.valueA;
+    const int64_t intervalMicros = hold.valueB;
+    // a hold with nothing logged before it (a truncated log) has no position to repeat
+    if (!hasPosition || count <= 0 || intervalMicros <= 0)
+    {
+        ReleaseWaiting(sink);
+        return;
+    }
+
+    const int64_t endMicros = static_cast<int64_t>(hold.timestampMillis) * 1000;
+    auto next = waiting.begin();
+    for (int64_t i = count - 1; i >= 0; i--)
+    {
+        const uint64_t sampleMillis = static_cast<uint64_t>(endMicros - i * intervalMicros) / 1000;
+        for (; next != waiting.end() && next->timestampMillis < sampleMillis; ++next)
+            sink(*next);
+        sink(ToRecord(Events::CursorPosition{
+            .timestampMillis = sampleMillis, .positionX = lastX, .positionY = lastY}));
+    }
+    for (; next != waiting.end(); ++next)
+        sink(*next);
+    waiting.clear();
+}
+
+template <typename Sink>
+void CursorStreamDecoder::ReleaseWaiting(Sink&& sink)
+{
+    for (const EventRecord& record : waiting)
+        sink(record);
+    waiting.clear();
+}
+
+}  // namespace Logging
@@ -0,0 +1,612 @@
+#pragma once
+
+#include <Helpers/IsAnyOf.hpp>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace Logging
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Event structures
+///////////////////////////////////////////////////////////////////////////////
+namespace Events
+{
+
+enum class ClickLocation
+{
+    OutOfBounds,  // TODO: this might not be necessary, and is for sure impossible to catch in JS
+    Background,
+    TextField,
+    Button
+};
+
+/// @brief What the gesture driver classified the tracked hand as.
+enum class HandPose
+{
+    NoHand,
+    Move,
+    Click
+};
+
+struct Click
+{
+    uint64_t timestampMillis;
+    ClickLocation location;
+    bool wasCorrect;
+};
+
+struct CursorPosition
+{
+    uint64_t timestampMillis;
+    int positionX;
+    int positionY;
+};
+
+struct Keystroke
+{
+    uint64_t timestampMillis;
+    std::string key;
+    bool wasCorrect;
+};
+
+struct FieldCompletion
+{
+    uint64_t timestampMillis;
+    int fieldIndex;
+};
+
+struct TaskCompletion
+{
+    uint64_t timestampMillis;
+    int taskIndex;
+};
+
+struct DeviceChanged
+{
+    uint64_t timestampMillis;
+    std::string newDevice;
+};
+
+/// @brief sampleCount cursor samples, intervalMicros apart and the last one at timestampMillis,
+///        that all repeated the last logged CursorPosition. See CursorStream.hpp.
+struct CursorHold
+{
+    uint64_t timestampMillis;
+    int sampleCount;
+    int intervalMicros;
+};
+
+// Logged by the gesture driver on every frame it does something (see LeapDriver.cpp).
+// These record what it fed the OS, which cursor sampling can only approximate.
+
+struct DriverMove
+{
+    uint64_t timestampMillis;
+    int dx;
+    int dy;
+};
+
+struct DriverClick
+{
+    uint64_t timestampMillis;
+};
+
+struct DriverPose
+{
+    uint64_t timestampMillis;
+    HandPose pose;
+};
+
+struct DriverAccumulator
+{
+    uint64_t timestampMillis;
+    int accumulatorX;
+    int accumulatorY;
+};
+
+}  // namespace Events
+
+///////////////////////////////////////////////////////////////////////////////
+// Fixed-size event records
+///////////////////////////////////////////////////////////////////////////////
+
+/// @brief Longest string payload (Keystroke::key, DeviceChanged::newDevice) an EventRecord holds.
+///        Longer strings are truncated when the record is built.
+constexpr size_t MAX_RECORD_TEXT_LENGTH = 39;
+
+/// @brief Stable numeric code of every event type. Binary logs store these, so only append.
+enum class EventType : uint8_t
+{
+    Click,
+    CursorPosition,
+    Keystroke,
+    FieldCompletion,
+    TaskCompletion,
+    DeviceChanged,
+    CursorHold,
+    DriverMove,
+    DriverClick,
+    DriverPose,
+    DriverAccumulator
+};
+
+/// @brief Trivially copyable form of any Loggable event.
+///        This is what actually travels through the logger's queue,
+///        so producers never allocate when logging.
+struct EventRecord
+{
+    EventType type;
+    bool flag;           // Click::wasCorrect, Keystroke::wasCorrect
+    uint8_t textLength;  // length of the string payload in text
+    int32_t valueA;      // Click::location, CursorPosition::positionX, *Completion::*Index,
+                         // CursorHold::sampleCount, DriverPose::pose, Driver*::*X
+    int32_t valueB;      // CursorPosition::positionY, CursorHold::intervalMicros, Driver*::*Y
+    uint64_t timestampMillis;
+    std::array<char, MAX_RECORD_TEXT_LENGTH + 1> text;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// Event schema
+///////////////////////////////////////////////////////////////////////////////
+//
+// Every event is described exactly once, by its EventSchema specialization below: the name it is
+// logged under, its EventType code, and one Field per struct member. A Field says what the member
+// is called, which EventRecord slot carries it and how its binary log column is encoded.
+// Everything else is generated from that description at compile time:
+//   - ToRecord / FromRecord (this file)
+//   - the text log serializer and parser (Logging.cpp)
+//   - the binary log columns (BinaryLog.cpp)
+//   - the JSON request schemas and SAX deserializers (Helpers/JSONEvents.hpp)
+//   - the Python log reader, log_events.py (Programs/Tools/EventReaderGen.cpp)
+// So adding or changing an event means touching its struct and its schema, and nothing else.
+
+/// @brief Where a field is kept in an EventRecord.
+enum class RecordSlot
+{
+    Timestamp,  // timestampMillis, every event has exactly one and it comes first
+    Flag,       // flag
+    ValueA,     // valueA
+    ValueB,     // valueB
+    Text        // text/textLength, at most one per event
+};
+
+/// @brief How a field's column is encoded in a binary log (see BinaryLog.hpp).
+enum class ColumnEncoding
+{
+    Delta,   // zigzag varint delta from the previous event of the same type
+    Varint,  // zigzag varint
+    Byte,    // one byte, for enums
+    Bits,    // packed bits, for bools
+    String   // string column
+};
+
+template <typename T>
+struct MemberPointerTraits;
+
+template <typename Class, typename Member>
+struct MemberPointerTraits<Member Class::*>
+{
+    using ClassType = Class;
+    using Type = Member;
+};
+
+/// @brief Describes one member of an event struct.
+///        Everything the generated code branches on is a template argument,
+///        so it all folds away at compile time.
+template <auto Member, RecordSlot Slot, ColumnEncoding Column>
+struct Field
+{
+    using Event = typename MemberPointerTraits<decltype(Member)>::ClassType;
+    using Type = typename MemberPointerTraits<decltype(Member)>::Type;
+    static constexpr auto MEMBER = Member;
+    static constexpr RecordSlot SLOT = Slot;
+    static constexpr ColumnEncoding COLUMN = Column;
+
+    std::string_view name;         // in text logs, JSON requests and generated readers
+    std::string_view description;  // in the JSON schema
+};
+
+/// @brief Every event's timestamp is described the same way.
+template <auto Member>
+constexpr Field<Member, RecordSlot::Timestamp, ColumnEncoding::Delta> TIMESTAMP_FIELD{
+    "timestampMillis", "The Unix time (in milliseconds) at which the event occurred."};
+
+/// @brief Names of an enum's values, indexed by value. Enums are logged by name.
+template <typename E>
+struct EnumSchema;
+
+template <>
+struct EnumSchema<Events::ClickLocation>
+{
+    static constexpr std::string_view NAME = "ClickLocation";
+    static constexpr std::array<std::string_view, 4> VALUES = {"OutOfBounds", "Background",
+                                                               "TextField", "Button"};
+};
+
+template <>
+struct EnumSchema<Events::HandPose>
+{
+    static constexpr std::string_view NAME = "HandPose";
+    static constexpr std::array<std::string_view, 3> VALUES = {"NoHand", "Move", "Click"};
+};
+
+template <typename E>
+constexpr std::string_view EnumToString(E value)
+{
+    const auto index = static_cast<size_t>(value);
+    return index < EnumSchema<E>::VALUES.size() ? EnumSchema<E>::VALUES[index] : "<unknown>";
+}
+
+template <typename E>
+constexpr bool EnumFromString(std::string_view name, E& value)
+{
+    for (size_t i = 0; i < EnumSchema<E>::VALUES.size(); i++)
+    {
+        if (EnumSchema<E>::VALUES[i] == name)
+        {
+            value = static_cast<E>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+template <typename T>
+struct EventSchema;
+
+template <>
+struct EventSchema<Events::Click>
+{
+    static constexpr std::string_view NAME = "Click";
+    static constexpr EventType TYPE = EventType::Click;
+    static constexpr auto FIELDS = std::tuple{
+        TIMESTAMP_FIELD<&Events::Click::timestampMillis>,
+        Field<&Events::Click::location, RecordSlot::ValueA, ColumnEncoding::Byte>{
+            "location", "The location on the page that the click was heard at."},
+        Field<&Events::Click::wasCorrect, RecordSlot::Flag, ColumnEncoding::Bits>{
+            "wasCorrect",
+            "Did the click hit the part of the page it was supposed to at this time?"}};
+};
+
+template <>
+struct EventSchema<Events::CursorPosition>
+{
+    static constexpr std::string_view NAME = "CursorPosition";
+    static constexpr EventType TYPE = EventType::CursorPosition;
+    static constexpr auto FIELDS = std::tuple{
+        TIMESTAMP_FIELD<&Events::CursorPosition::timestampMillis>,
+        Field<&Events::CursorPosition::positionX, RecordSlot::ValueA, ColumnEncoding::Delta>{
+            "positionX", "Horizontal cursor position in screen pixels."},
+        Field<&Events::CursorPosition::positionY, RecordSlot::ValueB, ColumnEncoding::Delta>{
+            "positionY", "Vertical cursor position in screen pixels."}};
+};
+
+template <>
+struct EventSchema<Events::Keystroke>
+{
+    static constexpr std::string_view NAME = "Keystroke";
+    static constexpr EventType TYPE = EventType::Keystroke;
+    static constexpr auto FIELDS = std::tuple{
+        TIMESTAMP_FIELD<&Events::Keystroke::timestampMillis>,
+        Field<&Events::Keystroke::key, RecordSlot::Text, ColumnEncoding::String>{
+            "key", "The key that was pressed."},
+        Field<&Events::Keystroke::wasCorrect, RecordSlot::Flag, ColumnEncoding::Bits>{
+            "wasCorrect", "Was this character valid input?"}};
+};
+
+template <>
+struct EventSchema<Events::FieldCompletion>
+{
+    static constexpr std::string_view NAME = "FieldCompletion";
+    static constexpr EventType TYPE = EventType::FieldCompletion;
+    static constexpr auto FIELDS = std::tuple{
+        TIMESTAMP_FIELD<&Events::FieldCompletion::timestampMillis>,
+        Field<&Events::FieldCompletion::fieldIndex, RecordSlot::ValueA, ColumnEncoding::Varint>{
+            "fieldIndex", "The index of the field that was completed."}};
+};
+
+template <>
+struct EventSchema<Events::TaskCompletion>
+{
+    static constexpr std::string_view NAME = "TaskCompletion";
+    static constexpr EventType TYPE = EventType::TaskCompletion;
+    static constexpr auto FIELDS = std::tuple{
+        TIMESTAMP_FIELD<&Events::TaskCompletion::timestampMillis>,
+        Field<&Events::TaskCompletion::taskIndex, RecordSlot::ValueA, ColumnEncoding::Varint>{
+            "taskIndex", "The index of the task that was completed."}};
+};
+
+template <>
+struct EventSchema<Events::DeviceChanged>
+{
+    static constexpr std::string_view NAME = "DeviceChanged";
+    static constexpr EventType TYPE = EventType::DeviceChanged;
+    static constexpr auto FIELDS = std::tuple{
+        TIMESTAMP_FIELD<&Events::DeviceChanged::timestampMillis>,
+        Field<&Events::DeviceChanged::newDevice, RecordSlot::Text, ColumnEncoding::String>{
+            "newDevice", "Name of the input device that is now driving the cursor."}};
+};
+
+template <>
+struct EventSchema<Events::CursorHold>
+{
+    static constexpr std::string_view NAME = "CursorHold";
+    static constexpr EventType TYPE = EventType::CursorHold;
+    static constexpr auto FIELDS = std::tuple{
+        TIMESTAMP_FIELD<&Events::CursorHold::timestampMillis>,
+        Field<&Events::CursorHold::sampleCount, RecordSlot::ValueA, ColumnEncoding::Varint>{
+            "sampleCount", "Number of samples the cursor did not move for."},
+        Field<&Events::CursorHold::intervalMicros, RecordSlot::ValueB, ColumnEncoding::Delta>{
+            "intervalMicros", "Time between two of those samples in microseconds."}};
+};
+
+template <>
+struct EventSchema<Events::DriverMove>
+{
+    static constexpr std::string_view NAME = "DriverMove";
+    static constexpr EventType TYPE = EventType::DriverMove;
+    static constexpr auto FIELDS = std::tuple{
+        TIMESTAMP_FIELD<&Events::DriverMove::timestampMillis>,
+        Field<&Events::DriverMove::dx, RecordSlot::ValueA, ColumnEncoding::Varint>{
+            "dx", "Horizontal relative mouse movement the driver sent, in pixels."},
+        Field<&Events::DriverMove::dy, RecordSlot::ValueB, ColumnEncoding::Varint>{
+            "dy", "Vertical relative mouse movement the driver sent, in pixels."}};
+};
+
+template <>
+struct EventSchema<Events::DriverClick>
+{
+    static constexpr std::string_view NAME = "DriverClick";
+    static constexpr EventType TYPE = EventType::DriverClick;
+    static constexpr auto FIELDS =
+        std::tuple{TIMESTAMP_FIELD<&Events::DriverClick::timestampMillis>};
+};
+
+template <>
+struct EventSchema<Events::DriverPose>
+{
+    static constexpr std::string_view NAME = "DriverPose";
+    static constexpr EventType TYPE = EventType::DriverPose;
+    static constexpr auto FIELDS = std::tuple{
+        TIMESTAMP_FIELD<&Events::DriverPose::timestampMillis>,
+        Field<&Events::DriverPose::pose, RecordSlot::ValueA, ColumnEncoding::Byte>{
+            "pose", "What the hand was classified as from this frame on."}};
+};
+
+template <>
+struct EventSchema<Events::DriverAccumulator>
+{
+    static constexpr std::string_view NAME = "DriverAccumulator";
+    static constexpr EventType TYPE = EventType::DriverAccumulator;
+    static constexpr auto FIELDS = std::tuple{
+        TIMESTAMP_FIELD<&Events::DriverAccumulator::timestampMillis>,
+        Field<&Events::DriverAccumulator::accumulatorX, RecordSlot::ValueA, ColumnEncoding::Delta>{
+            "accumulatorX",
+            "Horizontal sub-pixel movement carried over to the next frame, in 1/1000 pixels."},
+        Field<&Events::DriverAccumulator::accumulatorY, RecordSlot::ValueB, ColumnEncoding::Delta>{
+            "accumulatorY",
+            "Vertical sub-pixel movement carried over to the next frame, in 1/1000 pixels."}};
+};
+
+/// @brief Every event type, in EventType order.
+using AllEvents =
+    std::tuple<Events::Click, Events::CursorPosition, Events::Keystroke, Events::FieldCompletion,
+               Events::TaskCompletion, Events::DeviceChanged, Events::CursorHold,
+               Events::DriverMove, Events::DriverClick, Events::DriverPose,
+               Events::DriverAccumulator>;
+
+constexpr size_t NUM_EVENT_TYPES = std::tuple_size_v<AllEvents>;
+
+template <typename T, typename List>
+constexpr bool IS_LISTED_EVENT = false;
+
+template <typename T, typename... U>
+constexpr bool IS_LISTED_EVENT<T, std::tuple<U...>> = IsAnyOf<T, U...>;
+
+template <typename T>
+concept Loggable = IS_LISTED_EVENT<T, AllEvents>;
+
+///////////////////////////////////////////////////////////////////////////////
+// Schema traversal
+///////////////////////////////////////////////////////////////////////////////
+
+/// @brief The Field type of a field visited by ForEachField.
+template <typename F>
+using FieldOf = std::remove_cvref_t<F>;
+
+template <Loggable T>
+constexpr size_t NUM_FIELDS = std::tuple_size_v<decltype(EventSchema<T>::FIELDS)>;
+
+/// @brief Calls fn(field) for every field of T, in declaration order. Unrolled at compile time.
+template <Loggable T, typename Fn>
+constexpr void ForEachField(Fn&& fn)
+{
+    std::apply([&fn](const auto&... fields) { (fn(fields), ...); }, EventSchema<T>::FIELDS);
+}
+
+/// @brief Calls fn(std::type_identity<T>{}) for every event type, in EventType order.
+template <typename Fn>
+constexpr void ForEachEventType(Fn&& fn)
+{
+    [&fn]<size_t... I>(std::index_sequence<I...>)
+    {
+        (fn(std::type_identity<std::tuple_element_t<I, AllEvents>>{}), ...);
+    }(std::make_index_sequence<NUM_EVENT_TYPES>{});
+}
+
+/// @brief Calls fn(std::type_identity<T>{}) for the event type with code type.
+/// @return false if type is not a known event type.
+template <typename Fn>
+constexpr bool VisitEventType(EventType type, Fn&& fn)
+{
+    return [&fn, type]<size_t... I>(std::index_sequence<I...>)
+    {
+        return ((static_cast<size_t>(type) == I &&
+                 (fn(std::type_identity<std::tuple_element_t<I, AllEvents>>{}), true)) ||
+                ...);
+    }(std::make_index_sequence<NUM_EVENT_TYPES>{});
+}
+
+/// @brief Position of T's Text field, or NUM_FIELDS<T> if it has none.
+template <Loggable T>
+consteval size_t TextFieldIndex()
+{
+    size_t index = 0, textIndex = NUM_FIELDS<T>;
+    ForEachField<T>(
+        [&](const auto& field)
+        {
+            if (FieldOf<decltype(field)>::SLOT == RecordSlot::Text)
+                textIndex = index;
+            index++;
+        });
+    return textIndex;
+}
+
+template <Loggable T>
+consteval bool IsValidSchema()
+{
+    bool isValid = true;
+    size_t index = 0;
+    std::array<int, 5> slotUses{};
+    ForEachField<T>(
+        [&](const auto& field)
+        {
+            using F = FieldOf<decltype(field)>;
+            using Type = typename F::Type;
+
+            isValid = isValid && std::is_same_v<typename F::Event, T> && !field.name.empty() &&
+                      ++slotUses[static_cast<size_t>(F::SLOT)] == 1 &&
+                      (index++ == 0) == (F::SLOT == RecordSlot::Timestamp);
+
+            // every slot only fits some types, every column encoding only suits some types
+            switch (F::SLOT)
+            {
+                case RecordSlot::Timestamp:
+                    isValid = isValid && std::is_same_v<Type, uint64_t>;
+                    break;
+                case RecordSlot::Flag:
+                    isValid = isValid && std::is_same_v<Type, bool>;
+                    break;
+                case RecordSlot::ValueA:
+                case RecordSlot::ValueB:
+                    isValid = isValid && (std::is_enum_v<Type> || std::is_same_v<Type, int>);
+                    break;
+                case RecordSlot::Text:
+                    isValid = isValid && std::is_same_v<Type, std::string>;
+                    break;
+            }
+            switch (F::COLUMN)
+            {
+                case ColumnEncoding::Delta:
+                case ColumnEncoding::Varint:
+                    isValid = isValid && std::is_integral_v<Type> && !std::is_same_v<Type, bool>;
+                    break;
+                case ColumnEncoding::Byte:
+                    isValid = isValid && std::is_enum_v<Type>;
+                    break;
+                case ColumnEncoding::Bits:
+                    isValid = isValid && std::is_same_v<Type, bool>;
+                    break;
+                case ColumnEncoding::String:
+                    isValid = isValid && std::is_same_v<Type, std::string>;
+                    break;
+            }
+        });
+    return isValid && slotUses[static_cast<size_t>(RecordSlot::Timestamp)] == 1;
+}
+
+template <size_t... I>
+consteval bool AreValidSchemas(std::index_sequence<I...>)
+{
+    return ((EventSchema<std::tuple_element_t<I, AllEvents>>::TYPE == static_cast<EventType>(I)) &&
+            ...) &&
+           (IsValidSchema<std::tuple_element_t<I, AllEvents>>() && ...);
+}
+
+static_assert(AreValidSchemas(std::make_index_sequence<NUM_EVENT_TYPES>{}),
+              "AllEvents must be in EventType order, and every event schema must be well-formed");
+
+///////////////////////////////////////////////////////////////////////////////
+// Conversions between events and records
+///////////////////////////////////////////////////////////////////////////////
+inline void CopyRecordText(EventRecord& record, std::string_view text)
+{
+    const size_t length = std::min(text.size(), MAX_RECORD_TEXT_LENGTH);
+    std::memcpy(record.text.data(), text.data(), length);
+    record.text[length] = '\0';
+    record.textLength = static_cast<uint8_t>(length);
+}
+
+inline std::string_view RecordText(const EventRecord& record)
+{
+    return std::string_view(record.text.data(), record.textLength);
+}
+
+/// @brief Writes value into a record slot. Text values are truncated to MAX_RECORD_TEXT_LENGTH.
+template <RecordSlot Slot, typename V>
+constexpr void StoreSlot(EventRecord& record, const V& value)
+{
+    if constexpr (Slot == RecordSlot::Timestamp)
+        record.timestampMillis = static_cast<uint64_t>(value);
+    else if constexpr (Slot == RecordSlot::Flag)
+        record.flag = static_cast<bool>(value);
+    else if constexpr (Slot == RecordSlot::ValueA)
+        record.valueA = static_cast<int32_t>(value);
+    else if constexpr (Slot == RecordSlot::ValueB)
+        record.valueB = static_cast<int32_t>(value);
+    else
+        CopyRecordText(record, value);
+}
+
+/// @brief Reads a record slot back as a V.
+template <RecordSlot Slot, typename V>
+constexpr V LoadSlot(const EventRecord& record)
+{
+    if constexpr (Slot == RecordSlot::Timestamp)
+        return static_cast<V>(record.timestampMillis);
+    else if constexpr (Slot == RecordSlot::Flag)
+        return static_cast<V>(record.flag);
+    else if constexpr (Slot == RecordSlot::ValueA)
+        return static_cast<V>(record.valueA);
+    else if constexpr (Slot == RecordSlot::ValueB)
+        return static_cast<V>(record.valueB);
+    else
+        return V(RecordText(record));
+}
+
+template <Loggable T>
+EventRecord ToRecord(const T& event)
+{
+    EventRecord record{};
+    record.type = EventSchema<T>::TYPE;
+    ForEachField<T>(
+        [&](const auto& field)
+        {
+            using F = FieldOf<decltype(field)>;
+            StoreSlot<F::SLOT>(record, event.*F::MEMBER);
+        });
+    return record;
+}
+
+template <Loggable T>
+T FromRecord(const EventRecord& record)
+{
+    T event{};
+    ForEachField<T>(
+        [&](const auto& field)
+        {
+            using F = FieldOf<decltype(field)>;
+            event.*F::MEMBER = LoadSlot<F::SLOT, typename F::Type>(record);
+        });
+    return event;
+}
+
+}  // namespace Logging
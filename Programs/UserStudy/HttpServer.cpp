@@ -6,6 +6,7 @@
 #include <rapidjson/schema.h>
 
 #include <HTML/HTMLTemplate.hpp>
+#include <Helpers/Clock.hpp>
 #include <Helpers/HTTPHelpers.hpp>
 #include <Helpers/JSONEvents.hpp>
 #include <Helpers/SSE.hpp>
@@ -38,11 +39,15 @@ void HttpServerLoop(SyncState& syncState)
     if (!std::filesystem::exists(LOG_BASE_DIR))
         std::filesystem::create_directory(LOG_BASE_DIR);
 
+    // salvage whatever a previous crash left behind before any new log is opened
+    Logging::RecoverLogDirectory(std::string(LOG_BASE_DIR));
+
     httplib::Server server;
     if (!server.set_mount_point("/", "./www/"))
     {
         std::cout << "[HTTP] Unable to set mount point.\n";
         syncState.isRunning.store(false);
+        syncState.NotifyStateChanged();
         return;
     }
 
@@ -106,6 +111,7 @@ void HttpServerLoop(SyncState& syncState)
             std::string logFilename = std::format("{}/user{}.log", LOG_BASE_DIR, userId);
             syncState.logger.OpenLogFile(logFilename);
             syncState.isLogging = true;
+            syncState.NotifyStateChanged();
 
             std::cout << std::format(
                 "[HTTP] Starting user study for user ID {} (counterbalancing index={}).\n", userId,
@@ -159,6 +165,7 @@ void HttpServerLoop(SyncState& syncState)
         }
         server.stop();
         syncState.isRunning.store(false);
+        syncState.NotifyStateChanged();
     };
 
     auto pageHandler = [&studyControl, &formTemplate, &formTemplateTutorial, &emailTemplate,
@@ -180,6 +187,7 @@ void HttpServerLoop(SyncState& syncState)
         {
             res.set_content(tutorialTemplate.GetSubstitution(), "text/html");
             syncState.isLeapDriverActive.store(true);
+            syncState.NotifyStateChanged();
             return;
         }
 
@@ -215,12 +223,13 @@ void HttpServerLoop(SyncState& syncState)
                 syncState.isLeapDriverActive.store(false);
                 break;
         }
+        syncState.NotifyStateChanged();
 
         // Form is assumed to always be the first task
         if (syncState.isLogging.load() && studyControl.GetState() == Task && studyControl.GetCurrTask() == Form)
         {
             syncState.logger.Log(Logging::Events::DeviceChanged{
-                .timestampMillis = Logging::GetCurrentUnixTimeMillis(),
+                .timestampMillis = Helpers::Clock::NowUnixMillis(),
                 .newDevice = device
             });
         }
@@ -333,6 +342,49 @@ void HttpServerLoop(SyncState& syncState)
         Helpers::parseErrorHandler(req, res, result.Error());
     };
 
+    // tracking frame captures, for replaying later (see --replay)
+    // can be switched on and off at any point, including in the middle of a task
+    auto recordingStartHandler = [&studyControl, &syncState](const Req& req, Res& res)
+    {
+        if (!syncState.frameSource.CanRecord())
+        {
+            res.status = 501;
+            return;
+        }
+
+        const uint64_t millis = Helpers::Clock::NowUnixMillis();
+        std::string filename = studyControl.GetState() == Start
+                                   ? std::format("{}/capture_{}.frames", LOG_BASE_DIR, millis)
+                                   : std::format("{}/user{}_{}.frames", LOG_BASE_DIR,
+                                                 studyControl.GetUserId(), millis);
+        if (!syncState.frameSource.StartRecording(filename))
+        {
+            std::cout << std::format("[HTTP] Unable to record tracking frames to {}.\n", filename);
+            res.status = 500;
+            return;
+        }
+        res.set_content(filename, "text/plain");
+        res.status = 200;
+    };
+
+    auto recordingStopHandler = [&syncState](const Req& req, Res& res)
+    {
+        if (!syncState.frameSource.IsRecording())
+        {
+            res.status = 409;
+            return;
+        }
+        syncState.frameSource.StopRecording();
+        res.status = 200;
+    };
+
+    // the input latency so far, while the study runs (the driver prints it again on shutdown)
+    auto latencyHandler = [&syncState](const Req& req, Res& res)
+    {
+        res.set_content(syncState.inputLatency.Format(), "text/plain");
+        res.status = 200;
+    };
+
     // Hook up the lambdas to the server and begin listening
     server.set_error_handler(Helpers::errorHandler);
     server.set_exception_handler(Helpers::exceptionHandler);
@@ -345,6 +397,10 @@ void HttpServerLoop(SyncState& syncState)
     server.Post("/proceed", proceedHandler);
     server.Post("/quit", quitHandler);
 
+    server.Post("/recording/start", recordingStartHandler);
+    server.Post("/recording/stop", recordingStopHandler);
+    server.Get("/latency", latencyHandler);
+
     server.Post("/events/click", eventsClickHandler);
     server.Post("/events/keystroke", eventsKeystrokeHandler);
     server.Post("/events/field", eventsFieldHandler);
@@ -0,0 +1,52 @@
+#include "InputLatency.hpp"
+
+#include <format>
+
+namespace Input
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+const char* GetLatencyStageName(LatencyStage stage)
+{
+    switch (stage)
+    {
+        case LatencyStage::TrackerToReceipt:
+            return "tracker to receipt";
+        case LatencyStage::ReceiptToRead:
+            return "receipt to read";
+        case LatencyStage::ReadToProcessed:
+            return "read to processed";
+        case LatencyStage::ProcessedToInput:
+            return "processed to input";
+        case LatencyStage::ReceiptToInput:
+            return "receipt to input";
+        case LatencyStage::TrackerToInput:
+            return "tracker to input";
+        default:
+            return "unknown";
+    }
+}
+
+std::string InputLatency::Format() const
+{
+    auto toMicros = [](double nanos) { return nanos / 1000.0; };
+
+    std::string table = std::format("{:<20}{:>10}{:>10}{:>10}{:>10}{:>10}{:>10}{:>10}  (us)\n",
+                                    "stage", "frames", "mean", "p50", "p90", "p99", "p99.9", "max");
+    for (size_t i = 0; i < NUM_LATENCY_STAGES; i++)
+    {
+        const Helpers::LatencyHistogram::Snapshot snapshot = m_stages[i].GetSnapshot();
+        table += std::format(
+            "{:<20}{:>10}{:>10.1f}{:>10.1f}{:>10.1f}{:>10.1f}{:>10.1f}{:>10.1f}\n",
+            GetLatencyStageName(static_cast<LatencyStage>(i)), snapshot.count,
+            toMicros(snapshot.GetMeanNanos()), toMicros(snapshot.GetPercentileNanos(50.0)),
+            toMicros(snapshot.GetPercentileNanos(90.0)),
+            toMicros(snapshot.GetPercentileNanos(99.0)),
+            toMicros(snapshot.GetPercentileNanos(99.9)), toMicros(snapshot.maxNanos));
+    }
+    return table;
+}
+
+}  // namespace Input
\ No newline at end of file
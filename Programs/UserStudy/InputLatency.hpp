@@ -0,0 +1,47 @@
+#pragma once
+
+#include <Helpers/LatencyHistogram.hpp>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <string>
+
+namespace Input
+{
+
+/// @brief The hops a tracking frame makes on its way to becoming mouse input.
+///        A frame is timestamped by the tracker, received by the frame source (OnFrame),
+///        read by the driver (GetFrame), judged (ProcessHandState returns), and turned into
+///        input (SendInput returns). The last two stages span several hops.
+enum class LatencyStage
+{
+    TrackerToReceipt,  // only known for frames straight from the device
+    ReceiptToRead,
+    ReadToProcessed,
+    ProcessedToInput,
+    ReceiptToInput,
+    TrackerToInput,  // what the participant feels; only known for frames from the device
+};
+
+constexpr size_t NUM_LATENCY_STAGES = 6;
+
+const char* GetLatencyStageName(LatencyStage stage);
+
+/// @brief A LatencyHistogram per stage. The driver records, and any thread can read them
+///        at the same time, so they can be dumped while the study runs.
+class InputLatency
+{
+   public:
+    void Record(LatencyStage stage, std::chrono::nanoseconds duration)
+    {
+        m_stages[static_cast<size_t>(stage)].Record(duration);
+    }
+
+    /// @brief A table of every stage's frame count, mean and percentiles, in microseconds.
+    std::string Format() const;
+
+   private:
+    std::array<Helpers::LatencyHistogram, NUM_LATENCY_STAGES> m_stages;
+};
+
+}  // namespace Input
\ No newline at end of file
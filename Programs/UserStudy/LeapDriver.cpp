@@ -1,72 +1,207 @@
 #include "LeapDriver.hpp"
 
+#include <Helpers/Clock.hpp>
+#include <Input/GestureClassifier.hpp>
+#include <Input/HandStateFilter.hpp>
 #include <Input/LeapMotionGestureProvider.hpp>
 #include <Input/SimulatedMouse.hpp>
-#include <Math/Vector3Common.hpp>
+#include <algorithm>
 #include <chrono>
+#include <cstdint>
 #include <iostream>
 #include <optional>
 #include <sstream>
 #include <string>
-#include <thread>
+#include <variant>
 
-using Vec3 = Math::Vector3Common;
+#include "Logging.hpp"
+
+using Logging::Events::HandPose;
 
 namespace Input
 {
 
-void DriverLoop(SyncState& syncState)
+/// @brief How often the driver woke up, and how much input it made.
+///        How long that took is in SyncState::inputLatency.
+struct DriverStats
+{
+    uint64_t numWakeups;
+    uint64_t numFrames;
+    uint64_t numFramesSkipped;  // superseded by a newer frame before the driver got to them
+    uint64_t numInputs;
+
+    void Print(std::chrono::nanoseconds wallTime, std::chrono::nanoseconds cpuTime) const
+    {
+        using namespace std::chrono;
+        const double cpuPercent =
+            wallTime.count() > 0 ? 100.0 * cpuTime.count() / wallTime.count() : 0.0;
+        std::cout << "[main] Driver: " << numFrames << " frames (" << numFramesSkipped
+                  << " skipped) in " << numWakeups << " wakeups, " << numInputs << " inputs, "
+                  << duration_cast<milliseconds>(cpuTime).count() << "ms CPU over "
+                  << duration_cast<seconds>(wallTime).count() << "s (" << cpuPercent << "%)\n";
+    }
+};
+
+void PrintFilterStats(const Leap::HandFilterConfig& config, const Leap::HandFilterStats& stats)
+{
+    using namespace std::chrono;
+    const auto meanTime = stats.numFrames > 0
+                              ? stats.totalFilterTime / static_cast<int64_t>(stats.numFrames)
+                              : nanoseconds(0);
+    const double pathPercent =
+        stats.rawPathLength > 0.0 ? 100.0 * stats.filteredPathLength / stats.rawPathLength : 0.0;
+    std::cout << "[main] Driver: " << Leap::GetHandFilterName(config.type) << " filter lag mean "
+              << stats.GetMeanLagSeconds() * 1e3 << "ms, max " << stats.maxLagSeconds * 1e3
+              << "ms, " << stats.numFramesOverBudget << " of " << stats.numLagFrames
+              << " turning frames over the " << config.lagBudgetSeconds * 1e3 << "ms budget\n";
+    std::cout << "[main] Driver: filtered palm normal path " << pathPercent << "% of raw, "
+              << stats.numResets << " resets, filter time mean " << meanTime.count()
+              << "ns, max " << duration_cast<microseconds>(stats.maxFilterTime).count()
+              << "us over " << stats.numFrames << " frames\n";
+}
+
+/// @brief DriverLoop, compiled for one classifier.
+template <typename Classifier>
+void RunDriverLoop(SyncState& syncState, bool isLoggingInput,
+                   const Leap::HandFilterConfig& filterConfig, Classifier& classifier)
 {
-    std::cout << "[main] Starting Leap Motion driver thread...\n";
+    // Input events go through this thread's own lane of the logger, a wait-free ring,
+    // and are dropped rather than waited on if it is ever full.
+    if (isLoggingInput && !syncState.logger.ReserveLane())
+        std::cout << "[main] The driver has no logger lane of its own, input logging may stall\n";
+    uint64_t numInputEventsLogged = 0;
+    uint64_t numInputEventsDropped = 0;
+    std::optional<HandPose> loggedPose;  // the last pose logged since logging (re)started
 
-    using Clock = std::chrono::high_resolution_clock;
-    using Time = std::chrono::high_resolution_clock::time_point;
+    // the same time base as the log's timestamps, and it doesn't jump when the wall clock is set
+    using Clock = Helpers::Clock::SteadyClock;
+    using Time = Clock::time_point;
     using Nanos = std::chrono::nanoseconds;
 
-    constexpr Nanos frameTime = Nanos(1'000'000);  // 1ms
+    // Cursor speed in pixels per second of tracking time, integrated over the real time between
+    // frames. The loop used to move 0.4px every 1ms tick; this keeps that nominal speed.
+    constexpr float speed = 400.0f;
+    // a longer gap (tracking stalled, the driver was parked) counts as this long
+    constexpr float maxFrameSeconds = 0.05f;
+
+    DriverStats stats{};
+    const Time threadStart = Clock::now();
+    const Nanos cpuStart = Helpers::Clock::GetThreadCpuTime();
 
-    bool isClickDisengaged = true;
     float dxAccumulator = 0.0f;
     float dyAccumulator = 0.0f;
 
+    // Between reading a hand and judging it. It has to forget the hand whenever frames stop
+    // following on from each other: the hand is lost, or the driver was parked.
+    Leap::HandFilterStage filterStage(filterConfig);
+
+    uint64_t lastSequence = syncState.frameSource.GetFrameSequence();
+    std::optional<int64_t> lastFrameMicros;  // LeapC time of the previous frame processed
+
     while (syncState.isRunning.load())
     {
-        // TODO: do something else that isn't a spinlock
-        while (!syncState.isLeapDriverActive.load() && syncState.isRunning.load())
-            ;
-
-        Time frameStart = Clock::now();
+        // parked while the participant uses the mouse
+        if (!syncState.isLeapDriverActive.load())
+        {
+            syncState.WaitForState(
+                [&syncState]
+                { return syncState.isLeapDriverActive.load() || !syncState.isRunning.load(); });
+            if (!syncState.isRunning.load())
+                break;
+            // frames that came in while parked were never meant to be processed
+            lastSequence = syncState.frameSource.GetFrameSequence();
+            lastFrameMicros.reset();
+            filterStage.Reset();
+            classifier.Reset();
+        }
 
-        LEAP_TRACKING_EVENT* leapFrame = syncState.connection.GetFrame();
-        if (!leapFrame)
+        // Sleeps until the tracker delivers a frame. State changes cut the wait short
+        // (SyncState::NotifyStateChanged), and then there is no new frame to process.
+        stats.numWakeups++;
+        if (syncState.frameSource.WaitForFrame(lastSequence) == lastSequence)
             continue;
 
-        if (leapFrame->nHands == 0)
+        const Leap::TrackingFrame leapFrame = syncState.frameSource.GetFrame();
+        const Time frameStart = Clock::now();
+        stats.numFrames++;
+        stats.numFramesSkipped += leapFrame.sequence - lastSequence - 1;
+        lastSequence = leapFrame.sequence;
+
+        float frameSeconds = 0.0f;
+        if (lastFrameMicros)
+        {
+            frameSeconds = static_cast<float>(leapFrame.timestampMicros - *lastFrameMicros) / 1e6f;
+            frameSeconds = std::clamp(frameSeconds, 0.0f, maxFrameSeconds);
+        }
+        lastFrameMicros = leapFrame.timestampMicros;
+
+        // The tracker stamps frames on LeapC's clock, so the hop to the source is timed on that
+        // clock, and every hop after it on the steady clock.
+        const bool isFromTracker = leapFrame.receivedMicros != 0;
+        const Nanos trackerLatency = std::chrono::microseconds(
+            isFromTracker ? leapFrame.receivedMicros - leapFrame.timestampMicros : 0);
+        if (isFromTracker)
+            syncState.inputLatency.Record(LatencyStage::TrackerToReceipt, trackerLatency);
+        syncState.inputLatency.Record(LatencyStage::ReceiptToRead,
+                                      frameStart - leapFrame.receivedAt);
+        Time processedAt;
+        auto recordInput = [&]()
+        {
+            const Time inputAt = Clock::now();
+            stats.numInputs++;
+            syncState.inputLatency.Record(LatencyStage::ProcessedToInput, inputAt - processedAt);
+            syncState.inputLatency.Record(LatencyStage::ReceiptToInput,
+                                          inputAt - leapFrame.receivedAt);
+            if (isFromTracker)
+            {
+                syncState.inputLatency.Record(
+                    LatencyStage::TrackerToInput,
+                    trackerLatency + (inputAt - leapFrame.receivedAt));
+            }
+        };
+
+        const bool isLoggingFrame =
+            isLoggingInput && syncState.isLogging.load(std::memory_order_relaxed);
+        if (!isLoggingFrame)
+            loggedPose.reset();
+        const uint64_t frameMillis = Helpers::Clock::ToUnixMillis(frameStart);
+        auto logInput = [&](const auto& event)
+        {
+            if (!isLoggingFrame)
+                return;
+            if (syncState.logger.TryLog(event))
+                numInputEventsLogged++;
+            else
+                numInputEventsDropped++;
+        };
+        auto logPose = [&](HandPose pose)
+        {
+            if (isLoggingFrame && loggedPose != pose)
+            {
+                logInput(Logging::Events::DriverPose{.timestampMillis = frameMillis, .pose = pose});
+                loggedPose = pose;
+            }
+        };
+
+        if (leapFrame.nHands == 0)
         {
+            logPose(HandPose::NoHand);
+            filterStage.Reset();
+            classifier.Reset();
             std::lock_guard<std::mutex> lock(syncState.renderableCopyMutex);
             syncState.renderables = Renderables{};
         }
         else
         {
             // yes, we only want the most recent hand
-            LEAP_HAND hand = leapFrame->pHands[leapFrame->nHands - 1];
-
-            Leap::UnprocessedHandState inState{};
-            inState.isTracking = true;
-            inState.isLeft = hand.type == eLeapHandType_Left;
-            inState.palmNormal = Vec3(hand.palm.normal);
-            inState.handDirection = Vec3(hand.palm.direction);
-
-            for (int i = 1; i < 5; i++)
-            {
-                LEAP_DIGIT finger = hand.digits[i];
-                Vec3 distalTip(finger.distal.next_joint);
-                Vec3 distalBase(finger.distal.prev_joint);
-
-                inState.fingerDirections[i - 1] = Vec3::Subtract(distalTip, distalBase);
-            }
+            LEAP_HAND hand = leapFrame.hands[leapFrame.nHands - 1];
 
-            Leap::ProcessedHandState outState = Leap::ProcessHandState(inState);
+            Leap::UnprocessedHandState inState = Leap::ToUnprocessedHandState(hand);
+            filterStage.Process(inState, frameSeconds);
+            const Leap::GestureDecision decision = classifier.Classify(inState, frameSeconds);
+            const Leap::ProcessedHandState& outState = decision.hand;
+            processedAt = Clock::now();
+            syncState.inputLatency.Record(LatencyStage::ReadToProcessed, processedAt - frameStart);
             {
                 std::lock_guard<std::mutex> lock(syncState.renderableCopyMutex);
                 syncState.renderables.hasHand = true;
@@ -81,20 +216,18 @@ void DriverLoop(SyncState& syncState)
             // do the input finally
             // click pose and movement pose are mutually exclusive
             // poses in neither state are encoded as a relative mouse movement of (0, 0)
-            if (isClickDisengaged && outState.isInClickPose)
+            logPose(outState.isInClickPose ? HandPose::Click : HandPose::Move);
+            // the classifier's click policy says when holding the click pose clicks
+            if (decision.shouldClick)
             {
                 Input::Mouse::LeftClick();
-                // click is engaged
-                // meaning: we only want to click once, not every frame
-                // non-click poses will disengage the click, letting us click again
-                isClickDisengaged = false;
+                recordInput();
+                logInput(Logging::Events::DriverClick{.timestampMillis = frameMillis});
             }
             else if (!outState.isInClickPose)
             {
-                // originally this speed was 2px per every 16.67ms (60Hz)
-                constexpr float speed = 0.4f;
-                dxAccumulator += outState.cursorDirectionX * speed;
-                dyAccumulator += outState.cursorDirectionY * speed * -1.0f;
+                dxAccumulator += outState.cursorDirectionX * speed * frameSeconds;
+                dyAccumulator += outState.cursorDirectionY * speed * frameSeconds * -1.0f;
 
                 // The Win32 mouse movement only accepts an integer number of pixels to move.
                 // We harvest the integer part of the accumulator here,
@@ -107,17 +240,42 @@ void DriverLoop(SyncState& syncState)
 
                 // and perform the movement.
                 Input::Mouse::MoveRelative(dx, dy);
-
-                // click pose and movement pose are mutually exclusive
-                isClickDisengaged = true;
+                recordInput();
+                if (dx != 0 || dy != 0)
+                {
+                    logInput(Logging::Events::DriverMove{
+                        .timestampMillis = frameMillis, .dx = dx, .dy = dy});
+                }
+                logInput(Logging::Events::DriverAccumulator{
+                    .timestampMillis = frameMillis,
+                    .accumulatorX = static_cast<int>(dxAccumulator * 1000.0f),
+                    .accumulatorY = static_cast<int>(dyAccumulator * 1000.0f)});
             }
         }
+    }
 
-        Time frameEnd = Clock::now();
-        Nanos processingTime = frameEnd - frameStart;
-        if (processingTime.count() > 0)
-            std::this_thread::sleep_for(frameTime - processingTime);
+    if (isLoggingInput)
+    {
+        std::cout << "[main] Driver input events: " << numInputEventsLogged << " logged, "
+                  << numInputEventsDropped << " dropped\n";
     }
+    stats.Print(Clock::now() - threadStart, Helpers::Clock::GetThreadCpuTime() - cpuStart);
+    std::cout << "[main] Driver latency:\n" << syncState.inputLatency.Format();
+    if (filterStage.IsEnabled())
+        PrintFilterStats(filterConfig, filterStage.GetStats());
+}
+
+void DriverLoop(SyncState& syncState, bool isLoggingInput,
+                const Leap::HandFilterConfig& filterConfig,
+                Leap::GestureClassifierType classifierType)
+{
+    std::cout << "[main] Starting Leap Motion driver thread with the "
+              << Leap::GetGestureClassifierName(classifierType) << " gesture classifier...\n";
+
+    Leap::AnyGestureClassifier classifier = Leap::MakeGestureClassifier(classifierType);
+    std::visit([&](auto& chosen)
+               { RunDriverLoop(syncState, isLoggingInput, filterConfig, chosen); },
+               classifier);
 
     std::cout << "[main] Shutting down Leap Motion driver thread...\n";
 }
@@ -1,10 +1,20 @@
 #pragma once
 
+#include <Input/GestureClassifier.hpp>
+#include <Input/HandStateFilter.hpp>
+
 #include "SyncState.hpp"
 
 namespace Input
 {
 
-void DriverLoop(SyncState& syncState);
+/// @brief Turns tracked hand poses into mouse input, once per tracking frame while
+///        syncState.isLeapDriverActive is set. With isLoggingInput, every move, click,
+///        pose change and sub-pixel remainder it produces is logged as well.
+///        Hands are smoothed by the filter in filterConfig, if any, before they are judged
+///        by the classifier of classifierType.
+void DriverLoop(SyncState& syncState, bool isLoggingInput,
+                const Leap::HandFilterConfig& filterConfig,
+                Leap::GestureClassifierType classifierType);
 
 }
\ No newline at end of file
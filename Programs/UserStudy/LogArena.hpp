@@ -0,0 +1,99 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+namespace Logging
+{
+
+/// @brief Upper bound on the size of one serialized text event, used to decide when to flush.
+constexpr size_t MAX_SERIALIZED_EVENT_SIZE = 128;
+
+/// @brief Default arena size for the writer thread. Comfortably holds a full flush of events.
+constexpr size_t DEFAULT_ARENA_CAPACITY = 256 * 1024;
+
+/// @brief Contiguous, pre-reserved byte buffer that events are serialized straight into.
+///        Appending never allocates as long as the owner flushes before the arena fills up;
+///        if it does not, the arena grows instead of dropping data.
+class LogArena
+{
+   public:
+    explicit LogArena(size_t capacity = DEFAULT_ARENA_CAPACITY)
+        : m_data(std::make_unique<char[]>(capacity)), m_size(0), m_capacity(capacity)
+    {
+    }
+
+    LogArena(const LogArena&) = delete;
+    LogArena& operator=(const LogArena&) = delete;
+
+    void Append(std::string_view text) { append(text.data(), text.size()); }
+
+    void Append(char c)
+    {
+        Reserve(1);
+        m_data[m_size++] = c;
+    }
+
+    template <std::integral I>
+    void AppendInteger(I value)
+    {
+        // 20 digits plus a sign covers every 64-bit integer
+        Reserve(21);
+        auto result = std::to_chars(m_data.get() + m_size, m_data.get() + m_capacity, value);
+        m_size = result.ptr - m_data.get();
+    }
+
+    void AppendBool(bool value) { Append(value ? std::string_view("true") : "false"); }
+
+    // std::string-like spellings, so generic encoders (e.g. Helpers::AppendVarint) can use it
+    void append(const char* data, size_t length)
+    {
+        Reserve(length);
+        std::memcpy(m_data.get() + m_size, data, length);
+        m_size += length;
+    }
+
+    LogArena& operator+=(char c)
+    {
+        Append(c);
+        return *this;
+    }
+
+    char* Data() { return m_data.get(); }
+    const char* Data() const { return m_data.get(); }
+    std::string_view View() const { return std::string_view(m_data.get(), m_size); }
+
+    size_t Size() const { return m_size; }
+    size_t Capacity() const { return m_capacity; }
+    size_t Remaining() const { return m_capacity - m_size; }
+    bool IsEmpty() const { return m_size == 0; }
+
+    void Clear() { m_size = 0; }
+
+    /// @brief Drops everything after the first size bytes.
+    void Truncate(size_t size) { m_size = std::min(size, m_size); }
+
+   private:
+    std::unique_ptr<char[]> m_data;
+    size_t m_size;
+    size_t m_capacity;
+
+    void Reserve(size_t length)
+    {
+        if (m_capacity - m_size >= length)
+            return;
+
+        const size_t newCapacity = std::max(m_capacity * 2, m_size + length);
+        auto newData = std::make_unique<char[]>(newCapacity);
+        std::memcpy(newData.get(), m_data.get(), m_size);
+        m_data = std::move(newData);
+        m_capacity = newCapacity;
+    }
+};
+
+}  // namespace Logging
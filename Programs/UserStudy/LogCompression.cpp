@@ -0,0 +1,328 @@
+#include "LogCompression.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Logging
+{
+
+constexpr size_t MIN_MATCH_LENGTH = 4;
+constexpr size_t MAX_MATCH_OFFSET = 65535;
+constexpr size_t HASH_BITS = 14;
+
+// matches never reach into the last few bytes of a block, so finding one never reads past the end
+constexpr size_t LAST_LITERALS = 5;
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+void AppendLE32(LogArena& out, uint32_t value);
+void PatchLE32(LogArena& out, size_t offset, uint32_t value);
+uint32_t ReadLE32(const char* data);
+
+uint32_t HashSequence(const char* data);
+void AppendExtraCount(LogArena& out, size_t count);
+bool ReadExtraCount(std::string_view stored, size_t& offset, size_t& count);
+void AppendSequence(LogArena& out, std::string_view literals, size_t matchOffset,
+                    size_t matchLength);
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of class methods
+///////////////////////////////////////////////////////////////////////////////
+void AppendCompressedLogHeader(LogArena& out)
+{
+    out.append(COMPRESSED_LOG_MAGIC.data(), COMPRESSED_LOG_MAGIC.size());
+    AppendLE32(out, COMPRESSED_LOG_VERSION);
+}
+
+bool IsCompressedLog(std::string_view data)
+{
+    return data.size() >= COMPRESSED_LOG_MAGIC.size() &&
+           std::equal(COMPRESSED_LOG_MAGIC.begin(), COMPRESSED_LOG_MAGIC.end(), data.begin());
+}
+
+LogCompressor::LogCompressor() : hashTable(size_t(1) << HASH_BITS) {}
+
+void LogCompressor::CompressBlock(std::string_view input, LogArena& out)
+{
+    const size_t headerOffset = out.Size();
+    AppendLE32(out, 0);  // stored size, filled in at the end
+    AppendLE32(out, static_cast<uint32_t>(input.size()));
+    const size_t payloadOffset = out.Size();
+
+    // entries are position + 1, so 0 means empty; blocks are compressed independently
+    std::fill(hashTable.begin(), hashTable.end(), 0);
+
+    const char* data = input.data();
+    size_t anchor = 0;  // start of the literals not yet written
+    size_t position = 0;
+
+    if (input.size() > LAST_LITERALS + MIN_MATCH_LENGTH)
+    {
+        const size_t matchLimit = input.size() - LAST_LITERALS;
+        while (position + MIN_MATCH_LENGTH <= matchLimit)
+        {
+            uint32_t& entry = hashTable[HashSequence(data + position)];
+            const size_t candidate = entry;
+            entry = static_cast<uint32_t>(position + 1);
+
+            if (candidate == 0 || position - (candidate - 1) > MAX_MATCH_OFFSET ||
+                std::memcmp(data + candidate - 1, data + position, MIN_MATCH_LENGTH) != 0)
+            {
+                // step faster through data that doesn't compress
+                position += 1 + ((position - anchor) >> 6);
+                continue;
+            }
+
+            size_t matchStart = candidate - 1;
+            size_t length = MIN_MATCH_LENGTH;
+            while (position + length < matchLimit &&
+                   data[matchStart + length] == data[position + length])
+                length++;
+
+            // matches often start a little before the spot that was hashed
+            while (position > anchor && matchStart > 0 &&
+                   data[position - 1] == data[matchStart - 1])
+            {
+                position--;
+                matchStart--;
+                length++;
+            }
+
+            AppendSequence(out, input.substr(anchor, position - anchor), position - matchStart,
+                           length);
+            position += length;
+            anchor = position;
+        }
+    }
+
+    AppendSequence(out, input.substr(anchor), 0, 0);
+
+    const size_t compressedSize = out.Size() - payloadOffset;
+    if (compressedSize >= input.size())
+    {
+        out.Truncate(payloadOffset);
+        out.Append(input);
+        PatchLE32(out, headerOffset, static_cast<uint32_t>(input.size()) | STORED_BLOCK_FLAG);
+    }
+    else
+    {
+        PatchLE32(out, headerOffset, static_cast<uint32_t>(compressedSize));
+    }
+}
+
+bool DecompressBlock(std::string_view stored, bool isStored, uint32_t rawSize, std::string& out)
+{
+    if (isStored)
+    {
+        if (stored.size() != rawSize)
+            return false;
+        out.assign(stored);
+        return true;
+    }
+
+    out.resize(rawSize);
+    char* destination = out.data();
+    size_t written = 0;
+    size_t offset = 0;
+
+    while (offset < stored.size())
+    {
+        const uint8_t token = static_cast<uint8_t>(stored[offset++]);
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !ReadExtraCount(stored, offset, literalCount))
+            return false;
+        if (literalCount > stored.size() - offset || literalCount > rawSize - written)
+            return false;
+
+        std::memcpy(destination + written, stored.data() + offset, literalCount);
+        offset += literalCount;
+        written += literalCount;
+
+        // the last sequence has no match
+        if (offset == stored.size())
+            return written == rawSize;
+
+        if (stored.size() - offset < 2)
+            return false;
+        const size_t matchOffset = static_cast<uint8_t>(stored[offset]) |
+                                   static_cast<size_t>(static_cast<uint8_t>(stored[offset + 1]))
+                                       << 8;
+        offset += 2;
+
+        size_t matchLength = token & 0x0F;
+        if (matchLength == 15 && !ReadExtraCount(stored, offset, matchLength))
+            return false;
+        matchLength += MIN_MATCH_LENGTH;
+
+        if (matchOffset == 0 || matchOffset > written || matchLength > rawSize - written)
+            return false;
+
+        const char* source = destination + written - matchOffset;
+        if (matchOffset >= matchLength)
+        {
+            std::memcpy(destination + written, source, matchLength);
+        }
+        else
+        {
+            // overlapping match, i.e. a repeating pattern: has to go byte by byte
+            for (size_t i = 0; i < matchLength; i++)
+                destination[written + i] = source[i];
+        }
+        written += matchLength;
+    }
+
+    return false;  // a block always ends with a literal-only sequence
+}
+
+CompressedLogReader::CompressedLogReader(std::istream& stream) : stream(stream), hasError(false) {}
+
+bool CompressedLogReader::ReadHeader()
+{
+    char header[COMPRESSED_LOG_HEADER_SIZE];
+    if (!stream.read(header, sizeof(header)) ||
+        !IsCompressedLog(std::string_view(header, sizeof(header))) ||
+        ReadLE32(header + COMPRESSED_LOG_MAGIC.size()) != COMPRESSED_LOG_VERSION)
+    {
+        hasError = true;
+        return false;
+    }
+    return true;
+}
+
+bool CompressedLogReader::NextBlock(std::string_view& data)
+{
+    if (hasError)
+        return false;
+
+    char header[COMPRESSED_BLOCK_HEADER_SIZE];
+    stream.read(header, sizeof(header));
+    if (stream.gcount() == 0)
+        return false;  // clean end of file
+    if (stream.gcount() != sizeof(header))
+    {
+        hasError = true;
+        return false;
+    }
+
+    const uint32_t storedField = ReadLE32(header);
+    const uint32_t storedSize = storedField & ~STORED_BLOCK_FLAG;
+    const uint32_t rawSize = ReadLE32(header + 4);
+    if (storedSize > MAX_COMPRESSED_BLOCK_SIZE || rawSize > MAX_COMPRESSED_BLOCK_SIZE)
+    {
+        hasError = true;
+        return false;
+    }
+
+    stored.resize(storedSize);
+    if (!stream.read(stored.data(), stored.size()) ||
+        !DecompressBlock(stored, (storedField & STORED_BLOCK_FLAG) != 0, rawSize, block))
+    {
+        hasError = true;
+        return false;
+    }
+
+    data = block;
+    return true;
+}
+
+DecompressingStreamBuf::DecompressingStreamBuf(std::istream& compressed)
+    : reader(compressed), isHeaderValid(false)
+{
+    isHeaderValid = reader.ReadHeader();
+}
+
+DecompressingStreamBuf::int_type DecompressingStreamBuf::underflow()
+{
+    if (gptr() < egptr())
+        return traits_type::to_int_type(*gptr());
+
+    std::string_view data;
+    do
+    {
+        if (!isHeaderValid || !reader.NextBlock(data))
+            return traits_type::eof();
+    } while (data.empty());
+
+    char* begin = const_cast<char*>(data.data());
+    setg(begin, begin, begin + data.size());
+    return traits_type::to_int_type(*gptr());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+void AppendLE32(LogArena& out, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+void PatchLE32(LogArena& out, size_t offset, uint32_t value)
+{
+    for (int i = 0; i < 4; i++)
+        out.Data()[offset + i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+uint32_t ReadLE32(const char* data)
+{
+    uint32_t value = 0;
+    for (int i = 0; i < 4; i++)
+        value |= static_cast<uint32_t>(static_cast<uint8_t>(data[i])) << (8 * i);
+    return value;
+}
+
+uint32_t HashSequence(const char* data)
+{
+    uint32_t sequence;
+    std::memcpy(&sequence, data, sizeof(sequence));
+    return (sequence * 2654435761u) >> (32 - HASH_BITS);
+}
+
+void AppendExtraCount(LogArena& out, size_t count)
+{
+    while (count >= 255)
+    {
+        out += static_cast<char>(255);
+        count -= 255;
+    }
+    out += static_cast<char>(count);
+}
+
+bool ReadExtraCount(std::string_view stored, size_t& offset, size_t& count)
+{
+    while (true)
+    {
+        if (offset >= stored.size() || count > MAX_COMPRESSED_BLOCK_SIZE)
+            return false;
+
+        const uint8_t byte = static_cast<uint8_t>(stored[offset++]);
+        count += byte;
+        if (byte != 255)
+            return true;
+    }
+}
+
+void AppendSequence(LogArena& out, std::string_view literals, size_t matchOffset,
+                    size_t matchLength)
+{
+    const size_t literalCount = literals.size();
+    const size_t matchCode = matchLength == 0 ? 0 : matchLength - MIN_MATCH_LENGTH;
+
+    out += static_cast<char>((std::min<size_t>(literalCount, 15) << 4) |
+                             std::min<size_t>(matchCode, 15));
+    if (literalCount >= 15)
+        AppendExtraCount(out, literalCount - 15);
+    out.Append(literals);
+
+    if (matchLength == 0)
+        return;
+
+    out += static_cast<char>(matchOffset & 0xFF);
+    out += static_cast<char>(matchOffset >> 8);
+    if (matchCode >= 15)
+        AppendExtraCount(out, matchCode - 15);
+}
+
+}  // namespace Logging
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <streambuf>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LogArena.hpp"
+
+namespace Logging
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Compressed log format
+///////////////////////////////////////////////////////////////////////////////
+//
+// File:  magic "HGLZ" | u32 version (little endian) | block...
+// Block: u32 stored size | u32 raw size | stored bytes
+//
+// One block per writer flush. Decompressing every block in order gives back exactly the bytes
+// an uncompressed logger would have written (text lines, or a binary log including its header).
+// If the high bit of the stored size is set, the block was incompressible and is stored as-is.
+//
+// Compressed blocks are a sequence of LZ77 sequences:
+//   u8 token: high nibble = literal count, low nibble = match length - MIN_MATCH_LENGTH
+//   if either nibble is 15, the count continues in extra bytes (255 = keep adding)
+//   literal bytes
+//   u16 match offset (little endian, 1 to 65535 bytes back), followed by the extra match bytes
+// The last sequence of a block only has literals, and ends the block.
+
+constexpr std::array<char, 4> COMPRESSED_LOG_MAGIC = {'H', 'G', 'L', 'Z'};
+constexpr uint32_t COMPRESSED_LOG_VERSION = 1;
+constexpr size_t COMPRESSED_LOG_HEADER_SIZE = 8;
+constexpr size_t COMPRESSED_BLOCK_HEADER_SIZE = 8;
+constexpr uint32_t STORED_BLOCK_FLAG = 0x80000000;
+
+/// @brief Sanity limit for readers. A writer flush is nowhere near this big.
+constexpr uint32_t MAX_COMPRESSED_BLOCK_SIZE = 64 * 1024 * 1024;
+
+void AppendCompressedLogHeader(LogArena& out);
+
+/// @brief Does this data start with a compressed log header?
+bool IsCompressedLog(std::string_view data);
+
+/// @brief Dependency-free LZ77 block compressor, tuned for speed over ratio.
+///        Keeps its match table between calls, so compressing a block never allocates
+///        beyond what the output arena needs.
+/// @remark Not thread safe: the logger's writer thread owns one.
+class LogCompressor
+{
+   public:
+    LogCompressor();
+
+    /// @brief Appends input as one block (header included) to out.
+    void CompressBlock(std::string_view input, LogArena& out);
+
+   private:
+    std::vector<uint32_t> hashTable;
+};
+
+/// @brief Decompresses one block's stored bytes.
+/// @return false if the block is malformed or does not decompress to exactly rawSize bytes.
+bool DecompressBlock(std::string_view stored, bool isStored, uint32_t rawSize, std::string& out);
+
+/// @brief Streams a compressed log one block at a time.
+class CompressedLogReader
+{
+   public:
+    CompressedLogReader(std::istream& stream);
+
+    /// @brief Reads and validates the file header. Must be called before NextBlock.
+    bool ReadHeader();
+
+    /// @brief Decompresses the next block.
+    /// @param data Set to the decompressed block; valid until the next call.
+    /// @return false at the end of the stream, or if the block was truncated or malformed
+    ///         (check HasError() to tell the two apart).
+    bool NextBlock(std::string_view& data);
+
+    bool HasError() const { return hasError; }
+
+   private:
+    std::istream& stream;
+    std::string stored;
+    std::string block;
+    bool hasError;
+};
+
+/// @brief Presents a compressed log as a plain byte stream, so anything that reads logs from a
+///        std::istream (BinaryLogReader, std::getline, ...) can read compressed logs unchanged:
+///            DecompressingStreamBuf buffer(file);
+///            std::istream stream(&buffer);
+///        Only one block is held in memory at a time.
+class DecompressingStreamBuf : public std::streambuf
+{
+   public:
+    DecompressingStreamBuf(std::istream& compressed);
+
+    /// @brief True if the header was valid and no block has failed to decompress.
+    bool IsValid() const { return isHeaderValid && !reader.HasError(); }
+
+   protected:
+    int_type underflow() override;
+
+   private:
+    CompressedLogReader reader;
+    bool isHeaderValid;
+};
+
+}  // namespace Logging
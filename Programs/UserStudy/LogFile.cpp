@@ -0,0 +1,140 @@
+#include "LogFile.hpp"
+
+#include <algorithm>
+#include <vector>
+
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <cerrno>
+#include <climits>
+#include <fcntl.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace Logging
+{
+
+#ifdef _WIN32
+
+LogFile::LogFile() : m_handle(INVALID_HANDLE_VALUE) {}
+
+LogFile::~LogFile() { Close(); }
+
+bool LogFile::Open(const std::string& filename, bool truncate)
+{
+    Close();
+
+    // FILE_SHARE_READ so the log can be inspected while the study is running
+    m_handle = CreateFileA(filename.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr,
+                           truncate ? CREATE_ALWAYS : OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_handle == INVALID_HANDLE_VALUE)
+        return false;
+
+    LARGE_INTEGER zero{};
+    SetFilePointerEx(m_handle, zero, nullptr, FILE_END);
+    return true;
+}
+
+void LogFile::Close()
+{
+    if (m_handle != INVALID_HANDLE_VALUE)
+        CloseHandle(m_handle);
+    m_handle = INVALID_HANDLE_VALUE;
+}
+
+bool LogFile::IsOpen() const { return m_handle != INVALID_HANDLE_VALUE; }
+
+bool LogFile::Write(std::span<const std::string_view> buffers)
+{
+    // WriteFileGather only works on unbuffered, page-aligned I/O, so write buffers one by one
+    for (std::string_view buffer : buffers)
+    {
+        while (!buffer.empty())
+        {
+            DWORD toWrite = static_cast<DWORD>(std::min<size_t>(buffer.size(), MAXDWORD));
+            DWORD written = 0;
+            if (!WriteFile(m_handle, buffer.data(), toWrite, &written, nullptr))
+                return false;
+            buffer.remove_prefix(written);
+        }
+    }
+    return true;
+}
+
+bool LogFile::Sync() { return FlushFileBuffers(m_handle) != 0; }
+
+#else
+
+LogFile::LogFile() : m_fd(-1) {}
+
+LogFile::~LogFile() { Close(); }
+
+bool LogFile::Open(const std::string& filename, bool truncate)
+{
+    Close();
+
+    int flags = O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC;
+    if (truncate)
+        flags |= O_TRUNC;
+    m_fd = ::open(filename.c_str(), flags, 0644);
+    return m_fd >= 0;
+}
+
+void LogFile::Close()
+{
+    if (m_fd >= 0)
+        ::close(m_fd);
+    m_fd = -1;
+}
+
+bool LogFile::IsOpen() const { return m_fd >= 0; }
+
+bool LogFile::Write(std::span<const std::string_view> buffers)
+{
+    std::vector<iovec> iovecs;
+    iovecs.reserve(buffers.size());
+    for (std::string_view buffer : buffers)
+    {
+        if (!buffer.empty())
+            iovecs.push_back(iovec{const_cast<char*>(buffer.data()), buffer.size()});
+    }
+
+    size_t first = 0;
+    while (first < iovecs.size())
+    {
+        const int count = static_cast<int>(std::min<size_t>(iovecs.size() - first, IOV_MAX));
+        ssize_t written = ::writev(m_fd, iovecs.data() + first, count);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+
+        // skip over everything that made it out, then resume mid-buffer if the write was short
+        size_t remaining = static_cast<size_t>(written);
+        while (first < iovecs.size() && remaining >= iovecs[first].iov_len)
+            remaining -= iovecs[first++].iov_len;
+        if (remaining > 0)
+        {
+            iovecs[first].iov_base = static_cast<char*>(iovecs[first].iov_base) + remaining;
+            iovecs[first].iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+bool LogFile::Sync()
+{
+#ifdef __APPLE__
+    return ::fsync(m_fd) == 0;
+#else
+    return ::fdatasync(m_fd) == 0;
+#endif
+}
+
+#endif
+
+}  // namespace Logging
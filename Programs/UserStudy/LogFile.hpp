@@ -0,0 +1,42 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace Logging
+{
+
+/// @brief Append-only file that stays open for the lifetime of a log.
+///        Wraps a Win32 HANDLE on Windows and a file descriptor everywhere else.
+/// @remark Not thread safe: only the logger's writer thread uses it.
+class LogFile
+{
+   public:
+    LogFile();
+    ~LogFile();
+
+    LogFile(const LogFile&) = delete;
+    LogFile& operator=(const LogFile&) = delete;
+
+    /// @brief Opens (and by default truncates) the file. Closes any previously open file first.
+    bool Open(const std::string& filename, bool truncate = true);
+    void Close();
+    bool IsOpen() const;
+
+    /// @brief Writes every buffer, in order, as one gathered write where the OS supports it
+    ///        (writev on POSIX). Partial writes are retried until everything is written.
+    bool Write(std::span<const std::string_view> buffers);
+
+    /// @brief Forces written data to stable storage (fdatasync / FlushFileBuffers).
+    bool Sync();
+
+   private:
+#ifdef _WIN32
+    void* m_handle;
+#else
+    int m_fd;
+#endif
+};
+
+}  // namespace Logging
@@ -0,0 +1,276 @@
+#include "LogManifest.hpp"
+
+#include <Helpers/Crc32.hpp>
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace Logging
+{
+
+namespace fs = std::filesystem;
+
+///////////////////////////////////////////////////////////////////////////////
+// Forward declarations for helper functions
+///////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void AppendLittleEndian(LogArena& out, T value);
+
+template <typename T>
+T ReadLittleEndian(const char* data);
+
+bool IsFlushIntact(std::ifstream& log, const ManifestRecord& record, std::string& buffer);
+bool AppendCloseMarker(const std::string& manifestFilename, uint64_t logSize);
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of manifest functions
+///////////////////////////////////////////////////////////////////////////////
+std::string GetManifestFilename(const std::string& logFilename)
+{
+    return logFilename + ".manifest";
+}
+
+void AppendManifestHeader(LogArena& out)
+{
+    out.append(LOG_MANIFEST_MAGIC.data(), LOG_MANIFEST_MAGIC.size());
+    AppendLittleEndian<uint32_t>(out, LOG_MANIFEST_VERSION);
+}
+
+void AppendManifestRecord(LogArena& out, const ManifestRecord& record)
+{
+    const size_t recordOffset = out.Size();
+    AppendLittleEndian<uint32_t>(out, record.segment);
+    AppendLittleEndian<uint32_t>(out, record.eventCount);
+    AppendLittleEndian<uint64_t>(out, record.startOffset);
+    AppendLittleEndian<uint64_t>(out, record.endOffset);
+    AppendLittleEndian<uint64_t>(out, record.firstTimestampMillis);
+    AppendLittleEndian<uint64_t>(out, record.lastTimestampMillis);
+    AppendLittleEndian<uint32_t>(out, record.dataCrc);
+
+    const std::string_view fields = out.View().substr(recordOffset);
+    AppendLittleEndian<uint32_t>(out, Helpers::Crc32(fields));
+}
+
+bool ParseManifestRecord(std::string_view bytes, ManifestRecord& record)
+{
+    if (bytes.size() < MANIFEST_RECORD_SIZE)
+        return false;
+
+    const char* data = bytes.data();
+    const size_t crcOffset = MANIFEST_RECORD_SIZE - sizeof(uint32_t);
+    if (Helpers::Crc32(bytes.substr(0, crcOffset)) != ReadLittleEndian<uint32_t>(data + crcOffset))
+        return false;
+
+    record.segment = ReadLittleEndian<uint32_t>(data);
+    record.eventCount = ReadLittleEndian<uint32_t>(data + 4);
+    record.startOffset = ReadLittleEndian<uint64_t>(data + 8);
+    record.endOffset = ReadLittleEndian<uint64_t>(data + 16);
+    record.firstTimestampMillis = ReadLittleEndian<uint64_t>(data + 24);
+    record.lastTimestampMillis = ReadLittleEndian<uint64_t>(data + 32);
+    record.dataCrc = ReadLittleEndian<uint32_t>(data + 40);
+    return true;
+}
+
+RecoveryReport RecoverLog(const std::string& logFilename, RecoveryMode mode)
+{
+    RecoveryReport report{};
+    const std::string manifestFilename = GetManifestFilename(logFilename);
+
+    std::error_code error;
+    if (!fs::exists(manifestFilename, error))
+    {
+        report.error = "the log has no manifest";
+        return report;
+    }
+    report.hasManifest = true;
+
+    report.originalSize = fs::file_size(logFilename, error);
+    if (error)
+    {
+        report.error = std::format("unable to read the log file ({})", error.message());
+        return report;
+    }
+
+    // the manifest is tiny next to the log (one record per flush), so read all of it at once
+    std::ifstream manifest(manifestFilename, std::ios::binary);
+    const std::string contents((std::istreambuf_iterator<char>(manifest)),
+                               std::istreambuf_iterator<char>());
+    manifest.close();
+
+    if (contents.size() < LOG_MANIFEST_HEADER_SIZE ||
+        !std::equal(LOG_MANIFEST_MAGIC.begin(), LOG_MANIFEST_MAGIC.end(), contents.begin()) ||
+        ReadLittleEndian<uint32_t>(contents.data() + LOG_MANIFEST_MAGIC.size()) !=
+            LOG_MANIFEST_VERSION)
+    {
+        report.error = "the manifest header is missing or unsupported";
+        return report;
+    }
+
+    // keep records up to the first torn one, or the first that doesn't match the log
+    std::vector<ManifestRecord> records;
+    bool hasCloseMarker = false;
+    uint64_t expectedOffset = 0;
+    size_t manifestOffset = LOG_MANIFEST_HEADER_SIZE;
+    for (; manifestOffset + MANIFEST_RECORD_SIZE <= contents.size();
+         manifestOffset += MANIFEST_RECORD_SIZE)
+    {
+        ManifestRecord record;
+        if (!ParseManifestRecord(std::string_view(contents).substr(manifestOffset), record) ||
+            record.startOffset != expectedOffset || record.endOffset < record.startOffset ||
+            record.endOffset > report.originalSize)
+            break;
+
+        if (record.segment == MANIFEST_CLOSE_SEGMENT)
+        {
+            hasCloseMarker = true;
+            manifestOffset += MANIFEST_RECORD_SIZE;
+            break;
+        }
+
+        records.push_back(record);
+        expectedOffset = record.endOffset;
+    }
+
+    const bool isConsistent = hasCloseMarker && manifestOffset == contents.size() &&
+                              expectedOffset == report.originalSize;
+
+    // Appends only ever tear at the end of the file. After a clean shutdown there is nothing to
+    // check in Tail mode; otherwise walk back from the end until a flush checksums correctly.
+    size_t keptRecords = records.size();
+    std::ifstream log(logFilename, std::ios::binary);
+    std::string buffer;
+    if (mode == RecoveryMode::Full)
+    {
+        keptRecords = 0;
+        while (keptRecords < records.size() && IsFlushIntact(log, records[keptRecords], buffer))
+            keptRecords++;
+    }
+    else if (!isConsistent)
+    {
+        while (keptRecords > 0 && !IsFlushIntact(log, records[keptRecords - 1], buffer))
+            keptRecords--;
+    }
+    log.close();
+
+    report.flushesDropped = records.size() - keptRecords;
+    records.resize(keptRecords);
+    report.recoveredSize = records.empty() ? 0 : records.back().endOffset;
+    report.wasClosedCleanly = isConsistent && report.flushesDropped == 0;
+
+    for (const auto& record : records)
+    {
+        report.eventsRecovered += record.eventCount;
+        if (report.segments.empty() || report.segments.back().segment != record.segment)
+            report.segments.push_back({record.segment, 0, record.firstTimestampMillis, 0});
+
+        SegmentSummary& summary = report.segments.back();
+        summary.eventCount += record.eventCount;
+        if (record.eventCount > 0)
+            summary.lastTimestampMillis = record.lastTimestampMillis;
+    }
+
+    if (report.wasClosedCleanly)
+        return report;
+
+    // cut the torn tail off both files, then mark the log closed so the next startup skips it
+    if (report.recoveredSize != report.originalSize)
+    {
+        fs::resize_file(logFilename, report.recoveredSize, error);
+        if (error)
+        {
+            report.error = std::format("unable to truncate the log ({})", error.message());
+            return report;
+        }
+        report.wasTruncated = true;
+    }
+
+    fs::resize_file(manifestFilename, LOG_MANIFEST_HEADER_SIZE + keptRecords * MANIFEST_RECORD_SIZE,
+                    error);
+    if (error || !AppendCloseMarker(manifestFilename, report.recoveredSize))
+        report.error = "unable to rewrite the manifest";
+
+    return report;
+}
+
+void RecoverLogDirectory(const std::string& directory, RecoveryMode mode)
+{
+    std::error_code error;
+    for (const auto& entry : fs::directory_iterator(directory, error))
+    {
+        if (!entry.is_regular_file() || entry.path().extension() != ".log")
+            continue;
+
+        const std::string logFilename = entry.path().string();
+        if (!fs::exists(GetManifestFilename(logFilename)))
+            continue;
+
+        RecoveryReport report = RecoverLog(logFilename, mode);
+        if (!report.error.empty())
+        {
+            std::cout << std::format("[Log Recovery] Unable to recover {}: {}.\n", logFilename,
+                                     report.error);
+            continue;
+        }
+
+        if (report.wasClosedCleanly)
+            continue;
+
+        std::cout << std::format(
+            "[Log Recovery] {} was not closed cleanly.\n"
+            "    Kept {} events ({} of {} bytes), dropped {} unfinished flushes.\n",
+            logFilename, report.eventsRecovered, report.recoveredSize, report.originalSize,
+            report.flushesDropped);
+
+        for (const auto& segment : report.segments)
+        {
+            std::cout << std::format("    Task segment {}: {} events, timestamps {} to {}\n",
+                                     segment.segment, segment.eventCount,
+                                     segment.firstTimestampMillis, segment.lastTimestampMillis);
+        }
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void AppendLittleEndian(LogArena& out, T value)
+{
+    for (size_t i = 0; i < sizeof(T); i++)
+        out += static_cast<char>((value >> (8 * i)) & 0xFF);
+}
+
+template <typename T>
+T ReadLittleEndian(const char* data)
+{
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); i++)
+        value |= static_cast<T>(static_cast<uint8_t>(data[i])) << (8 * i);
+    return value;
+}
+
+bool IsFlushIntact(std::ifstream& log, const ManifestRecord& record, std::string& buffer)
+{
+    buffer.resize(record.endOffset - record.startOffset);
+    log.clear();
+    log.seekg(static_cast<std::streamoff>(record.startOffset));
+    if (!log.read(buffer.data(), static_cast<std::streamsize>(buffer.size())))
+        return false;
+
+    return Helpers::Crc32(buffer) == record.dataCrc;
+}
+
+bool AppendCloseMarker(const std::string& manifestFilename, uint64_t logSize)
+{
+    LogArena marker(MANIFEST_RECORD_SIZE);
+    AppendManifestRecord(marker, {MANIFEST_CLOSE_SEGMENT, 0, logSize, logSize, 0, 0, 0});
+
+    std::ofstream manifest(manifestFilename, std::ios::binary | std::ios::app);
+    manifest.write(marker.Data(), static_cast<std::streamsize>(marker.Size()));
+    return static_cast<bool>(manifest);
+}
+
+}  // namespace Logging
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "LogArena.hpp"
+
+namespace Logging
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// Log manifest format
+///////////////////////////////////////////////////////////////////////////////
+//
+// Every log file "X" gets a manifest "X.manifest" next to it:
+//
+// File:   magic "HGLM" | u32 version (little endian) | record...
+// Record: u32 segment | u32 event count | u64 start offset | u64 end offset |
+//         u64 first timestamp | u64 last timestamp | u32 data CRC | u32 record CRC
+//
+// The writer thread appends one record per flush, after the flushed bytes have been written,
+// so records describe contiguous, gap-free byte ranges of the log.
+// A segment is one task: the writer always flushes after a TaskCompletion event and then starts
+// the next segment, so a flush never spans two tasks.
+// The data CRC covers the log bytes [start offset, end offset), the record CRC covers the
+// 44 bytes before it. A record with segment MANIFEST_CLOSE_SEGMENT marks a clean shutdown.
+
+constexpr std::array<char, 4> LOG_MANIFEST_MAGIC = {'H', 'G', 'L', 'M'};
+constexpr uint32_t LOG_MANIFEST_VERSION = 1;
+constexpr size_t LOG_MANIFEST_HEADER_SIZE = 8;
+constexpr size_t MANIFEST_RECORD_SIZE = 48;
+constexpr uint32_t MANIFEST_CLOSE_SEGMENT = 0xFFFFFFFF;
+
+struct ManifestRecord
+{
+    uint32_t segment;
+    uint32_t eventCount;
+    uint64_t startOffset;
+    uint64_t endOffset;
+    uint64_t firstTimestampMillis;
+    uint64_t lastTimestampMillis;
+    uint32_t dataCrc;
+};
+
+std::string GetManifestFilename(const std::string& logFilename);
+
+void AppendManifestHeader(LogArena& out);
+void AppendManifestRecord(LogArena& out, const ManifestRecord& record);
+
+/// @brief Decodes one MANIFEST_RECORD_SIZE byte record.
+/// @return false if the record is short or its checksum does not match.
+bool ParseManifestRecord(std::string_view bytes, ManifestRecord& record);
+
+///////////////////////////////////////////////////////////////////////////////
+// Startup recovery
+///////////////////////////////////////////////////////////////////////////////
+
+enum class RecoveryMode
+{
+    Tail,  // trust the manifest, only checksum the flushes at the end of an unclean log
+    Full   // checksum every flush
+};
+
+struct SegmentSummary
+{
+    uint32_t segment;
+    uint64_t eventCount;
+    uint64_t firstTimestampMillis;
+    uint64_t lastTimestampMillis;
+};
+
+struct RecoveryReport
+{
+    bool hasManifest;
+    bool wasClosedCleanly;
+    bool wasTruncated;
+    uint64_t originalSize;
+    uint64_t recoveredSize;
+    uint64_t eventsRecovered;
+    uint64_t flushesDropped;
+    std::vector<SegmentSummary> segments;  // what survived, in logging order
+    std::string error;
+};
+
+/// @brief Validates a log against its manifest and truncates the log (and manifest)
+///        to the last flush that is fully on disk.
+///        Only the manifest and at most a few flushes at the end of the log are read,
+///        so this stays fast no matter how large the log is.
+RecoveryReport RecoverLog(const std::string& logFilename, RecoveryMode mode = RecoveryMode::Tail);
+
+/// @brief Runs RecoverLog on every log with a manifest in the directory
+///        and prints a report for each log that was not closed cleanly.
+void RecoverLogDirectory(const std::string& directory, RecoveryMode mode = RecoveryMode::Tail);
+
+}  // namespace Logging
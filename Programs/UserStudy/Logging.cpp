@@ -1,11 +1,18 @@
 #include "Logging.hpp"
 
+#include "BinaryLog.hpp"
+#include "LogCompression.hpp"
+
+#include <Helpers/Clock.hpp>
+#include <Helpers/Crc32.hpp>
+#include <Helpers/SPSCQueue.hpp>
+#include <algorithm>
 #include <array>
+#include <charconv>
+#include <cstring>
 #include <format>
 #include <iostream>
-#include <sstream>
 #include <string>
-#include <Windows.h>
 
 namespace Logging
 {
@@ -14,149 +21,681 @@ namespace Logging
 // Forward declarations for helper functions
 ///////////////////////////////////////////////////////////////////////////////
 template <Loggable T>
-consteval std::string_view EventTypeToString();
+void SerializeEvent(const EventRecord& record, LogArena& arena);
+template <Loggable T>
+bool ParseEvent(std::string_view fields, EventRecord& record);
+
+template <std::integral T>
+bool ParseInteger(std::string_view text, T& value);
+bool ParseBool(std::string_view text, bool& value);
 
-std::string ClickLocationToString(Events::ClickLocation loc);
+// source of Logger::id
+std::atomic<uint64_t> nextLoggerId{1};
 
 ///////////////////////////////////////////////////////////////////////////////
 // Implementations of class methods
 ///////////////////////////////////////////////////////////////////////////////
-Logger::Logger() : hasFilename(false), currBuffer(0), currIndex(0), isFileInitialized(false) {}
+/// @brief One producer thread's events. Only the owner pushes and only the writer thread pops.
+struct Logger::Lane
+{
+    Lane(size_t capacity, std::thread::id owner)
+        : queue(capacity),
+          owner(owner),
+          highWaterMark(0),
+          eventsLogged(0),
+          eventsDropped(0),
+          eventsBlocked(0)
+    {
+    }
+
+    Helpers::SPSCQueue<EventRecord> queue;
+    const std::thread::id owner;
+
+    // one writer each (the owner), so they are stored rather than incremented atomically
+    std::atomic<size_t> highWaterMark;
+    std::atomic<uint64_t> eventsLogged;
+    std::atomic<uint64_t> eventsDropped;
+    std::atomic<uint64_t> eventsBlocked;
+};
+
+Logger::Logger(const LoggerConfig& config)
+    : hasFilename(false),
+      config(config),
+      id(nextLoggerId.fetch_add(1)),
+      numLanes(0),
+      sharedLane(std::make_unique<Lane>(config.queueCapacity, std::thread::id())),
+      flushCount(0),
+      syncCount(0),
+      writeErrors(0),
+      lastFlushMicros(0),
+      maxFlushMicros(0),
+      totalFlushMicros(0),
+      bytesSerialized(0),
+      bytesWritten(0),
+      eventsLate(0),
+      reorderHighWaterMark(0),
+      nextArrival(0),
+      lastWrittenTimestamp(0),
+      compressedArena(config.compress ? DEFAULT_ARENA_CAPACITY : 0),
+      manifestArena(MANIFEST_RECORD_SIZE * 4),
+      fileOffset(0),
+      pendingFlush{},
+      isSyncPending(false),
+      binaryEncoder(std::make_unique<BinaryBatchEncoder>()),
+      compressor(std::make_unique<LogCompressor>()),
+      stopWriter(false)
+{
+}
 
-Logger::Logger(std::string filename)
-    : logFilename(filename),
-      hasFilename(true),
-      currBuffer(0),
-      currIndex(0),
-      isFileInitialized(false)
+Logger::Logger(std::string filename, const LoggerConfig& config) : Logger(config)
 {
+    OpenLogFile(filename);
 }
 
 Logger::~Logger()
 {
-    auto openMode = isFileInitialized ? std::ios::app : std::ios::trunc;
-    // currIndex points to the next line to write, not the most recent line
-    std::ofstream outFile(logFilename, openMode);
-    for (int i = 0; i < currIndex; i++)
-        outFile << logDoubleBuffer[currBuffer][i] << "\n";
+    // the writer drains everything that is still queued before it exits
+    StopWriter();
 
-    std::cout << std::format("[Event Logging] Closing log file {} and writing it to disk.\n",
-                             logFilename);
+    LoggerStats stats = GetStats();
+    std::cout << std::format(
+        "[Event Logging] Closing log file {} and writing it to disk.\n"
+        "    Events logged: {}\n"
+        "    Events dropped: {}\n"
+        "    Events that blocked on a full queue: {}\n"
+        "    Events written out of order: {}\n"
+        "    Lanes: {}, lane high-water mark: {}/{}, reorder high-water mark: {}\n"
+        "    Flushes: {} (mean {}us, max {}us), syncs: {}, write errors: {}\n"
+        "    Bytes written: {} ({} before compression)\n",
+        logFilename, stats.eventsLogged, stats.eventsDropped, stats.eventsBlocked, stats.eventsLate,
+        stats.numLanes, stats.highWaterMark, stats.capacity, stats.reorderHighWaterMark,
+        stats.flushCount,
+        stats.flushCount > 0 ? stats.totalFlushMicros / stats.flushCount : 0, stats.maxFlushMicros,
+        stats.syncCount, stats.writeErrors, stats.bytesWritten, stats.bytesSerialized);
 }
 
 void Logger::OpenLogFile(const std::string& filename)
 {
+    // anything queued for the previous file goes to the previous file
+    StopWriter();
+
     logFilename = filename;
     hasFilename = true;
+
+    StartWriter();
 }
 
-///////////////////////////////////////////////////////////////////////////////
-// Implementations of helper functions
-///////////////////////////////////////////////////////////////////////////////
-uint64_t GetCurrentUnixTimeMillis()
+LoggerStats Logger::GetStats() const
 {
-    // Number of milliseconds between the "Windows epoch"
-    // (Jan 1, 1601 00:00) and the Unix epoch (Jan 1, 1970 00:00).
-    static constexpr uint64_t windowsEpochToUnixEpochMillis = 11644473600000;
+    LoggerStats stats{};
+    stats.capacity = sharedLane->queue.Capacity();
+    stats.numLanes = numLanes.load(std::memory_order_acquire);
 
-    FILETIME filetime;
-    GetSystemTimeAsFileTime(&filetime);
+    auto addLane = [&stats](const Lane& lane)
+    {
+        stats.queueDepth = std::max(stats.queueDepth, lane.queue.Size());
+        stats.highWaterMark =
+            std::max(stats.highWaterMark, lane.highWaterMark.load(std::memory_order_relaxed));
+        stats.eventsLogged += lane.eventsLogged.load(std::memory_order_relaxed);
+        stats.eventsDropped += lane.eventsDropped.load(std::memory_order_relaxed);
+        stats.eventsBlocked += lane.eventsBlocked.load(std::memory_order_relaxed);
+    };
+    for (size_t i = 0; i < stats.numLanes; i++)
+        addLane(*lanes[i]);
+    addLane(*sharedLane);
 
-    ULARGE_INTEGER qwFiletime;
-    qwFiletime.LowPart = filetime.dwLowDateTime;
-    qwFiletime.HighPart = filetime.dwHighDateTime;
+    stats.eventsLate = eventsLate.load(std::memory_order_relaxed);
+    stats.reorderHighWaterMark = reorderHighWaterMark.load(std::memory_order_relaxed);
+    stats.flushCount = flushCount.load(std::memory_order_relaxed);
+    stats.syncCount = syncCount.load(std::memory_order_relaxed);
+    stats.writeErrors = writeErrors.load(std::memory_order_relaxed);
+    stats.lastFlushMicros = lastFlushMicros.load(std::memory_order_relaxed);
+    stats.maxFlushMicros = maxFlushMicros.load(std::memory_order_relaxed);
+    stats.totalFlushMicros = totalFlushMicros.load(std::memory_order_relaxed);
+    stats.bytesSerialized = bytesSerialized.load(std::memory_order_relaxed);
+    stats.bytesWritten = bytesWritten.load(std::memory_order_relaxed);
+    return stats;
+}
 
-    const uint64_t timeSince1601_100ns = static_cast<uint64_t>(qwFiletime.QuadPart);
-    const uint64_t timeSince1601_ms = timeSince1601_100ns / 10000;
-    return timeSince1601_ms - windowsEpochToUnixEpochMillis;
+bool Logger::ReserveLane()
+{
+    return GetLane() != nullptr;
 }
 
-template <Loggable T>
-consteval std::string_view EventTypeToString()
+bool Logger::Enqueue(const EventRecord& record, bool canWait)
+{
+    if (Lane* lane = GetLane())
+        return PushToLane(*lane, record, canWait);
+
+    // more producer threads than lanes, the rest take turns on the shared one
+    std::lock_guard<std::mutex> lock(sharedLaneMutex);
+    return PushToLane(*sharedLane, record, canWait);
+}
+
+bool Logger::PushToLane(Lane& lane, const EventRecord& record, bool canWait)
+{
+    if (!lane.queue.TryPush(record))
+    {
+        if (!canWait || config.overflowPolicy == OverflowPolicy::Drop)
+        {
+            lane.eventsDropped.store(lane.eventsDropped.load(std::memory_order_relaxed) + 1,
+                                     std::memory_order_relaxed);
+            return false;
+        }
+
+        // the writer thread is behind, wait for it to free up a slot
+        lane.eventsBlocked.store(lane.eventsBlocked.load(std::memory_order_relaxed) + 1,
+                                 std::memory_order_relaxed);
+        do
+            std::this_thread::yield();
+        while (!lane.queue.TryPush(record));
+    }
+
+    lane.eventsLogged.store(lane.eventsLogged.load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+
+    const size_t depth = lane.queue.Size();
+    if (depth > lane.highWaterMark.load(std::memory_order_relaxed))
+        lane.highWaterMark.store(depth, std::memory_order_relaxed);
+    return true;
+}
+
+Logger::Lane* Logger::GetLane()
+{
+    struct CachedLane
+    {
+        uint64_t loggerId;
+        Lane* lane;  // nullptr means the shared lane
+    };
+
+    // A thread rarely logs to more than one logger. Logger ids start at 1 and are never reused,
+    // so empty entries and entries left behind by destroyed loggers never match.
+    thread_local std::array<CachedLane, 4> cache{};
+    thread_local size_t nextEntry = 0;
+
+    for (const CachedLane& entry : cache)
+    {
+        if (entry.loggerId == id)
+            return entry.lane;
+    }
+
+    Lane* lane = RegisterLane();
+    cache[nextEntry] = CachedLane{id, lane};
+    nextEntry = (nextEntry + 1) % cache.size();
+    return lane;
+}
+
+Logger::Lane* Logger::RegisterLane()
+{
+    std::lock_guard<std::mutex> lock(lanesMutex);
+    const std::thread::id self = std::this_thread::get_id();
+    const size_t count = numLanes.load(std::memory_order_relaxed);
+
+    // Lanes are never freed, so a thread that was evicted from the cache finds its lane again.
+    // A new thread that inherits the id of one that exited takes over its lane too, which is
+    // fine since the old owner can no longer push to it.
+    for (size_t i = 0; i < count; i++)
+    {
+        if (lanes[i]->owner == self)
+            return lanes[i].get();
+    }
+
+    if (count == MAX_LANES)
+        return nullptr;
+
+    lanes[count] = std::make_unique<Lane>(config.queueCapacity, self);
+    numLanes.store(count + 1, std::memory_order_release);
+    return lanes[count].get();
+}
+
+void Logger::StartWriter()
+{
+    stopWriter.store(false);
+    writerThread = std::thread(&Logger::WriterLoop, this);
+}
+
+void Logger::StopWriter()
+{
+    if (!writerThread.joinable())
+        return;
+
+    stopWriter.store(true);
+    writerThread.join();
+}
+
+void Logger::WriterLoop()
+{
+    using Clock = std::chrono::steady_clock;
+
+    // one handle for the whole log, closed only when the writer stops
+    if (!file.Open(logFilename))
+    {
+        std::cout << std::format("[Event Logging] Unable to open log file {}.\n", logFilename);
+        writeErrors.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    if (!manifestFile.Open(GetManifestFilename(logFilename)))
+    {
+        std::cout << std::format("[Event Logging] Unable to open the manifest for {}.\n",
+                                 logFilename);
+        writeErrors.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    fileOffset = 0;
+    pendingFlush = ManifestRecord{};
+    AppendManifestHeader(manifestArena);
+
+    if (config.compress)
+        AppendCompressedLogHeader(compressedArena);
+    if (config.format == LogFormat::Binary)
+        AppendBinaryLogHeader(arena);
+
+    // data has to reach the file at least as often as the policy wants it synced
+    const auto flushInterval = config.durability == DurabilityPolicy::Interval
+                                   ? std::min<std::chrono::milliseconds>(FLUSH_INTERVAL,
+                                                                         config.syncInterval)
+                                   : FLUSH_INTERVAL;
+
+    lastFlushTime = Clock::now();
+    Clock::time_point lastSync = lastFlushTime;
+    reorderHeap.clear();
+    lastWrittenTimestamp = 0;
+
+    while (true)
+    {
+        // read the flag before draining so nothing enqueued before the stop request is missed
+        const bool isStopping = stopWriter.load();
+
+        DrainLanes();
+        ReleaseEvents(isStopping);
+
+        if (isStopping)
+            break;
+
+        if (pendingFlush.eventCount > 0 && Clock::now() - lastFlushTime >= flushInterval)
+            FlushWriteBuffer(false);
+
+        if (config.durability == DurabilityPolicy::Interval && isSyncPending &&
+            Clock::now() - lastSync >= config.syncInterval)
+        {
+            FlushWriteBuffer(true);
+            lastSync = Clock::now();
+        }
+
+        std::this_thread::sleep_for(WRITER_IDLE_INTERVAL);
+    }
+
+    FlushWriteBuffer(config.durability != DurabilityPolicy::None);
+
+    // without this marker, startup recovery treats the log as the victim of a crash
+    AppendManifestRecord(manifestArena,
+                         {MANIFEST_CLOSE_SEGMENT, 0, fileOffset, fileOffset, 0, 0, 0});
+    WriteManifest(config.durability != DurabilityPolicy::None);
+
+    file.Close();
+    manifestFile.Close();
+}
+
+bool Logger::IsLater(const PendingEvent& a, const PendingEvent& b)
+{
+    if (a.record.timestampMillis != b.record.timestampMillis)
+        return a.record.timestampMillis > b.record.timestampMillis;
+    return a.arrival > b.arrival;
+}
+
+void Logger::DrainLanes()
 {
-    if constexpr (std::is_same_v<T, Events::Click>)
-        return "Click";
-    else if constexpr (std::is_same_v<T, Events::CursorPosition>)
-        return "CursorPosition";
-    else if constexpr (std::is_same_v<T, Events::Keystroke>)
-        return "Keystroke";
-    else if constexpr (std::is_same_v<T, Events::FieldCompletion>)
-        return "FieldCompletion";
-    else if constexpr (std::is_same_v<T, Events::TaskCompletion>)
-        return "TaskCompletion";
-    else if constexpr (std::is_same_v<T, Events::DeviceChanged>)
-        return "DeviceChanged";
+    auto drain = [this](Lane& lane)
+    {
+        PendingEvent pending;
+        // at most one ring's worth, so a busy producer can't keep the writer here forever
+        for (size_t i = 0; i < lane.queue.Capacity() && lane.queue.TryPop(pending.record); i++)
+        {
+            pending.arrival = nextArrival++;
+            reorderHeap.push_back(pending);
+            std::push_heap(reorderHeap.begin(), reorderHeap.end(), IsLater);
+        }
+    };
+
+    const size_t count = numLanes.load(std::memory_order_acquire);
+    for (size_t i = 0; i < count; i++)
+        drain(*lanes[i]);
+    drain(*sharedLane);
+
+    if (reorderHeap.size() > reorderHighWaterMark.load(std::memory_order_relaxed))
+        reorderHighWaterMark.store(reorderHeap.size(), std::memory_order_relaxed);
 }
 
-std::string ClickLocationToString(Events::ClickLocation loc)
+void Logger::ReleaseEvents(bool releaseAll)
 {
-    switch (loc)
+    // everything stamped before the horizon is assumed to have arrived by now
+    const uint64_t now = Helpers::Clock::NowUnixMillis();
+    const uint64_t window = static_cast<uint64_t>(config.reorderWindow.count());
+    const uint64_t horizon = now > window ? now - window : 0;
+
+    while (!reorderHeap.empty() &&
+           (releaseAll || reorderHeap.front().record.timestampMillis <= horizon ||
+            reorderHeap.size() > MAX_REORDER_EVENTS))
     {
-        case Events::ClickLocation::OutOfBounds:
-            return "OutOfBounds";
-        case Events::ClickLocation::Background:
-            return "Background";
-        case Events::ClickLocation::TextField:
-            return "TextField";
-        case Events::ClickLocation::Button:
-            return "Button";
-        default:
-            return "<unknown>";
+        std::pop_heap(reorderHeap.begin(), reorderHeap.end(), IsLater);
+        WriteRecord(reorderHeap.back().record);
+        reorderHeap.pop_back();
     }
 }
 
-template <>
-std::string SerializeEvent(Events::Click event)
+void Logger::WriteRecord(const EventRecord& record)
 {
-    std::stringstream ss;
-    ss << std::boolalpha << EventTypeToString<Events::Click>() << DELIMITER << event.timestampMillis
-       << DELIMITER << ClickLocationToString(event.location) << DELIMITER << event.wasCorrect;
-    return ss.str();
+    if (record.timestampMillis < lastWrittenTimestamp)
+        eventsLate.fetch_add(1, std::memory_order_relaxed);
+    else
+        lastWrittenTimestamp = record.timestampMillis;
+
+    if (config.format == LogFormat::Binary)
+    {
+        binaryEncoder->Append(record);
+    }
+    else
+    {
+        SerializeRecord(record, arena);
+        arena.Append(LINE_TERMINATOR);
+    }
+
+    if (pendingFlush.eventCount == 0)
+        pendingFlush.firstTimestampMillis = record.timestampMillis;
+    pendingFlush.lastTimestampMillis = record.timestampMillis;
+    pendingFlush.eventCount++;
+
+    // a flush never spans two tasks, so every task is its own segment in the manifest
+    const bool isTaskCompletion = record.type == EventType::TaskCompletion;
+    if (isTaskCompletion || pendingFlush.eventCount >= FLUSH_EVENT_THRESHOLD ||
+        arena.Remaining() < MAX_SERIALIZED_EVENT_SIZE)
+    {
+        FlushWriteBuffer(isTaskCompletion && config.durability == DurabilityPolicy::TaskBoundary);
+    }
+
+    if (isTaskCompletion)
+        pendingFlush.segment++;
 }
 
-template <>
-std::string SerializeEvent(Events::CursorPosition event)
+void Logger::FlushWriteBuffer(bool forceSync)
 {
-    std::stringstream ss;
-    ss << std::boolalpha << EventTypeToString<Events::CursorPosition>() << DELIMITER
-       << event.timestampMillis << DELIMITER << event.positionX << DELIMITER << event.positionY;
-    return ss.str();
+    if (config.format == LogFormat::Binary)
+        binaryEncoder->EncodeAndClear(arena);
+
+    const bool needsSync = forceSync && (isSyncPending || !arena.IsEmpty());
+    if (arena.IsEmpty() && !needsSync)
+        return;
+
+    const auto start = std::chrono::steady_clock::now();
+
+    if (!arena.IsEmpty())
+    {
+        bytesSerialized.fetch_add(arena.Size(), std::memory_order_relaxed);
+
+        // one flush is one compressed block
+        const LogArena* output = &arena;
+        if (config.compress)
+        {
+            compressor->CompressBlock(arena.View(), compressedArena);
+            output = &compressedArena;
+        }
+
+        // the whole flush is one write
+        const std::string_view buffers[] = {output->View()};
+        if (file.IsOpen() && file.Write(buffers))
+        {
+            pendingFlush.startOffset = fileOffset;
+            pendingFlush.endOffset = fileOffset + output->Size();
+            pendingFlush.dataCrc = Helpers::Crc32(output->View());
+            AppendManifestRecord(manifestArena, pendingFlush);
+            fileOffset = pendingFlush.endOffset;
+            bytesWritten.fetch_add(output->Size(), std::memory_order_relaxed);
+        }
+        else
+        {
+            writeErrors.fetch_add(1, std::memory_order_relaxed);
+        }
+        isSyncPending = true;
+    }
+
+    // the log is synced before the manifest, so a synced manifest record never
+    // points at data that isn't on disk yet
+    if (needsSync)
+    {
+        if (!file.IsOpen() || !file.Sync())
+            writeErrors.fetch_add(1, std::memory_order_relaxed);
+        syncCount.fetch_add(1, std::memory_order_relaxed);
+        isSyncPending = false;
+    }
+
+    WriteManifest(needsSync);
+
+    const auto micros = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                              start)
+            .count());
+    flushCount.fetch_add(1, std::memory_order_relaxed);
+    lastFlushMicros.store(micros, std::memory_order_relaxed);
+    totalFlushMicros.fetch_add(micros, std::memory_order_relaxed);
+    if (micros > maxFlushMicros.load(std::memory_order_relaxed))
+        maxFlushMicros.store(micros, std::memory_order_relaxed);
+
+    arena.Clear();
+    compressedArena.Clear();
+    pendingFlush.eventCount = 0;
+    lastFlushTime = std::chrono::steady_clock::now();
 }
 
-template <>
-std::string SerializeEvent(Events::Keystroke event)
+void Logger::WriteManifest(bool sync)
 {
-    std::stringstream ss;
-    ss << std::boolalpha << EventTypeToString<Events::Keystroke>() << DELIMITER
-       << event.timestampMillis << DELIMITER << event.key << DELIMITER << event.wasCorrect;
-    return ss.str();
+    if (!manifestArena.IsEmpty())
+    {
+        const std::string_view buffers[] = {manifestArena.View()};
+        if (!manifestFile.IsOpen() || !manifestFile.Write(buffers))
+            writeErrors.fetch_add(1, std::memory_order_relaxed);
+        manifestArena.Clear();
+    }
+
+    if (sync && manifestFile.IsOpen() && !manifestFile.Sync())
+        writeErrors.fetch_add(1, std::memory_order_relaxed);
 }
 
-template <>
-std::string SerializeEvent(Events::FieldCompletion event)
+///////////////////////////////////////////////////////////////////////////////
+// Implementations of helper functions
+///////////////////////////////////////////////////////////////////////////////
+template <std::integral T>
+bool ParseInteger(std::string_view text, T& value)
 {
-    std::stringstream ss;
-    ss << std::boolalpha << EventTypeToString<Events::FieldCompletion>() << DELIMITER
-       << event.timestampMillis << DELIMITER << event.fieldIndex;
-    return ss.str();
+    const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+    return result.ec == std::errc() && result.ptr == text.data() + text.size();
 }
 
-template <>
-std::string SerializeEvent(Events::TaskCompletion event)
+bool ParseBool(std::string_view text, bool& value)
 {
-    std::stringstream ss;
-    ss << std::boolalpha << EventTypeToString<Events::TaskCompletion>() << DELIMITER
-       << event.timestampMillis << DELIMITER << event.taskIndex;
-    return ss.str();
+    value = text == "true";
+    return value || text == "false";
 }
 
-template <>
-std::string SerializeEvent(Events::DeviceChanged event)
+/// @brief Splits a log line on DELIMITER without copying.
+class FieldTokenizer
 {
-    std::stringstream ss;
-    ss << std::boolalpha << EventTypeToString<Events::DeviceChanged>() << DELIMITER
-       << event.timestampMillis << DELIMITER << event.newDevice;
-    return ss.str();
+   public:
+    FieldTokenizer(std::string_view line) : rest(line), isDone(false) {}
+
+    bool Next(std::string_view& field)
+    {
+        if (isDone)
+            return false;
+
+        const size_t end = rest.find(DELIMITER);
+        field = rest.substr(0, end);
+        if (end == std::string_view::npos)
+            isDone = true;
+        else
+            rest.remove_prefix(end + 1);
+        return true;
+    }
+
+    /// @brief Consumes everything not consumed yet as one field, delimiters included.
+    bool TakeRest(std::string_view& field)
+    {
+        if (isDone)
+            return false;
+
+        field = rest;
+        isDone = true;
+        return true;
+    }
+
+    bool IsDone() const { return isDone; }
+
+   private:
+    std::string_view rest;
+    bool isDone;
+};
+
+/// @brief "<event type><DELIMITER>", assembled at compile time so it can be copied in one go.
+template <Loggable T>
+struct EventPrefix
+{
+    static constexpr std::string_view NAME = EventSchema<T>::NAME;
+    static constexpr std::array<char, NAME.size() + 1> CHARS = []
+    {
+        std::array<char, NAME.size() + 1> chars{};
+        std::copy(NAME.begin(), NAME.end(), chars.begin());
+        chars[NAME.size()] = DELIMITER;
+        return chars;
+    }();
+    static constexpr std::string_view VIEW{CHARS.data(), CHARS.size()};
+};
+
+template <Loggable T>
+void SerializeEvent(const EventRecord& record, LogArena& arena)
+{
+    arena.Append(EventPrefix<T>::VIEW);
+    ForEachField<T>(
+        [&](const auto& field)
+        {
+            using F = FieldOf<decltype(field)>;
+            using Type = typename F::Type;
+
+            // the timestamp always comes first, straight after the prefix
+            if constexpr (F::SLOT != RecordSlot::Timestamp)
+                arena.Append(DELIMITER);
+
+            if constexpr (std::is_same_v<Type, bool>)
+                arena.AppendBool(record.flag);
+            else if constexpr (std::is_same_v<Type, std::string>)
+                arena.Append(RecordText(record));
+            else if constexpr (std::is_enum_v<Type>)
+                arena.Append(EnumToString(LoadSlot<F::SLOT, Type>(record)));
+            else
+                arena.AppendInteger(LoadSlot<F::SLOT, Type>(record));
+        });
+}
+
+template <Loggable T>
+bool ParseEvent(std::string_view fields, EventRecord& record)
+{
+    record.type = EventSchema<T>::TYPE;
+
+    // a string field may contain the delimiter itself (a ';' keystroke, say),
+    // so the fields after it are split off the end of the line
+    // and the string is whatever is left in between
+    constexpr size_t TEXT_INDEX = TextFieldIndex<T>();
+    constexpr size_t FIELDS_AFTER_TEXT =
+        TEXT_INDEX < NUM_FIELDS<T> ? NUM_FIELDS<T> - TEXT_INDEX - 1 : 0;
+
+    std::string_view head = fields, tail;
+    if constexpr (FIELDS_AFTER_TEXT > 0)
+    {
+        size_t tailStart = head.size();
+        for (size_t i = 0; i < FIELDS_AFTER_TEXT; i++)
+        {
+            tailStart = tailStart == 0 ? std::string_view::npos
+                                       : head.rfind(DELIMITER, tailStart - 1);
+            if (tailStart == std::string_view::npos)
+                return false;
+        }
+        tail = head.substr(tailStart + 1);
+        head = head.substr(0, tailStart);
+    }
+
+    FieldTokenizer front(head), back(tail);
+    bool isValid = true;
+    bool isPastText = false;
+    ForEachField<T>(
+        [&](const auto& field)
+        {
+            using F = FieldOf<decltype(field)>;
+            using Type = typename F::Type;
+            if (!isValid)
+                return;
+
+            std::string_view token;
+            if constexpr (F::SLOT == RecordSlot::Text)
+            {
+                isPastText = true;
+                isValid = front.TakeRest(token);
+                CopyRecordText(record, token);
+            }
+            else if (!(isPastText ? back : front).Next(token))
+            {
+                isValid = false;
+            }
+            else if constexpr (std::is_same_v<Type, bool>)
+            {
+                isValid = ParseBool(token, record.flag);
+            }
+            else
+            {
+                Type value{};
+                if constexpr (std::is_enum_v<Type>)
+                    isValid = EnumFromString(token, value);
+                else
+                    isValid = ParseInteger(token, value);
+                StoreSlot<F::SLOT>(record, value);
+            }
+        });
+
+    return isValid && front.IsDone() && (FIELDS_AFTER_TEXT == 0 || back.IsDone());
+}
+
+void SerializeRecord(const EventRecord& record, LogArena& arena)
+{
+    const bool isKnownType = VisitEventType(record.type,
+                                            [&](auto event)
+                                            {
+                                                using T = typename decltype(event)::type;
+                                                SerializeEvent<T>(record, arena);
+                                            });
+    if (!isKnownType)
+        arena.Append("<unknown>");
+}
+
+bool ParseRecord(std::string_view line, EventRecord& record)
+{
+    if (!line.empty() && line.back() == '\n')
+        line.remove_suffix(1);
+    if (!line.empty() && line.back() == '\r')
+        line.remove_suffix(1);
+
+    record = EventRecord{};
+    const size_t nameEnd = line.find(DELIMITER);
+    if (nameEnd == std::string_view::npos)
+        return false;
+
+    const std::string_view name = line.substr(0, nameEnd);
+    const std::string_view fields = line.substr(nameEnd + 1);
+    bool isValid = false;
+    ForEachEventType(
+        [&](auto event)
+        {
+            using T = typename decltype(event)::type;
+            if (name == EventSchema<T>::NAME)
+                isValid = ParseEvent<T>(fields, record);
+        });
+    return isValid;
 }
 
-}  // namespace Logging
\ No newline at end of file
+}  // namespace Logging
@@ -1,140 +1,262 @@
 #pragma once
 
-#include <Helpers/IsAnyOf.hpp>
 #include <array>
+#include <atomic>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
-#include <fstream>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <type_traits>
+#include <vector>
+
+#include "EventSchema.hpp"
+#include "LogArena.hpp"
+#include "LogFile.hpp"
+#include "LogManifest.hpp"
 
 namespace Logging
 {
 
 ///////////////////////////////////////////////////////////////////////////////
-// Event structures
+// Logger constants and etc
 ///////////////////////////////////////////////////////////////////////////////
-namespace Events
-{
+constexpr char DELIMITER = ';';
 
-enum class ClickLocation
-{
-    OutOfBounds,  // TODO: this might not be necessary, and is for sure impossible to catch in JS
-    Background,
-    TextField,
-    Button
-};
+/// @brief Written after every text event. The logger used to write through a text-mode
+///        std::ofstream, which turns '\n' into "\r\n" on Windows; this keeps that format.
+#ifdef _WIN32
+constexpr std::string_view LINE_TERMINATOR = "\r\n";
+#else
+constexpr std::string_view LINE_TERMINATOR = "\n";
+#endif
 
-struct Click
-{
-    uint64_t timestampMillis;
-    ClickLocation location;
-    bool wasCorrect;
-};
+///////////////////////////////////////////////////////////////////////////////
+// Logger class declaration
+///////////////////////////////////////////////////////////////////////////////
 
-struct CursorPosition
+/// @brief What Logger::Log does when the calling thread's lane is full.
+enum class OverflowPolicy
 {
-    uint64_t timestampMillis;
-    int positionX;
-    int positionY;
+    Drop,  // discard the event and count it
+    Block  // yield until the writer thread frees a slot, and count that we had to wait
 };
 
-struct Keystroke
+/// @brief On-disk format of the log file.
+enum class LogFormat
 {
-    uint64_t timestampMillis;
-    std::string key;
-    bool wasCorrect;
+    Text,   // one semicolon-delimited line per event
+    Binary  // columnar batches, see BinaryLog.hpp; convert back to Text with log2text
 };
 
-struct FieldCompletion
+/// @brief When the writer thread forces written data to stable storage.
+enum class DurabilityPolicy
 {
-    uint64_t timestampMillis;
-    int fieldIndex;
+    None,         // leave it to the OS
+    Interval,     // fdatasync at most every LoggerConfig::syncInterval
+    TaskBoundary  // fdatasync right after every TaskCompletion event is written
 };
 
-struct TaskCompletion
+/// @brief Snapshot of the logger's counters, for sizing the queue and picking a durability policy.
+struct LoggerStats
 {
-    uint64_t timestampMillis;
-    int taskIndex;
-};
+    // per lane: queueDepth and highWaterMark are of the deepest lane, out of capacity
+    size_t capacity;
+    size_t queueDepth;
+    size_t highWaterMark;
+    size_t numLanes;
+    uint64_t eventsLogged;
+    uint64_t eventsDropped;
+    uint64_t eventsBlocked;
 
-struct DeviceChanged
-{
-    uint64_t timestampMillis;
-    std::string newDevice;
+    // events that reached the writer after a newer event had already been written
+    uint64_t eventsLate;
+    size_t reorderHighWaterMark;
+
+    // a flush is one write of the arena, plus the sync if the policy asked for one
+    uint64_t flushCount;
+    uint64_t syncCount;
+    uint64_t writeErrors;
+    uint64_t lastFlushMicros;
+    uint64_t maxFlushMicros;
+    uint64_t totalFlushMicros;
+
+    // bytesSerialized is what would have been written without compression
+    uint64_t bytesSerialized;
+    uint64_t bytesWritten;
 };
 
-}  // namespace Events
+/// @brief Capacity (in events) of each producer thread's lane when none is given.
+///        Must be a power of two.
+constexpr size_t DEFAULT_QUEUE_CAPACITY = 1 << 12;
 
-///////////////////////////////////////////////////////////////////////////////
-// Logger constants and etc
-///////////////////////////////////////////////////////////////////////////////
-constexpr char DELIMITER = ';';
+/// @brief Producer threads that get a lane of their own. Any further threads share one lane,
+///        which they take turns on through a mutex.
+constexpr size_t MAX_LANES = 64;
 
-template <typename T>
-concept Loggable = IsAnyOf<T, Events::Click, Events::CursorPosition, Events::Keystroke,
-                           Events::FieldCompletion, Events::TaskCompletion, Events::DeviceChanged>;
+/// @brief How long the writer holds an event back, waiting for older events to arrive from other
+///        threads, when none is given.
+constexpr std::chrono::milliseconds DEFAULT_REORDER_WINDOW{1000};
 
-uint64_t GetCurrentUnixTimeMillis();
+/// @brief The writer releases the oldest held-back events early rather than hold more than this.
+constexpr size_t MAX_REORDER_EVENTS = 1 << 16;
 
-///////////////////////////////////////////////////////////////////////////////
-// Logger class declaration
-///////////////////////////////////////////////////////////////////////////////
+/// @brief The writer thread writes to disk once this many events are buffered...
+constexpr size_t FLUSH_EVENT_THRESHOLD = 1000;
+
+/// @brief ...or once this much time has passed since the last write, whichever comes first.
+constexpr std::chrono::milliseconds FLUSH_INTERVAL{1000};
+
+/// @brief How long the writer thread sleeps when the queue is empty.
+constexpr std::chrono::milliseconds WRITER_IDLE_INTERVAL{5};
+
+struct LoggerConfig
+{
+    size_t queueCapacity = DEFAULT_QUEUE_CAPACITY;  // per lane
+    std::chrono::milliseconds reorderWindow = DEFAULT_REORDER_WINDOW;  // 0 writes in arrival order
+    OverflowPolicy overflowPolicy = OverflowPolicy::Block;
+    LogFormat format = LogFormat::Text;
+    DurabilityPolicy durability = DurabilityPolicy::None;
+    std::chrono::milliseconds syncInterval{1000};
+    bool compress = false;  // LZ-compress every flush on the writer thread, see LogCompression.hpp
+};
+
+class BinaryBatchEncoder;
+class LogCompressor;
+
+/// @brief Asynchronous event logger.
+///        Log() only enqueues a fixed-size record into the calling thread's own lane, a
+///        wait-free single-producer ring, so producers never contend with each other.
+///        A background writer thread owned by the logger merges the lanes by timestamp and does
+///        all serialization and file I/O. An event is written once it is reorderWindow old,
+///        so the log comes out in chronological order as long as no event takes longer than
+///        that to reach Log() (browser events are stamped before they are sent).
+///        Every flush is recorded in a checksummed manifest next to the log (see LogManifest.hpp),
+///        so a log left behind by a crash can be recovered with RecoverLog.
 class Logger
 {
    public:
-    Logger();
-    Logger(std::string filename);
+    Logger(const LoggerConfig& config = LoggerConfig{});
+    Logger(std::string filename, const LoggerConfig& config = LoggerConfig{});
     ~Logger();
 
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
+    /// @brief Sets the output file and starts the writer thread.
+    ///        Events logged to a previous file are written out first.
     void OpenLogFile(const std::string& filename);
 
+    /// @brief Safe to call from any thread.
     template <Loggable T>
-    void Log(T event);
+    void Log(const T& event);
+
+    /// @brief Like Log, but never waits: if the calling thread's lane is full the event is
+    ///        dropped and counted, whatever the overflow policy says. For threads with deadlines.
+    /// @return false if the event was dropped.
+    template <Loggable T>
+    bool TryLog(const T& event);
+
+    /// @brief Gives the calling thread its lane now rather than on its first Log,
+    ///        which takes a lock. Safe to call from any thread, any number of times.
+    /// @return false if every lane is taken and the thread has to share one (behind a mutex).
+    bool ReserveLane();
+
+    LoggerStats GetStats() const;
 
    private:
+    struct Lane;
+
+    /// @brief An event held back by the writer until it is old enough to be written.
+    struct PendingEvent
+    {
+        EventRecord record;
+        uint64_t arrival;  // keeps events with the same timestamp in the order they arrived
+    };
+
+    /// @brief Heap order of the reorder buffer: the earliest event ends up on top.
+    static bool IsLater(const PendingEvent& a, const PendingEvent& b);
+
     std::string logFilename;
     bool hasFilename;
 
-    std::array<std::array<std::string, 1000>, 2> logDoubleBuffer;
-    int currBuffer;
-    int currIndex;
-    bool isFileInitialized;
-    std::mutex mutex;
+    const LoggerConfig config;
+    const uint64_t id;  // never reused, so a lane cached for a dead logger never matches again
+
+    // lanes[0, numLanes) are never moved or freed while the logger lives
+    std::array<std::unique_ptr<Lane>, MAX_LANES> lanes;
+    std::atomic<size_t> numLanes;
+    std::mutex lanesMutex;  // taken only to add a lane
+    std::unique_ptr<Lane> sharedLane;
+    std::mutex sharedLaneMutex;
+
+    // written by the writer thread, read by GetStats
+    std::atomic<uint64_t> flushCount;
+    std::atomic<uint64_t> syncCount;
+    std::atomic<uint64_t> writeErrors;
+    std::atomic<uint64_t> lastFlushMicros;
+    std::atomic<uint64_t> maxFlushMicros;
+    std::atomic<uint64_t> totalFlushMicros;
+    std::atomic<uint64_t> bytesSerialized;
+    std::atomic<uint64_t> bytesWritten;
+    std::atomic<uint64_t> eventsLate;
+    std::atomic<size_t> reorderHighWaterMark;
+
+    // only ever touched by the writer thread
+    std::vector<PendingEvent> reorderHeap;
+    uint64_t nextArrival;
+    uint64_t lastWrittenTimestamp;
+    std::chrono::steady_clock::time_point lastFlushTime;
+    LogFile file;
+    LogFile manifestFile;
+    LogArena arena;
+    LogArena compressedArena;
+    LogArena manifestArena;
+    uint64_t fileOffset;
+    ManifestRecord pendingFlush;  // describes what is buffered in arena right now
+    bool isSyncPending;
+    std::unique_ptr<BinaryBatchEncoder> binaryEncoder;
+    std::unique_ptr<LogCompressor> compressor;
+
+    std::thread writerThread;
+    std::atomic<bool> stopWriter;
+
+    bool Enqueue(const EventRecord& record, bool canWait);
+    bool PushToLane(Lane& lane, const EventRecord& record, bool canWait);
+    Lane* GetLane();
+    Lane* RegisterLane();
+    void StartWriter();
+    void StopWriter();
+    void WriterLoop();
+    void DrainLanes();
+    void ReleaseEvents(bool releaseAll);
+    void WriteRecord(const EventRecord& record);
+    void FlushWriteBuffer(bool forceSync);
+    void WriteManifest(bool sync);
 };
 
-template <Loggable T>
-std::string SerializeEvent(T event);
+/// @brief Appends the text form of a record to the arena (no trailing newline).
+void SerializeRecord(const EventRecord& record, LogArena& arena);
+
+/// @brief Inverse of SerializeRecord: parses one text log line (the line terminator is optional).
+/// @return false if the line is not a well-formed event.
+bool ParseRecord(std::string_view line, EventRecord& record);
 
 template <Loggable T>
-void Logger::Log(T event)
+void Logger::Log(const T& event)
 {
-    std::lock_guard<std::mutex> lock(mutex);
-
     assert(hasFilename);
-    std::string logLine = SerializeEvent(event);
-
-    // the buffer should not be full at this point
-    auto& buffer = logDoubleBuffer[currBuffer];
-    buffer[currIndex] = logLine;
+    Enqueue(ToRecord(event), true);
+}
 
-    currIndex++;
-    if (currIndex == buffer.size())
-    {
-        // buffer is now semantically the backbuffer
-        currBuffer = (currBuffer + 1) % 2;
-        currIndex = 0;
-
-        // write the backbuffer
-        auto openMode = isFileInitialized ? std::ios::app : std::ios::trunc;
-        std::ofstream outFile(logFilename, openMode);
-        for (auto it = buffer.begin(); it != buffer.end(); ++it)
-            outFile << *it << "\n";
-
-        if (!isFileInitialized)
-            isFileInitialized = true;
-    }
+template <Loggable T>
+bool Logger::TryLog(const T& event)
+{
+    assert(hasFilename);
+    return Enqueue(ToRecord(event), false);
 }
 
 }  // namespace Logging
\ No newline at end of file
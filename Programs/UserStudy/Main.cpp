@@ -1,8 +1,17 @@
 #include <LeapC.h>
 
+#include <Helpers/Clock.hpp>
+#include <Input/GestureClassifier.hpp>
+#include <Input/HandStateFilter.hpp>
+#include <Input/LeapConnection.hpp>
+#include <Input/ReplayFrameSource.hpp>
 #include <Input/SimulatedMouse.hpp>
+#include <charconv>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
 #include <thread>
 
 #include "CursorLogger.hpp"
@@ -14,24 +23,91 @@
 
 int PrintHelp(bool isBadUsage);
 int RunMouseConfigure();
-int RunUserStudy();
+int RunUserStudy(const Logging::LoggerConfig& loggerConfig, uint32_t cursorRateHz,
+                 bool isLoggingDriverInput, const Input::Leap::HandFilterConfig& filterConfig,
+                 Input::Leap::GestureClassifierType classifierType,
+                 const std::string& replayFilename, double replaySpeed);
 
 int main(int argc, char** argv)
 {
-    if (argc > 2)
-        return PrintHelp(true);
+    // a task's events are on disk before the participant starts the next one
+    Logging::LoggerConfig loggerConfig{};
+    loggerConfig.durability = Logging::DurabilityPolicy::TaskBoundary;
+    uint32_t cursorRateHz = Logging::DEFAULT_CURSOR_RATE_HZ;
+    bool isLoggingDriverInput = false;
+    Input::Leap::HandFilterConfig filterConfig{};
+    Input::Leap::GestureClassifierType classifierType = Input::Leap::GestureClassifierType::Study;
+    std::string replayFilename;  // empty: track hands with the Leap Motion device
+    double replaySpeed = 1.0;
 
-    if (argc == 2)
+    for (int i = 1; i < argc; i++)
     {
-        if (!std::strcmp(argv[1], "--help") || !std::strcmp(argv[1], "-h"))
+        if (!std::strcmp(argv[i], "--help") || !std::strcmp(argv[i], "-h"))
             return PrintHelp(false);
-        if (!std::strcmp(argv[1], "--configure-mouse") || !std::strcmp(argv[1], "-c"))
+        if (!std::strcmp(argv[i], "--configure-mouse") || !std::strcmp(argv[i], "-c"))
             return RunMouseConfigure();
+        else if (!std::strcmp(argv[i], "--binary-log") || !std::strcmp(argv[i], "-b"))
+            loggerConfig.format = Logging::LogFormat::Binary;
+        else if (!std::strcmp(argv[i], "--compress-log") || !std::strcmp(argv[i], "-z"))
+            loggerConfig.compress = true;
+        else if (!std::strcmp(argv[i], "--log-driver") || !std::strcmp(argv[i], "-d"))
+            isLoggingDriverInput = true;
+        else if ((!std::strcmp(argv[i], "--cursor-rate") || !std::strcmp(argv[i], "-r")) &&
+                 i + 1 < argc)
+        {
+            const char* rate = argv[++i];
+            const char* rateEnd = rate + std::strlen(rate);
+            const auto result = std::from_chars(rate, rateEnd, cursorRateHz);
+            if (result.ec != std::errc() || result.ptr != rateEnd ||
+                cursorRateHz < Logging::MIN_CURSOR_RATE_HZ ||
+                cursorRateHz > Logging::MAX_CURSOR_RATE_HZ)
+                return PrintHelp(true);
+        }
+        else if ((!std::strcmp(argv[i], "--filter") || !std::strcmp(argv[i], "-f")) &&
+                 i + 1 < argc)
+        {
+            const auto type = Input::Leap::ParseHandFilterType(argv[++i]);
+            if (!type)
+                return PrintHelp(true);
+            filterConfig.type = *type;
+        }
+        else if ((!std::strcmp(argv[i], "--lag-budget") || !std::strcmp(argv[i], "-l")) &&
+                 i + 1 < argc)
+        {
+            const char* budget = argv[++i];
+            const char* budgetEnd = budget + std::strlen(budget);
+            float budgetMillis = 0.0f;
+            const auto result = std::from_chars(budget, budgetEnd, budgetMillis);
+            if (result.ec != std::errc() || result.ptr != budgetEnd || budgetMillis <= 0.0f)
+                return PrintHelp(true);
+            filterConfig.lagBudgetSeconds = budgetMillis / 1000.0f;
+        }
+        else if ((!std::strcmp(argv[i], "--classifier") || !std::strcmp(argv[i], "-g")) &&
+                 i + 1 < argc)
+        {
+            const auto type = Input::Leap::ParseGestureClassifierType(argv[++i]);
+            if (!type)
+                return PrintHelp(true);
+            classifierType = *type;
+        }
+        else if ((!std::strcmp(argv[i], "--replay") || !std::strcmp(argv[i], "-p")) &&
+                 i + 1 < argc)
+            replayFilename = argv[++i];
+        else if ((!std::strcmp(argv[i], "--replay-speed") || !std::strcmp(argv[i], "-s")) &&
+                 i + 1 < argc)
+        {
+            const char* speed = argv[++i];
+            const char* speedEnd = speed + std::strlen(speed);
+            const auto result = std::from_chars(speed, speedEnd, replaySpeed);
+            if (result.ec != std::errc() || result.ptr != speedEnd || replaySpeed < 0.0)
+                return PrintHelp(true);
+        }
         else
             return PrintHelp(true);
     }
 
-    return RunUserStudy();
+    return RunUserStudy(loggerConfig, cursorRateHz, isLoggingDriverInput, filterConfig,
+                        classifierType, replayFilename, replaySpeed);
 }
 
 int PrintHelp(bool isBadUsage)
@@ -44,6 +120,26 @@ int PrintHelp(bool isBadUsage)
         << "to during the user study.\n"
         << "                         The monitor that the mouse moves to is the monitor the "
         << "browser window should be on.\n"
+        << "    --binary-log, -b -> Run user study, writing the log in the binary format.\n"
+        << "                        Use log2text to convert it back to the text format.\n"
+        << "    --compress-log, -z -> Run user study, compressing the log as it is written.\n"
+        << "                          Can be combined with --binary-log. Use log2text to read it.\n"
+        << "    --cursor-rate, -r <Hz> -> Samples the cursor position <Hz> times a second, "
+        << "from " << Logging::MIN_CURSOR_RATE_HZ << " to " << Logging::MAX_CURSOR_RATE_HZ
+        << " (default " << Logging::DEFAULT_CURSOR_RATE_HZ << ").\n"
+        << "    --log-driver, -d -> Also logs every move, click and pose change the gesture "
+        << "driver makes, up to once per tracking frame.\n"
+        << "    --filter, -f <none|one-euro|kalman> -> Smooths the tracked hand before the "
+        << "driver judges its pose (default none).\n"
+        << "    --lag-budget, -l <ms> -> The most the filter should lag behind the hand; "
+        << "frames past it are counted in the driver's stats (default "
+        << Input::Leap::HandFilterConfig{}.lagBudgetSeconds * 1000.0f << ").\n"
+        << "    --classifier, -g <study|dwell-click|continuous|sixteen-way> -> How the driver "
+        << "turns hands into clicks and cursor movement (default study).\n"
+        << "    --replay, -p <file> -> Plays a frame capture back, over and over, instead of "
+        << "tracking hands with the Leap Motion device.\n"
+        << "    --replay-speed, -s <x> -> Plays the capture <x> times as fast as it was recorded "
+        << "(default 1). 0 plays it as fast as the driver can take it.\n"
         << "    --help, -h -> Shows this message." << std::endl;
     return static_cast<int>(isBadUsage);
 }
@@ -54,10 +150,28 @@ int RunMouseConfigure()
     return 0;
 }
 
-int RunUserStudy()
+int RunUserStudy(const Logging::LoggerConfig& loggerConfig, uint32_t cursorRateHz,
+                 bool isLoggingDriverInput, const Input::Leap::HandFilterConfig& filterConfig,
+                 Input::Leap::GestureClassifierType classifierType,
+                 const std::string& replayFilename, double replaySpeed)
 {
-    Input::Leap::LeapConnection connection;
-    while (!connection.IsConnected())
+    std::unique_ptr<Input::Leap::FrameSource> frameSource;
+    if (replayFilename.empty())
+        frameSource = std::make_unique<Input::Leap::LeapConnection>();
+    else
+    {
+        try
+        {
+            frameSource = std::make_unique<Input::Leap::ReplayFrameSource>(replayFilename,
+                                                                           replaySpeed, true);
+        }
+        catch (const std::runtime_error& error)
+        {
+            std::cout << "[main] " << error.what() << "\n";
+            return 1;
+        }
+    }
+    while (!frameSource->IsConnected())
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
 
     Renderables renderables{};
@@ -66,19 +180,25 @@ int RunUserStudy()
     std::atomic<bool> isLeapDriverActive(true);
     std::atomic<bool> isLogging(false);
 
-    SyncState syncState(connection, renderables, renderableCopyMutex, isRunning, isLeapDriverActive,
-                        isLogging);
+    SyncState syncState(*frameSource, renderables, renderableCopyMutex, isRunning,
+                        isLeapDriverActive, isLogging, loggerConfig);
     auto r_syncState = std::ref(syncState);
 
     std::thread httpThread(Http::HttpServerLoop, r_syncState);
-    std::thread driverThread(Input::DriverLoop, r_syncState);
+    std::thread driverThread(Input::DriverLoop, r_syncState, isLoggingDriverInput,
+                             std::cref(filterConfig), classifierType);
     std::thread renderThread(Visualization::RenderLoop, r_syncState);
-    std::thread cursorLoggingThread(Logging::CursorLoggerLoop, r_syncState);
+    std::thread cursorLoggingThread(Logging::CursorLoggerLoop, r_syncState, cursorRateHz);
 
     cursorLoggingThread.join();
     renderThread.join();
     driverThread.join();
     httpThread.join();
 
+    const Helpers::Clock::Stats clockStats = Helpers::Clock::GetStats();
+    std::cout << "[main] Clock: " << clockStats.numCorrections << " drift corrections, largest "
+              << clockStats.maxAbsErrorMicros << "us, " << clockStats.numIgnoredSteps
+              << " wall clock steps not followed\n";
+
     return 0;
 }
\ No newline at end of file
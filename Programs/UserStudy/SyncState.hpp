@@ -1,9 +1,11 @@
 #pragma once
 
-#include <Input/LeapConnection.hpp>
+#include <Input/FrameSource.hpp>
 #include <atomic>
+#include <condition_variable>
 #include <mutex>
 
+#include "InputLatency.hpp"
 #include "Logging.hpp"
 
 struct Renderables
@@ -20,9 +22,11 @@ struct Renderables
 struct SyncState
 {
     SyncState() = delete;
-    SyncState(Input::Leap::LeapConnection& conn, Renderables& rend, std::mutex& rcm,
-              std::atomic<bool>& running, std::atomic<bool>& leapActive, std::atomic<bool>& logging)
-        : connection(conn),
+    SyncState(Input::Leap::FrameSource& frames, Renderables& rend, std::mutex& rcm,
+              std::atomic<bool>& running, std::atomic<bool>& leapActive, std::atomic<bool>& logging,
+              const Logging::LoggerConfig& loggerConfig = Logging::LoggerConfig{})
+        : logger(loggerConfig),
+          frameSource(frames),
           renderables(rend),
           renderableCopyMutex(rcm),
           isRunning(running),
@@ -34,11 +38,38 @@ struct SyncState
     SyncState(const SyncState&) = delete;
     SyncState(const SyncState&&) = delete;
 
+    /// @brief Wakes every thread parked in WaitForState or waiting for a Leap Motion frame.
+    ///        Call it after storing to isRunning, isLeapDriverActive or isLogging.
+    void NotifyStateChanged()
+    {
+        // Taking the lock once is enough: a waiter checks its predicate with the lock held,
+        // so it either sees the new value or is already asleep when notify_all runs.
+        {
+            std::lock_guard<std::mutex> lock(stateMutex);
+        }
+        stateChanged.notify_all();
+        frameSource.WakeFrameWaiters();
+    }
+
+    /// @brief Parks the calling thread until isReady() returns true.
+    ///        isReady is checked with the state lock held, and again on every NotifyStateChanged.
+    template <typename Predicate>
+    void WaitForState(Predicate isReady)
+    {
+        std::unique_lock<std::mutex> lock(stateMutex);
+        stateChanged.wait(lock, isReady);
+    }
+
     Logging::Logger logger;
-    Input::Leap::LeapConnection& connection;
+    Input::InputLatency inputLatency;  // recorded by the driver
+    Input::Leap::FrameSource& frameSource;
     Renderables& renderables;
     std::mutex& renderableCopyMutex;
     std::atomic<bool>& isRunning;
     std::atomic<bool>& isLeapDriverActive;
     std::atomic<bool>& isLogging;
+
+   private:
+    std::mutex stateMutex;
+    std::condition_variable stateChanged;
 };
\ No newline at end of file
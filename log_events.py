@@ -0,0 +1,218 @@
+# Generated by eventReaderGen from Programs/UserStudy/EventSchema.hpp. Do not edit.
+# Regenerate with: cmake --build <build directory> --target pythonEventReader
+from dataclasses import dataclass
+from typing import Iterator, Optional
+
+DELIMITER = ";"
+
+CLICK_LOCATION = ("OutOfBounds", "Background", "TextField", "Button")
+HAND_POSE = ("NoHand", "Move", "Click")
+
+
+def _parse_bool(token: str) -> bool:
+    if token not in ("true", "false"):
+        raise ValueError(f"not a bool: {token!r}")
+    return token == "true"
+
+
+def _parse_enum(token: str, values: tuple) -> str:
+    if token not in values:
+        raise ValueError(f"not one of {values}: {token!r}")
+    return token
+
+
+def _split(fields: str, before: int, after: int, has_text: bool) -> list:
+    """Splits the fields after the event name.
+    A string field may contain the delimiter itself, so the fields after it are split off the end
+    and the string is whatever is left in between."""
+    if not has_text:
+        tokens = fields.split(DELIMITER)
+        if len(tokens) != before:
+            raise ValueError(f"expected {before} fields: {fields!r}")
+        return tokens
+
+    head = fields.split(DELIMITER, before)
+    if len(head) != before + 1:
+        raise ValueError(f"expected at least {before + after + 1} fields: {fields!r}")
+    tail = head.pop().rsplit(DELIMITER, after)
+    if len(tail) != after + 1:
+        raise ValueError(f"expected at least {before + after + 1} fields: {fields!r}")
+    return head + tail
+
+
+@dataclass
+class Click:
+    timestamp_millis: int
+    location: str
+    was_correct: bool
+    event_type: str = "Click"
+
+
+def _parse_click(fields: str) -> Click:
+    t = _split(fields, 3, 0, False)
+    return Click(int(t[0]), _parse_enum(t[1], CLICK_LOCATION), _parse_bool(t[2]))
+
+
+@dataclass
+class CursorPosition:
+    timestamp_millis: int
+    position_x: int
+    position_y: int
+    event_type: str = "CursorPosition"
+
+
+def _parse_cursor_position(fields: str) -> CursorPosition:
+    t = _split(fields, 3, 0, False)
+    return CursorPosition(int(t[0]), int(t[1]), int(t[2]))
+
+
+@dataclass
+class Keystroke:
+    timestamp_millis: int
+    key: str
+    was_correct: bool
+    event_type: str = "Keystroke"
+
+
+def _parse_keystroke(fields: str) -> Keystroke:
+    t = _split(fields, 1, 1, True)
+    return Keystroke(int(t[0]), t[1], _parse_bool(t[2]))
+
+
+@dataclass
+class FieldCompletion:
+    timestamp_millis: int
+    field_index: int
+    event_type: str = "FieldCompletion"
+
+
+def _parse_field_completion(fields: str) -> FieldCompletion:
+    t = _split(fields, 2, 0, False)
+    return FieldCompletion(int(t[0]), int(t[1]))
+
+
+@dataclass
+class TaskCompletion:
+    timestamp_millis: int
+    task_index: int
+    event_type: str = "TaskCompletion"
+
+
+def _parse_task_completion(fields: str) -> TaskCompletion:
+    t = _split(fields, 2, 0, False)
+    return TaskCompletion(int(t[0]), int(t[1]))
+
+
+@dataclass
+class DeviceChanged:
+    timestamp_millis: int
+    new_device: str
+    event_type: str = "DeviceChanged"
+
+
+def _parse_device_changed(fields: str) -> DeviceChanged:
+    t = _split(fields, 1, 0, True)
+    return DeviceChanged(int(t[0]), t[1])
+
+
+@dataclass
+class CursorHold:
+    timestamp_millis: int
+    sample_count: int
+    interval_micros: int
+    event_type: str = "CursorHold"
+
+
+def _parse_cursor_hold(fields: str) -> CursorHold:
+    t = _split(fields, 3, 0, False)
+    return CursorHold(int(t[0]), int(t[1]), int(t[2]))
+
+
+@dataclass
+class DriverMove:
+    timestamp_millis: int
+    dx: int
+    dy: int
+    event_type: str = "DriverMove"
+
+
+def _parse_driver_move(fields: str) -> DriverMove:
+    t = _split(fields, 3, 0, False)
+    return DriverMove(int(t[0]), int(t[1]), int(t[2]))
+
+
+@dataclass
+class DriverClick:
+    timestamp_millis: int
+    event_type: str = "DriverClick"
+
+
+def _parse_driver_click(fields: str) -> DriverClick:
+    t = _split(fields, 1, 0, False)
+    return DriverClick(int(t[0]))
+
+
+@dataclass
+class DriverPose:
+    timestamp_millis: int
+    pose: str
+    event_type: str = "DriverPose"
+
+
+def _parse_driver_pose(fields: str) -> DriverPose:
+    t = _split(fields, 2, 0, False)
+    return DriverPose(int(t[0]), _parse_enum(t[1], HAND_POSE))
+
+
+@dataclass
+class DriverAccumulator:
+    timestamp_millis: int
+    accumulator_x: int
+    accumulator_y: int
+    event_type: str = "DriverAccumulator"
+
+
+def _parse_driver_accumulator(fields: str) -> DriverAccumulator:
+    t = _split(fields, 3, 0, False)
+    return DriverAccumulator(int(t[0]), int(t[1]), int(t[2]))
+
+
+_PARSERS = {
+    "Click": _parse_click,
+    "CursorPosition": _parse_cursor_position,
+    "Keystroke": _parse_keystroke,
+    "FieldCompletion": _parse_field_completion,
+    "TaskCompletion": _parse_task_completion,
+    "DeviceChanged": _parse_device_changed,
+    "CursorHold": _parse_cursor_hold,
+    "DriverMove": _parse_driver_move,
+    "DriverClick": _parse_driver_click,
+    "DriverPose": _parse_driver_pose,
+    "DriverAccumulator": _parse_driver_accumulator,
+}
+
+
+def parse_line(line: str) -> Optional[object]:
+    """Parses one line of a text log. Returns None for blank lines, raises ValueError if the line
+    is not a well-formed event."""
+    if line.endswith("\n"):
+        line = line[:-1]
+    if line.endswith("\r"):
+        line = line[:-1]
+    if line == "":
+        return None
+
+    name, delimiter, fields = line.partition(DELIMITER)
+    if name not in _PARSERS or delimiter == "":
+        raise ValueError(f"unknown event: {line!r}")
+    return _PARSERS[name](fields)
+
+
+def read_log(filename: str) -> Iterator[object]:
+    """Yields every event of a text log, in the order they were logged.
+    Use log2text to convert binary or compressed logs first."""
+    with open(filename, "r", encoding="utf-8", newline="") as logfile:
+        for line in logfile:
+            event = parse_line(line)
+            if event is not None:
+                yield event
@@ -1,53 +1,25 @@
-from dataclasses import dataclass
 from pprint import pprint
 
+# the event classes and the log parser are generated from the logger's event schema,
+# see Programs/Tools/EventReaderGen.cpp
+from log_events import (Click, CursorHold, CursorPosition, DeviceChanged, DriverAccumulator,
+                        DriverClick, DriverMove, DriverPose, FieldCompletion, Keystroke,
+                        TaskCompletion, read_log)
+
 # event names
-EVENT_CLICK = "Click"
-EVENT_CURSOR = "CursorPosition"
-EVENT_KEYSTROKE = "Keystroke"
-EVENT_FIELD = "FieldCompletion"
-EVENT_TASK = "TaskCompletion"
-EVENT_DEVICE = "DeviceChanged"
-
-
-@dataclass
-class Click:
-    timestamp: int
-    location: str
-    was_correct: bool
-    event_type: str = EVENT_CLICK
-
-@dataclass
-class CursorPosition:
-    timestamp: int
-    x: int
-    y: int
-    event_type: str = EVENT_CURSOR
-
-@dataclass
-class Keystroke:
-    timestamp: int
-    key: str
-    was_correct: bool
-    event_type: str = EVENT_KEYSTROKE
-
-@dataclass
-class FieldCompletion:
-    timestamp: int
-    field_index: int
-    event_type: str = EVENT_FIELD
-
-@dataclass
-class TaskCompletion:
-    timestamp: int
-    task_index: int
-    event_type: str = EVENT_TASK
-
-@dataclass
-class DeviceChanged:
-    timestamp: int
-    device: str
-    event_type: str = EVENT_DEVICE
+EVENT_CLICK = Click.event_type
+EVENT_CURSOR = CursorPosition.event_type
+# the cursor didn't move for a while, see Programs/UserStudy/CursorStream.hpp
+EVENT_CURSOR_HOLD = CursorHold.event_type
+EVENT_KEYSTROKE = Keystroke.event_type
+EVENT_FIELD = FieldCompletion.event_type
+EVENT_TASK = TaskCompletion.event_type
+EVENT_DEVICE = DeviceChanged.event_type
+# only in logs of studies run with --log-driver
+EVENT_DRIVER_MOVE = DriverMove.event_type
+EVENT_DRIVER_CLICK = DriverClick.event_type
+EVENT_DRIVER_POSE = DriverPose.event_type
+EVENT_DRIVER_ACCUMULATOR = DriverAccumulator.event_type
 
 
 def generate_statistics(events_flattened: list[dict]) -> dict:
@@ -60,50 +32,31 @@ def generate_statistics(events_flattened: list[dict]) -> dict:
     # i think you can figure it out based on what i already typed up
 
 
-def str_to_pybool(s: str) -> bool:
-    return s == "true"
-
 def main(filename: str) -> None:
     events = {
         EVENT_CLICK: [],
         EVENT_CURSOR: [],
+        EVENT_CURSOR_HOLD: [],
         EVENT_KEYSTROKE: [],
         EVENT_FIELD: [],
         EVENT_TASK: [],
-        EVENT_DEVICE: []
+        EVENT_DEVICE: [],
+        EVENT_DRIVER_MOVE: [],
+        EVENT_DRIVER_CLICK: [],
+        EVENT_DRIVER_POSE: [],
+        EVENT_DRIVER_ACCUMULATOR: []
     }
 
-    with open(filename, "r") as logfile:
-        for line in logfile:
-            line = line.strip()
-            if line == "":
-                continue
-            tokens = line.split(";")
-            event_name = tokens[0]
-            event_time = int(tokens[1])
-            event_data = tokens[2:]
-
-            if event_name == EVENT_CLICK:
-                event = Click(event_time, event_data[0], str_to_pybool(event_data[1]))
-            elif event_name == EVENT_CURSOR:
-                event = CursorPosition(event_time, int(event_data[0]), int(event_data[1]))
-            elif event_name == EVENT_KEYSTROKE:
-                event = Keystroke(event_time, event_data[0], str_to_pybool(event_data[1]))
-            elif event_name == EVENT_FIELD:
-                event = FieldCompletion(event_time, int(event_data[0]))
-            elif event_name == EVENT_TASK:
-                event = TaskCompletion(event_time, int(event_data[0]))
-            elif event_name == EVENT_DEVICE:
-                event = DeviceChanged(event_time, event_data[0])
-            
-            events[event_name].append(event)
-
-
-    # sort events by timestamp
+    # the logger writes events in timestamp order
     events_chronological = []
-    for _, value in events.items():
-        events_chronological += value
-    events_chronological.sort(key=lambda x: x.timestamp)
+    for event in read_log(filename):
+        events[event.event_type].append(event)
+        events_chronological.append(event)
+
+    # logs from before the logger merged its producers by timestamp need sorting
+    if any(a.timestamp_millis > b.timestamp_millis
+           for a, b in zip(events_chronological, events_chronological[1:])):
+        events_chronological.sort(key=lambda x: x.timestamp_millis)
 
     type_predicate = lambda type: type is FieldCompletion or type is TaskCompletion or type is DeviceChanged
     pprint([evt for evt in events_chronological if type_predicate(type(evt))])
@@ -140,14 +93,14 @@ def main(filename: str) -> None:
             last_event_completion = event
         elif event.event_type == EVENT_CURSOR:
             if last_cursor is not None:
-                delta_x = event.x - last_cursor.x
-                delta_y = event.y - last_cursor.y
+                delta_x = event.position_x - last_cursor.position_x
+                delta_y = event.position_y - last_cursor.position_y
             
 
             if (last_text_completion is not None
                     and delta_x != 0
                     and delta_y != 0):
-                homing_times.append(event.timestamp - last_text_completion.timestamp)
+                homing_times.append(event.timestamp_millis - last_text_completion.timestamp_millis)
 
             last_cursor = event
     
@@ -98,9 +98,6 @@ resizeHandler();  // to handle initial page load
 // Global state
 ///////////////////////////////////////////////////////////////////////////////
 
-// shared containers
-let clickEvents = [];
-
 // variable state
 // should not be accessed directly, only by the proxy declared below
 let __state = {
@@ -124,8 +121,6 @@ const __stateHandler = {
             // if we have now done all fields
             if (value === totalFields) {
                 console.log("[Study Control] Task completed.");
-                sendEventsToServer(clickEvents, "click");
-                clickEvents = [];
                 const taskEvent = {
                     timestampMillis: completionTime,
                     taskIndex: -1,  // TODO: idk how i want to retrieve this value tbh
@@ -196,7 +191,6 @@ Array.from(userStudyTextFields).forEach(field => {
         keystrokeQueue: [],
         timestampQueue: [],
         inputCharQueue: [],
-        gatheredInputs: [],
         assembledString: "",
         notify() {
             console.log(this.keystrokeQueue);
@@ -232,12 +226,14 @@ Array.from(userStudyTextFields).forEach(field => {
             const equalSoFar = expectedString.startsWith(this.assembledString);
             const equality = expectedString === this.assembledString;
 
+            // sent right away: the logger only waits so long for late events
+            // before it writes everything in timestamp order
             if (keystroke != "Backspace") {
-                this.gatheredInputs.push({
+                sendEventsToServer([{
                     timestampMillis: timestamp,
                     wasCorrect: equalSoFar,
                     key: inputChar
-                });
+                }], "keystroke");
             }
 
             if (equalSoFar) {
@@ -262,7 +258,6 @@ Array.from(userStudyTextFields).forEach(field => {
                 field.removeEventListener("keydown", keydownListener);
                 field.removeEventListener("input", inputListener)
 
-                sendEventsToServer(this.gatheredInputs, "keystroke");
                 state.currentField++;
             }
         },
@@ -270,7 +265,6 @@ Array.from(userStudyTextFields).forEach(field => {
             this.keystrokeQueue = [];
             this.timestampQueue = [];
             this.inputCharQueue = [];
-            this.gatheredInputs = [];
             this.assembledString = "";
         }
     }
@@ -316,11 +310,11 @@ Array.from(userStudyTextFields).forEach(field => {
 // missed clicks will not be caught by the other handler and will bubble up to here
 document.addEventListener("click", e => {
     const timestampMillis = Date.now();
-    clickEvents.push({
+    sendEventsToServer([{
         timestampMillis: timestampMillis,
         location: "Background",
         wasCorrect: false
-    });
+    }], "click");
 
     console.log("[Clicks] Click missed.");
 });
@@ -345,7 +339,7 @@ Array.from(userStudyFields).forEach(field => {
             location: clickLocation,
             wasCorrect: wasCorrect
         };
-        clickEvents.push(newClick);
+        sendEventsToServer([newClick], "click");
         console.log("[Clicks] Click successful on fieldIndex=" + fieldIndex + " [" + (wasCorrect ? "correct field" : "incorrect field") + "]");
 
         e.stopPropagation();